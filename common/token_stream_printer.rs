@@ -3,7 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 use anyhow::{bail, Result};
-use proc_macro2::{Delimiter, TokenStream, TokenTree};
+use proc_macro2::{Delimiter, Spacing, TokenStream, TokenTree};
 use std::ffi::{OsStr, OsString};
 use std::io::Write as _;
 use std::path::{Path, PathBuf};
@@ -103,6 +103,18 @@ pub fn cc_tokens_to_formatted_string_for_tests(tokens: TokenStream) -> Result<St
     clang_format(tokens_to_string(tokens)?, Path::new(CLANG_FORMAT_EXE_PATH_FOR_TESTING))
 }
 
+/// Like `rs_tokens_to_formatted_string`, but formats the tokens with the
+/// built-in `PrettyPrinter` instead of running `rustfmt`.
+pub fn rs_tokens_to_pretty_string(tokens: TokenStream) -> Result<String> {
+    PrettyPrinter::new(Language::Rust).print(tokens)
+}
+
+/// Like `cc_tokens_to_formatted_string`, but formats the tokens with the
+/// built-in `PrettyPrinter` instead of running `clang-format`.
+pub fn cc_tokens_to_pretty_string(tokens: TokenStream) -> Result<String> {
+    PrettyPrinter::new(Language::Cc).print(tokens)
+}
+
 /// Produces source code out of the token stream.
 ///
 /// Notable features:
@@ -202,6 +214,543 @@ fn is_ident_or_literal(tt: &TokenTree) -> bool {
     }
 }
 
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+enum Language {
+    Rust,
+    Cc,
+}
+
+/// A token of the input of `PrettyPrinter`.
+///
+/// Punctuation characters are joined into multi-character operators, groups
+/// without delimiters are flattened, and the placeholders understood by
+/// `write_unformatted_tokens` get their own variants.
+#[derive(Debug)]
+enum Atom {
+    Ident(String),
+    Literal(String),
+    Op(String),
+    Group(Delimiter, TokenStream),
+    Newline,
+    Space,
+    Hash,
+    Comment(String),
+}
+
+/// Operators made of several punctuation characters.
+///
+/// `<<` and `>>` may also be two generic brackets (as in `Vec<Vec<u8>>`), which
+/// `PrettyPrinter::print_op` tells apart.
+const MULTI_CHAR_OPS: &[&str] = &[
+    "::", "->", "=>", "==", "!=", "<=", ">=", "&&", "||", "+=", "-=", "*=", "/=", "%=", "^=", "&=",
+    "|=", "<<", ">>", "<<=", ">>=", "..", "...", "..=",
+];
+
+fn atoms(tokens: TokenStream) -> Result<Vec<Atom>> {
+    let mut result = vec![];
+    let mut it = tokens.into_iter().peekable();
+    while let Some(tt) = it.next() {
+        match tt {
+            TokenTree::Ident(ref tt) if tt == "__NEWLINE__" => result.push(Atom::Newline),
+            TokenTree::Ident(ref tt) if tt == "__SPACE__" => result.push(Atom::Space),
+            TokenTree::Ident(ref tt) if tt == "__HASH_TOKEN__" => result.push(Atom::Hash),
+            TokenTree::Ident(ref tt) if tt == "__COMMENT__" => match it.next() {
+                Some(TokenTree::Literal(lit)) => result.push(Atom::Comment(
+                    string_literal_value(&lit.to_string())
+                        .unwrap_or_else(|| lit.to_string().trim_matches('"').to_string()),
+                )),
+                _ => bail!("__COMMENT__ must be followed by a literal"),
+            },
+            TokenTree::Ident(tt) => result.push(Atom::Ident(tt.to_string())),
+            TokenTree::Literal(tt) => result.push(Atom::Literal(tt.to_string())),
+            TokenTree::Group(tt) if tt.delimiter() == Delimiter::None => {
+                result.extend(atoms(tt.stream())?)
+            }
+            TokenTree::Group(tt) => result.push(Atom::Group(tt.delimiter(), tt.stream())),
+            TokenTree::Punct(tt) => {
+                let mut op = tt.as_char().to_string();
+                let mut spacing = tt.spacing();
+                while spacing == Spacing::Joint {
+                    let Some(TokenTree::Punct(next)) = it.peek() else { break };
+                    let joined = format!("{op}{}", next.as_char());
+                    if !MULTI_CHAR_OPS.contains(&joined.as_str()) {
+                        break;
+                    }
+                    op = joined;
+                    spacing = next.spacing();
+                    it.next();
+                }
+                result.push(Atom::Op(op));
+            }
+        }
+    }
+    Ok(result)
+}
+
+/// Returns the value of the string literal `lit`, or `None` if `lit` isn't a
+/// string literal.
+fn string_literal_value(lit: &str) -> Option<String> {
+    if let Some(raw) = lit.strip_prefix('r') {
+        let hashes = raw.len() - raw.trim_start_matches('#').len();
+        let raw = raw.get(hashes..raw.len().checked_sub(hashes)?)?;
+        return Some(raw.strip_prefix('"')?.strip_suffix('"')?.to_string());
+    }
+    let mut chars = lit.strip_prefix('"')?.strip_suffix('"')?.chars();
+    let mut result = String::new();
+    while let Some(c) = chars.next() {
+        if c != '\\' {
+            result.push(c);
+            continue;
+        }
+        match chars.next()? {
+            'n' => result.push('\n'),
+            'r' => result.push('\r'),
+            't' => result.push('\t'),
+            '0' => result.push('\0'),
+            c @ ('\\' | '\'' | '"') => result.push(c),
+            'x' => {
+                let hex: String = chars.by_ref().take(2).collect();
+                result.push(char::from(u8::from_str_radix(&hex, 16).ok()?));
+            }
+            'u' => {
+                let hex: String = chars.by_ref().skip(1).take_while(|c| *c != '}').collect();
+                result.push(char::from_u32(u32::from_str_radix(&hex, 16).ok()?)?);
+            }
+            _ => return None,
+        }
+    }
+    Some(result)
+}
+
+/// Returns the contents of a `#[doc = "..."]` attribute, given the tokens
+/// inside of its brackets.
+fn doc_attribute_value(tokens: &TokenStream) -> Option<String> {
+    match tokens.clone().into_iter().collect::<Vec<_>>().as_slice() {
+        [TokenTree::Ident(doc), TokenTree::Punct(eq), TokenTree::Literal(lit)]
+            if doc == "doc" && eq.as_char() == '=' =>
+        {
+            string_literal_value(&lit.to_string())
+        }
+        _ => None,
+    }
+}
+
+/// Keywords after which an operand starts, rather than e.g. a call.
+const KEYWORDS: &[&str] = &[
+    "as",
+    "box",
+    "break",
+    "case",
+    "co_await",
+    "co_return",
+    "co_yield",
+    "const",
+    "dyn",
+    "else",
+    "extern",
+    "for",
+    "if",
+    "impl",
+    "in",
+    "let",
+    "loop",
+    "match",
+    "move",
+    "mut",
+    "ref",
+    "return",
+    "static",
+    "switch",
+    "throw",
+    "unsafe",
+    "use",
+    "where",
+    "while",
+];
+
+/// How a token that was printed affects the spacing of the next one.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+enum Kind {
+    Ident,
+    Keyword,
+    Literal,
+    /// A prefix operator, e.g. `&` in `&self`. Never followed by a space.
+    Unary,
+    /// An infix operator, e.g. `=`. Surrounded by spaces.
+    Binary,
+    /// Never surrounded by spaces, e.g. `::` or `.`.
+    Tight,
+    /// Never preceded by a space, e.g. `,` or `;`.
+    Trailing,
+    /// `!` of a macro invocation.
+    MacroBang,
+    /// `'` of a lifetime.
+    Lifetime,
+    /// `#` of an attribute or a preprocessor directive.
+    Hash,
+    GenericOpen,
+    GenericClose,
+    /// `>` closing the generic parameters of an `impl`, which is followed by a
+    /// space even before `::`.
+    ImplGenericsClose,
+    Open(Delimiter),
+    Close(Delimiter),
+    /// A comment, which is always followed by the end of the line.
+    Line,
+}
+
+/// Formats `TokenStream`s into readable source code, without running external
+/// tools.
+///
+/// The output isn't as polished as what `rustfmt` or `clang-format` produce,
+/// but it is stable and quick to produce:
+/// * Items, statements, and the contents of braces each go on their own line,
+///   indented by nesting level. Long lines are not wrapped.
+/// * `#[doc = "..."]` attributes are printed as `///` comments.
+/// * Spaces between tokens are chosen based on the kinds of the tokens, e.g.
+///   none around `::` and around generic arguments.
+/// * The placeholders understood by `write_unformatted_tokens` are supported.
+///   `__NEWLINE__` on an empty line requests a blank line.
+struct PrettyPrinter {
+    language: Language,
+    out: String,
+    indent: usize,
+    /// The kind of the last token on the current line, or `None` at the start
+    /// of a line.
+    prev: Option<Kind>,
+    /// Whether the next token should be preceded by a space (`__SPACE__`).
+    force_space: bool,
+    /// Whether the next line should be preceded by a blank line.
+    blank_line: bool,
+    /// The unclosed `<` in the current group, and whether each of them opens
+    /// the generic parameters of an `impl`.
+    generics: Vec<bool>,
+    /// Whether the parameters of a Rust closure are being printed, so that the
+    /// next `|` closes them.
+    closure_params: bool,
+    /// Whether the next `{` opens the body of a C++ namespace, which isn't
+    /// indented.
+    in_namespace_header: bool,
+}
+
+impl PrettyPrinter {
+    fn new(language: Language) -> Self {
+        PrettyPrinter {
+            language,
+            out: String::new(),
+            indent: 0,
+            prev: None,
+            force_space: false,
+            blank_line: false,
+            generics: vec![],
+            closure_params: false,
+            in_namespace_header: false,
+        }
+    }
+
+    fn print(mut self, tokens: TokenStream) -> Result<String> {
+        self.print_atoms(&atoms(tokens)?, None)?;
+        self.end_line();
+        Ok(self.out)
+    }
+
+    /// Prints `atoms`, which are either at the top level (`delimiter` is
+    /// `None`) or inside of a group.
+    fn print_atoms(&mut self, atoms: &[Atom], delimiter: Option<Delimiter>) -> Result<()> {
+        let in_block = matches!(delimiter, None | Some(Delimiter::Brace));
+        let mut i = 0;
+        while i < atoms.len() {
+            match &atoms[i] {
+                Atom::Newline => {
+                    if self.prev.is_some() {
+                        self.end_line();
+                    } else {
+                        self.blank_line = true;
+                    }
+                }
+                Atom::Space => self.force_space = self.prev.is_some(),
+                Atom::Hash => {
+                    if self.language == Language::Cc {
+                        self.end_line();
+                    }
+                    self.write("#", Kind::Hash);
+                }
+                Atom::Comment(comment) => {
+                    for line in comment.split('\n') {
+                        self.write(&format!("// {line}"), Kind::Line);
+                        self.end_line();
+                    }
+                }
+                Atom::Op(op) if op == "#" && self.language == Language::Rust => {
+                    let inner = matches!(atoms.get(i + 1), Some(Atom::Op(op)) if op == "!");
+                    let group = i + 1 + usize::from(inner);
+                    if let Some(Atom::Group(Delimiter::Bracket, tokens)) = atoms.get(group) {
+                        if in_block {
+                            self.end_line();
+                        }
+                        match doc_attribute_value(tokens) {
+                            Some(doc) if in_block => {
+                                let prefix = if inner { "//!" } else { "///" };
+                                for line in doc.split('\n') {
+                                    self.write(&format!("{prefix}{line}"), Kind::Line);
+                                    self.end_line();
+                                }
+                            }
+                            _ => {
+                                self.write("#", Kind::Hash);
+                                if inner {
+                                    self.write("!", Kind::Tight);
+                                }
+                                self.print_group(Delimiter::Bracket, tokens)?;
+                                if in_block {
+                                    self.end_line();
+                                }
+                            }
+                        }
+                        i = group + 1;
+                        continue;
+                    }
+                    self.write("#", Kind::Hash);
+                }
+                Atom::Op(op) => {
+                    self.print_op(op);
+                    match op.as_str() {
+                        ";" if in_block => self.end_line(),
+                        "," if delimiter == Some(Delimiter::Brace) => self.end_line(),
+                        _ => (),
+                    }
+                }
+                Atom::Ident(ident) => {
+                    // The name of a lifetime is spaced like a keyword: `&'a [T]`.
+                    let kind = if KEYWORDS.contains(&ident.as_str())
+                        || self.prev == Some(Kind::Lifetime)
+                    {
+                        Kind::Keyword
+                    } else {
+                        Kind::Ident
+                    };
+                    self.write(ident, kind);
+                    if self.language == Language::Cc && ident == "namespace" {
+                        self.in_namespace_header = true;
+                    }
+                }
+                Atom::Literal(lit) => self.write(lit, Kind::Literal),
+                Atom::Group(delimiter, tokens) => {
+                    self.print_group(*delimiter, tokens)?;
+                    if in_block
+                        && *delimiter == Delimiter::Brace
+                        && !continues_line(atoms.get(i + 1))
+                    {
+                        self.end_line();
+                    }
+                }
+            }
+            match &atoms[i] {
+                Atom::Ident(_) | Atom::Newline | Atom::Space => (),
+                Atom::Op(op) if op == "::" => (),
+                _ => self.in_namespace_header = false,
+            }
+            i += 1;
+        }
+        Ok(())
+    }
+
+    fn print_group(&mut self, delimiter: Delimiter, tokens: &TokenStream) -> Result<()> {
+        let atoms = atoms(tokens.clone())?;
+        let generics = std::mem::take(&mut self.generics);
+        let closure_params = std::mem::take(&mut self.closure_params);
+        let (open, close) = match delimiter {
+            Delimiter::Parenthesis => ("(", ")"),
+            Delimiter::Bracket => ("[", "]"),
+            Delimiter::Brace => ("{", "}"),
+            Delimiter::None => ("", ""),
+        };
+        self.write(open, Kind::Open(delimiter));
+        if delimiter != Delimiter::Brace {
+            self.print_atoms(&atoms, Some(delimiter))?;
+            self.write(close, Kind::Close(delimiter));
+        } else if atoms.iter().all(|atom| matches!(atom, Atom::Newline | Atom::Space)) {
+            self.out.push_str(close);
+            self.prev = Some(Kind::Close(delimiter));
+        } else {
+            let indent = usize::from(!std::mem::take(&mut self.in_namespace_header));
+            self.end_line();
+            self.indent += indent;
+            self.print_atoms(&atoms, Some(delimiter))?;
+            self.end_line();
+            self.indent -= indent;
+            self.blank_line = false;
+            self.write(close, Kind::Close(delimiter));
+        }
+        self.generics = generics;
+        self.closure_params = closure_params;
+        Ok(())
+    }
+
+    /// Prints `op`, which is split into generic brackets if it opens or closes
+    /// several generic argument lists: `>>` closes them if at least two are
+    /// open (otherwise it is a shift), and `<<` opens them unless it follows an
+    /// operand, as in `<<T as Trait>::Assoc as Other>::Assoc`.
+    fn print_op(&mut self, op: &str) {
+        let parts: &[&str] = match op {
+            ">>" if self.generics.len() >= 2 => &[">", ">"],
+            ">>=" if self.generics.len() >= 2 => &[">", ">", "="],
+            "<<" if !self.after_operand() => &["<", "<"],
+            _ => &[op],
+        };
+        for part in parts {
+            let kind = self.op_kind(part);
+            self.write(part, kind);
+        }
+    }
+
+    /// Returns whether the previous token ends an operand, so that the next
+    /// operator is an infix one.
+    fn after_operand(&self) -> bool {
+        matches!(
+            self.prev,
+            Some(
+                Kind::Ident
+                    | Kind::Literal
+                    | Kind::GenericClose
+                    | Kind::Close(Delimiter::Parenthesis | Delimiter::Bracket)
+            )
+        )
+    }
+
+    fn op_kind(&mut self, op: &str) -> Kind {
+        match op {
+            "," | ";" | ":" | "?" => Kind::Trailing,
+            "::" | "." | ".." | "..=" | "..." => Kind::Tight,
+            "->" if self.language == Language::Cc => Kind::Tight,
+            "'" => Kind::Lifetime,
+            "|" if self.closure_params => {
+                self.closure_params = false;
+                Kind::Trailing
+            }
+            "|" if self.language == Language::Rust && !self.after_operand() => {
+                self.closure_params = true;
+                Kind::Unary
+            }
+            "!" if self.prev == Some(Kind::Ident) => Kind::MacroBang,
+            "<" if !matches!(
+                self.prev,
+                Some(Kind::Literal | Kind::Close(Delimiter::Parenthesis | Delimiter::Bracket))
+            ) =>
+            {
+                self.generics.push(self.prev == Some(Kind::Keyword) && self.out.ends_with("impl"));
+                Kind::GenericOpen
+            }
+            ">" if !self.generics.is_empty() => {
+                if self.generics.pop() == Some(true) {
+                    Kind::ImplGenericsClose
+                } else {
+                    Kind::GenericClose
+                }
+            }
+            // In C++, `T* p` and `T& r` are much more common in generated code than
+            // multiplication or bitwise and.
+            "*" | "&" | "&&" if self.language == Language::Cc && self.after_operand() => {
+                Kind::Trailing
+            }
+            "&" | "&&" | "*" | "-" | "!" | "~" if !self.after_operand() => Kind::Unary,
+            _ => Kind::Binary,
+        }
+    }
+
+    /// Returns whether a token of kind `next` should be separated by a space
+    /// from the previous token on the same line.
+    fn space_before(&self, next: Kind, text: &str) -> bool {
+        let Some(prev) = self.prev else { return false };
+        if self.force_space {
+            return true;
+        }
+        match (prev, next) {
+            (Kind::Trailing, Kind::Trailing) if self.language == Language::Cc => {
+                // `T**` or `T*&`.
+                false
+            }
+            (Kind::Ident, Kind::GenericOpen) if self.language == Language::Cc => {
+                // `#include <...>`.
+                self.out.ends_with("#include")
+            }
+            (
+                Kind::Binary | Kind::Keyword | Kind::Trailing | Kind::ImplGenericsClose,
+                Kind::Tight,
+            ) => {
+                matches!(text, "::" | ".." | "..=")
+            }
+            (Kind::Trailing | Kind::Binary, Kind::GenericOpen) => {
+                // A qualified path: `x: <T as Trait>::Assoc`.
+                true
+            }
+            (
+                _,
+                Kind::Trailing
+                | Kind::Tight
+                | Kind::MacroBang
+                | Kind::GenericOpen
+                | Kind::GenericClose
+                | Kind::ImplGenericsClose,
+            ) => false,
+            (_, Kind::Close(Delimiter::Parenthesis | Delimiter::Bracket)) => false,
+            (
+                Kind::Tight
+                | Kind::Unary
+                | Kind::GenericOpen
+                | Kind::Lifetime
+                | Kind::Hash
+                | Kind::Open(Delimiter::Parenthesis | Delimiter::Bracket),
+                _,
+            ) => false,
+            (Kind::MacroBang, Kind::Open(Delimiter::Parenthesis | Delimiter::Bracket)) => false,
+            (
+                Kind::Ident
+                | Kind::GenericClose
+                | Kind::Close(Delimiter::Parenthesis | Delimiter::Bracket),
+                Kind::Open(Delimiter::Parenthesis | Delimiter::Bracket),
+            ) => false,
+            _ => true,
+        }
+    }
+
+    fn write(&mut self, text: &str, kind: Kind) {
+        if self.prev.is_none() {
+            if self.blank_line && !self.out.is_empty() && !self.out.ends_with("{\n") {
+                self.out.push('\n');
+            }
+            self.blank_line = false;
+            let indent = match self.language {
+                Language::Rust => "    ",
+                Language::Cc => "  ",
+            };
+            self.out.push_str(&indent.repeat(self.indent));
+        } else if self.space_before(kind, text) {
+            self.out.push(' ');
+        }
+        self.force_space = false;
+        self.out.push_str(text);
+        self.prev = Some(kind);
+    }
+
+    fn end_line(&mut self) {
+        if self.prev.take().is_some() {
+            self.out.push('\n');
+        }
+        self.force_space = false;
+    }
+}
+
+/// Returns whether `next` continues the line of a closing brace, as in `};` or
+/// `} else {`.
+fn continues_line(next: Option<&Atom>) -> bool {
+    match next {
+        Some(Atom::Op(op)) => matches!(op.as_str(), "," | ";" | "." | "?"),
+        Some(Atom::Ident(ident)) => ident == "else" || ident == "as",
+        _ => false,
+    }
+}
+
 fn pipe_string_through_process<'a>(
     input: String,
     exe_name: &str,
@@ -384,6 +933,147 @@ mod tests {
         Ok(())
     }
 
+    #[test]
+    fn test_rs_tokens_to_pretty_string() -> Result<()> {
+        let input = quote! {
+            #[doc = " Doc comment\n second line"]
+            #[derive(Clone, Copy)]
+            #[repr(C)]
+            pub struct S<'a> {
+                pub x: &'a [u8; 4],
+                pub y: *mut ::std::ffi::c_void,
+            }
+            __NEWLINE__ __NEWLINE__ __NEWLINE__
+            impl<'a> From<&'a S<'a>> for Option<Vec<i32>> {
+                fn from(s: &'a S<'a>) -> Self {
+                    let v = unsafe { crate::detail::f(&mut *s.y, -1) };
+                    const _: () = assert!(::std::mem::size_of::<S>() == 16);
+                    Some(v.iter().map(|x| x + 1).collect())
+                }
+            }
+        };
+        assert_eq!(
+            rs_tokens_to_pretty_string(input)?,
+            r#"/// Doc comment
+/// second line
+#[derive(Clone, Copy)]
+#[repr(C)]
+pub struct S<'a> {
+    pub x: &'a [u8; 4],
+    pub y: *mut ::std::ffi::c_void,
+}
+
+impl<'a> From<&'a S<'a>> for Option<Vec<i32>> {
+    fn from(s: &'a S<'a>) -> Self {
+        let v = unsafe {
+            crate::detail::f(&mut *s.y, -1)
+        };
+        const _: () = assert!(::std::mem::size_of::<S>() == 16);
+        Some(v.iter().map(|x| x + 1).collect())
+    }
+}
+"#
+        );
+        Ok(())
+    }
+
+    #[test]
+    fn test_rs_tokens_to_pretty_string_blocks() -> Result<()> {
+        let input = quote! {
+            #![rustfmt::skip]
+            impl Drop for S { fn drop(&mut self) {} }
+            __COMMENT__ "comment"
+            fn f(x: i32) -> S {
+                if x == 0 { S { a: 1, ..Default::default() } } else { g(move || { x }) }
+            }
+        };
+        assert_eq!(
+            rs_tokens_to_pretty_string(input)?,
+            r#"#![rustfmt::skip]
+impl Drop for S {
+    fn drop(&mut self) {}
+}
+// comment
+fn f(x: i32) -> S {
+    if x == 0 {
+        S {
+            a: 1,
+            ..Default::default()
+        }
+    } else {
+        g(move || {
+            x
+        })
+    }
+}
+"#
+        );
+        Ok(())
+    }
+
+    #[test]
+    fn test_rs_tokens_to_pretty_string_shifts_and_generics() -> Result<()> {
+        let input = quote! {
+            fn f(x: Vec<Vec<u8>>, y: u64) -> Option<Box<Vec<i64>>> {
+                let mut z = (y << 62) as i64 >> 62;
+                z <<= x.len();
+                z >>= 1;
+                let v: Vec<Vec<i64>>= vec![vec![z]];
+                let _: <<Vec<u8> as IntoIterator>::IntoIter as Iterator>::Item = 0;
+                Some(Box::new(v.into_iter().flatten().collect::<Vec<i64>>()))
+            }
+        };
+        let output = rs_tokens_to_pretty_string(input.clone())?;
+        assert_eq!(
+            output,
+            r#"fn f(x: Vec<Vec<u8>>, y: u64) -> Option<Box<Vec<i64>>> {
+    let mut z = (y << 62) as i64 >> 62;
+    z <<= x.len();
+    z >>= 1;
+    let v: Vec<Vec<i64>> = vec![vec![z]];
+    let _: <<Vec<u8> as IntoIterator>::IntoIter as Iterator>::Item = 0;
+    Some(Box::new(v.into_iter().flatten().collect::<Vec<i64>>()))
+}
+"#
+        );
+        // The output is valid Rust, and parses into the same syntax tree as the
+        // input.
+        let output_file = syn::parse_file(&output)?;
+        let input_file: syn::File = syn::parse2(input)?;
+        assert_eq!(quote! { #output_file }.to_string(), quote! { #input_file }.to_string());
+        Ok(())
+    }
+
+    #[test]
+    fn test_cc_tokens_to_pretty_string() -> Result<()> {
+        let input = quote! {
+            __HASH_TOKEN__ include <memory> __NEWLINE__
+            __HASH_TOKEN__ include "a/b.h" __NEWLINE__ __NEWLINE__
+            namespace ns {
+            extern "C" void __rust_thunk(struct S* __this, const S& other, S&& s) {
+                crubit::construct_at(std::forward<S*>(__this), *other);
+                __this->~S();
+            }
+            }
+            static_assert(sizeof(struct S) == 4);
+        };
+        assert_eq!(
+            cc_tokens_to_pretty_string(input)?,
+            r#"#include <memory>
+#include "a/b.h"
+
+namespace ns {
+extern "C" void __rust_thunk(struct S* __this, const S& other, S&& s) {
+  crubit::construct_at(std::forward<S*>(__this), *other);
+  __this->~S();
+}
+}
+static_assert(sizeof(struct S) == 4);
+"#
+        );
+        Ok(())
+    }
+
     #[test]
     fn test_rs_tokens_to_formatted_string_for_tests() {
         let input = quote! {
@@ -6,7 +6,11 @@
 
 #include "absl/log/check.h"
 #include "rs_bindings_from_cc/importer.h"
+#include "rs_bindings_from_cc/stats.h"
 #include "clang/AST/ASTContext.h"
+#include "clang/AST/DeclBase.h"
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/SourceManager.h"
 #include "clang/Frontend/CompilerInstance.h"
 
 namespace crubit {
@@ -20,8 +24,22 @@ void AstConsumer::HandleTranslationUnit(clang::ASTContext& ast_context) {
     return;
   }
   CHECK(instance_.hasSema());
+  Stats::Phase phase(invocation_.stats_, "Importer::Import");
   Importer importer(invocation_, ast_context, instance_.getSema());
   importer.Import(ast_context.getTranslationUnitDecl());
 }
 
+bool AstConsumer::shouldSkipFunctionBody(clang::Decl* decl) {
+  const clang::SourceManager& source_manager = instance_.getSourceManager();
+  clang::SourceLocation location = decl->getLocation();
+  clang::FileID file_id =
+      source_manager.getFileID(source_manager.getExpansionLoc(location));
+  auto [it, inserted] = skip_function_bodies_in_file_.try_emplace(file_id);
+  if (inserted) {
+    it->second = GetOwningTargetOfLocation(invocation_, source_manager,
+                                           location) != invocation_.target_;
+  }
+  return it->second;
+}
+
 }  // namespace crubit
@@ -8,7 +8,10 @@
 #include "rs_bindings_from_cc/decl_importer.h"
 #include "clang/AST/ASTConsumer.h"
 #include "clang/AST/ASTContext.h"
+#include "clang/AST/DeclBase.h"
+#include "clang/Basic/SourceLocation.h"
 #include "clang/Frontend/CompilerInstance.h"
+#include "llvm/ADT/DenseMap.h"
 
 namespace crubit {
 
@@ -22,9 +25,18 @@ class AstConsumer : public clang::ASTConsumer {
 
   void HandleTranslationUnit(clang::ASTContext& context) override;
 
+  // Skips the bodies of functions that aren't from the current target, when
+  // `Invocation::skip_dependency_function_bodies_` is set. The importer only
+  // looks at the bodies of the functions it imports (for example to find
+  // trivial field accessors).
+  bool shouldSkipFunctionBody(clang::Decl* decl) override;
+
  private:
   clang::CompilerInstance& instance_;
   Invocation& invocation_;
+  // Whether to skip the function bodies in each file, which only depends on
+  // the target that owns the file.
+  llvm::DenseMap<clang::FileID, bool> skip_function_bodies_in_file_;
 };  // class AstConsumer
 
 }  // namespace crubit
@@ -4,8 +4,15 @@
 
 #include "rs_bindings_from_cc/ast_util.h"
 
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "clang/AST/Attr.h"
+#include "clang/AST/DeclBase.h"
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/DeclTemplate.h"
+#include "llvm/ADT/StringRef.h"
 
 namespace crubit {
 
@@ -25,4 +32,20 @@ bool IsFullClassTemplateSpecializationOrChild(const clang::Decl* decl) {
   return false;
 }
 
+absl::StatusOr<const clang::AnnotateAttr*> GetAnnotateAttr(
+    const clang::Decl* decl, absl::string_view attribute) {
+  const clang::AnnotateAttr* found_attr = nullptr;
+  for (clang::AnnotateAttr* attr :
+       decl->specific_attrs<clang::AnnotateAttr>()) {
+    if (attr->getAnnotation() != llvm::StringRef(attribute)) continue;
+
+    if (found_attr != nullptr)
+      return absl::InvalidArgumentError(
+          absl::StrCat("Only one `", attribute,
+                       "` attribute may be placed on a declaration."));
+    found_attr = attr;
+  }
+  return found_attr;
+}
+
 }  // namespace crubit
@@ -5,6 +5,10 @@
 #ifndef CRUBIT_RS_BINDINGS_FROM_CC_AST_UTIL_H_
 #define CRUBIT_RS_BINDINGS_FROM_CC_AST_UTIL_H_
 
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "clang/AST/Attr.h"
+#include "clang/AST/DeclBase.h"
 #include "clang/AST/DeclCXX.h"
 
 namespace crubit {
@@ -14,6 +18,12 @@ namespace crubit {
 // function decl) nested inside a ClassTemplateSpecializationDecl.
 bool IsFullClassTemplateSpecializationOrChild(const clang::Decl* decl);
 
+// Returns the `annotate` attribute of `decl` whose annotation is `attribute`,
+// or null if there is none. It is an error for there to be more than one.
+// `decl` must not be null.
+absl::StatusOr<const clang::AnnotateAttr*> GetAnnotateAttr(
+    const clang::Decl* decl, absl::string_view attribute);
+
 }  // namespace crubit
 
 #endif  // CRUBIT_RS_BINDINGS_FROM_CC_AST_UTIL_H_
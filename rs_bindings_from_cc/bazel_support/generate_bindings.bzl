@@ -28,7 +28,9 @@ def generate_bindings(
         action_inputs,
         target_args,
         extra_rs_srcs,
-        extra_rs_bindings_from_cc_cli_flags):
+        extra_rs_bindings_from_cc_cli_flags,
+        precompiled_header = None,
+        precompiled_header_out = None):
     """Runs the bindings generator.
 
     Args:
@@ -44,6 +46,8 @@ def generate_bindings(
                         its per-target arguments (headers, features) in json format.
       extra_rs_srcs: A list of extra source files to add.
       extra_rs_bindings_from_cc_cli_flags: CLI flags to be passed to `rs_bindings_from_cc`.
+      precompiled_header: A precompiled header to be passed via "--precompiled_header", or None.
+      precompiled_header_out: An output file to be passed via "--precompiled_header_out", or None.
 
     Returns:
       tuple(cc_output, rs_output, namespaces_output, error_report_output): The generated source files.
@@ -77,6 +81,18 @@ def generate_bindings(
             "--error_report_out",
             error_report_output.path,
         ]
+    if ctx.attr._use_external_formatters[BuildSettingInfo].value:
+        rs_bindings_from_cc_flags.append("--use_external_formatters")
+    if precompiled_header:
+        rs_bindings_from_cc_flags += [
+            "--precompiled_header",
+            precompiled_header.path,
+        ]
+    if precompiled_header_out:
+        rs_bindings_from_cc_flags += [
+            "--precompiled_header_out",
+            precompiled_header_out.path,
+        ]
 
     variables = cc_common.create_compile_variables(
         feature_configuration = feature_configuration,
@@ -122,10 +138,12 @@ def generate_bindings(
                 ctx.executable._clang_format,
                 ctx.executable._rustfmt,
                 ctx.executable._generator,
-            ] + ctx.files._rustfmt_cfg + extra_rs_srcs,
+            ] + ctx.files._rustfmt_cfg + extra_rs_srcs + (
+                [precompiled_header] if precompiled_header else []
+            ),
             transitive = [action_inputs],
         ),
-        additional_outputs = [x for x in [rs_output, namespaces_output, error_report_output] if x != None],
+        additional_outputs = [x for x in [rs_output, namespaces_output, error_report_output, precompiled_header_out] if x != None],
         variables = variables,
     )
     return (cc_output, rs_output, namespaces_output, error_report_output)
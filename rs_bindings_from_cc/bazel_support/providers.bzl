@@ -22,7 +22,11 @@ RustBindingsFromCcInfo = provider(
 
 RustToolchainHeadersInfo = provider(
     doc = "A provider that contains all toolchain C++ headers",
-    fields = {"headers": "depset"},
+    fields = {
+        "headers": "depset",
+        "precompiled_header": ("A precompiled header containing the public toolchain headers, " +
+                               "or None."),
+    },
 )
 
 GeneratedBindingsInfo = provider(
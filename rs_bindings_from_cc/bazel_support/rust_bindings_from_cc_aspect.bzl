@@ -208,6 +208,8 @@ def _rust_bindings_from_cc_aspect_impl(target, ctx):
         ] + ctx.attr._deps_for_bindings[DepsForBindingsInfo].deps_for_rs_file,
         extra_cc_compilation_action_inputs = extra_cc_compilation_action_inputs,
         extra_rs_bindings_from_cc_cli_flags = collect_rust_bindings_from_cc_cli_flags(target, ctx),
+        # Only set if `use_precompiled_toolchain_headers` is enabled.
+        precompiled_header = ctx.attr._std[RustToolchainHeadersInfo].precompiled_header,
     )
 
 rust_bindings_from_cc_aspect = aspect(
@@ -30,7 +30,9 @@ def generate_and_compile_bindings(
         deps_for_cc_file,
         deps_for_rs_file,
         extra_cc_compilation_action_inputs = [],
-        extra_rs_bindings_from_cc_cli_flags = []):
+        extra_rs_bindings_from_cc_cli_flags = [],
+        precompiled_header = None,
+        precompiled_header_out = None):
     """Runs the bindings generator.
 
     Args:
@@ -48,6 +50,9 @@ def generate_and_compile_bindings(
       extra_cc_compilation_action_inputs: A list of input files for the C++ compilation action.
       extra_rs_bindings_from_cc_cli_flags: CLI flags to pass to `rs_bindings_from_cc`, in addition
                                            to the flags that are passed by the build rule.
+      precompiled_header: File: A precompiled header to load instead of parsing the headers it
+                          contains, or None.
+      precompiled_header_out: File: Where to write a precompiled header of `public_hdrs`, or None.
     Returns:
       A RustBindingsFromCcInfo containing the result of the compilation of the generated source
       files, as well a GeneratedBindingsInfo provider containing the generated source files.
@@ -73,6 +78,8 @@ def generate_and_compile_bindings(
         target_args = target_args,
         extra_rs_srcs = extra_rs_srcs,
         extra_rs_bindings_from_cc_cli_flags = extra_rs_bindings_from_cc_cli_flags,
+        precompiled_header = precompiled_header,
+        precompiled_header_out = precompiled_header_out,
     )
 
     # Relocate the rs files so that they can be read by rustc using relative paths.
@@ -173,4 +180,10 @@ bindings_attrs = {
     "_generate_error_report": attr.label(
         default = "//rs_bindings_from_cc/bazel_support:generate_error_report",
     ),
+    "_use_precompiled_toolchain_headers": attr.label(
+        default = "//rs_bindings_from_cc/bazel_support:use_precompiled_toolchain_headers",
+    ),
+    "_use_external_formatters": attr.label(
+        default = "//rs_bindings_from_cc/bazel_support:use_external_formatters",
+    ),
 }
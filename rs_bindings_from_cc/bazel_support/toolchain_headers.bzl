@@ -8,6 +8,7 @@ Disclaimer: This project is experimental, under heavy development, and should
 not be used yet.
 """
 
+load("@bazel_skylib//rules:common_settings.bzl", "BuildSettingInfo")
 load(
     "//rs_bindings_from_cc/bazel_support:providers.bzl",
     "DepsForBindingsInfo",
@@ -70,7 +71,14 @@ def _bindings_for_toolchain_headers_impl(ctx):
         header_includes.append("-include")
         header_includes.append(hdr)
 
-    return [RustToolchainHeadersInfo(headers = std_and_builtin_files)] + generate_and_compile_bindings(
+    precompiled_header = None
+    if ctx.attr._use_precompiled_toolchain_headers[BuildSettingInfo].value:
+        precompiled_header = ctx.actions.declare_file(ctx.label.name + "_toolchain_headers.pch")
+
+    return [RustToolchainHeadersInfo(
+        headers = std_and_builtin_files,
+        precompiled_header = precompiled_header,
+    )] + generate_and_compile_bindings(
         ctx,
         ctx.attr,
         compilation_context = ctx.attr._stl[CcInfo].compilation_context,
@@ -81,6 +89,7 @@ def _bindings_for_toolchain_headers_impl(ctx):
         extra_rs_srcs = ctx.files.extra_rs_srcs,
         deps_for_cc_file = ctx.attr._deps_for_bindings[DepsForBindingsInfo].deps_for_cc_file,
         deps_for_rs_file = ctx.attr._deps_for_bindings[DepsForBindingsInfo].deps_for_rs_file,
+        precompiled_header_out = precompiled_header,
     )
 
 bindings_for_toolchain_headers = rule(
@@ -0,0 +1,140 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/cached_file_system.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "llvm/ADT/IntrusiveRefCntPtr.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/VirtualFileSystem.h"
+
+namespace crubit {
+
+namespace {
+
+// A file whose contents are owned by the `CachedFileSystem`.
+class CachedFile : public llvm::vfs::File {
+ public:
+  CachedFile(llvm::vfs::Status status,
+             std::shared_ptr<const llvm::MemoryBuffer> contents)
+      : status_(std::move(status)), contents_(std::move(contents)) {}
+
+  llvm::ErrorOr<llvm::vfs::Status> status() override { return status_; }
+
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> getBuffer(
+      const llvm::Twine& name, int64_t file_size, bool requires_null_terminator,
+      bool is_volatile) override {
+    // The cached buffer is always null-terminated (see `openFileForRead`), so
+    // it can be handed out regardless of `requires_null_terminator`.
+    return llvm::MemoryBuffer::getMemBuffer(contents_->getBuffer(),
+                                            name.str(),
+                                            requires_null_terminator);
+  }
+
+  std::error_code close() override { return {}; }
+
+ private:
+  llvm::vfs::Status status_;
+  std::shared_ptr<const llvm::MemoryBuffer> contents_;
+};
+
+}  // namespace
+
+CachedFileSystem::CachedFileSystem(
+    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> underlying_fs)
+    : llvm::vfs::ProxyFileSystem(std::move(underlying_fs)) {
+  if (llvm::ErrorOr<std::string> cwd =
+          getUnderlyingFS().getCurrentWorkingDirectory()) {
+    working_directory_ = std::move(*cwd);
+  }
+}
+
+std::optional<std::string> CachedFileSystem::CacheDigest(
+    absl::string_view path) const {
+  if (auto it = input_digests_.find(path); it != input_digests_.end()) {
+    // Without a digest, there is no telling whether the input changed.
+    if (it->second.empty()) return std::nullopt;
+    return it->second;
+  }
+  if (!llvm::sys::path::is_absolute(llvm::StringRef(path.data(), path.size())))
+    return std::nullopt;
+  if (!working_directory_.empty() &&
+      absl::StartsWith(path, absl::StrCat(working_directory_, "/"))) {
+    return std::nullopt;
+  }
+  return "";
+}
+
+CachedFileSystem::Entry* CachedFileSystem::FindEntry(
+    const std::string& path, absl::string_view digest) {
+  auto it = entries_.find(path);
+  if (it == entries_.end()) return nullptr;
+  if (it->second.digest != digest) {
+    entries_.erase(it);
+    return nullptr;
+  }
+  return &it->second;
+}
+
+llvm::ErrorOr<llvm::vfs::Status> CachedFileSystem::status(
+    const llvm::Twine& path) {
+  std::string path_str = path.str();
+  std::optional<std::string> digest = CacheDigest(path_str);
+  if (!digest.has_value()) return getUnderlyingFS().status(path);
+
+  if (Entry* entry = FindEntry(path_str, *digest)) {
+    ++hits_;
+    return entry->status;
+  }
+  llvm::ErrorOr<llvm::vfs::Status> result = getUnderlyingFS().status(path);
+  if (result) {
+    entries_.insert_or_assign(
+        path_str, Entry{.digest = *std::move(digest), .status = *result});
+  }
+  return result;
+}
+
+llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>>
+CachedFileSystem::openFileForRead(const llvm::Twine& path) {
+  std::string path_str = path.str();
+  std::optional<std::string> digest = CacheDigest(path_str);
+  if (!digest.has_value()) return getUnderlyingFS().openFileForRead(path);
+
+  Entry* entry = FindEntry(path_str, *digest);
+  if (entry != nullptr && entry->contents != nullptr) {
+    ++hits_;
+    return std::make_unique<CachedFile>(entry->status, entry->contents);
+  }
+
+  llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> file =
+      getUnderlyingFS().openFileForRead(path);
+  if (!file) return file;
+  llvm::ErrorOr<llvm::vfs::Status> file_status = (*file)->status();
+  if (!file_status) return file_status.getError();
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer =
+      (*file)->getBuffer(path_str, file_status->getSize(),
+                         /*RequiresNullTerminator=*/true,
+                         /*IsVolatile=*/false);
+  if (!buffer) return buffer.getError();
+
+  std::shared_ptr<const llvm::MemoryBuffer> contents(std::move(*buffer));
+  entries_.insert_or_assign(path_str, Entry{.digest = *std::move(digest),
+                                            .status = *file_status,
+                                            .contents = contents});
+  return std::make_unique<CachedFile>(std::move(*file_status),
+                                      std::move(contents));
+}
+
+}  // namespace crubit
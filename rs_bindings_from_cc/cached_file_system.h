@@ -0,0 +1,83 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CRUBIT_RS_BINDINGS_FROM_CC_CACHED_FILE_SYSTEM_H_
+#define CRUBIT_RS_BINDINGS_FROM_CC_CACHED_FILE_SYSTEM_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "llvm/ADT/IntrusiveRefCntPtr.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/VirtualFileSystem.h"
+
+namespace crubit {
+
+// A file system that remembers `status` results and file contents across
+// several bindings generator invocations in the same process (see
+// `persistent_worker.h`), so that headers shared by many targets (the
+// toolchain headers, `crubit/support`, absl, ...) are only stat-ed and read
+// once per worker.
+//
+// A file is only served from the cache if it can't have changed since it was
+// cached:
+// * files listed in the inputs of the current request are keyed by the digest
+//   the build system computed for them, so an edited file is a cache miss.
+//   Inputs that come without a digest are never cached;
+// * files that are not inputs of the request are only cached when addressed by
+//   an absolute path outside of the working directory (the execroot). Those
+//   are toolchain and system headers, which don't change while the worker is
+//   alive.
+// Everything else - including failed lookups, which are common during
+// include path search - goes straight to the underlying file system.
+class CachedFileSystem : public llvm::vfs::ProxyFileSystem {
+ public:
+  explicit CachedFileSystem(
+      llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> underlying_fs);
+
+  // Sets the digests of the inputs of the request that is about to be served.
+  // Paths are relative to the working directory, as given by the build system.
+  void SetInputDigests(
+      absl::flat_hash_map<std::string, std::string> input_digests) {
+    input_digests_ = std::move(input_digests);
+  }
+
+  llvm::ErrorOr<llvm::vfs::Status> status(const llvm::Twine& path) override;
+  llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> openFileForRead(
+      const llvm::Twine& path) override;
+
+  // Number of `status` and `openFileForRead` calls answered from the cache.
+  int64_t hits() const { return hits_; }
+
+ private:
+  struct Entry {
+    std::string digest;
+    llvm::vfs::Status status;
+    // Null until the file has been opened for reading.
+    std::shared_ptr<const llvm::MemoryBuffer> contents;
+  };
+
+  // Returns the digest under which `path` may be cached, or `std::nullopt` if
+  // it must not be cached. Files that never change get an empty digest.
+  std::optional<std::string> CacheDigest(absl::string_view path) const;
+
+  // Returns the cache entry for `path` if it is still valid for `digest`.
+  Entry* FindEntry(const std::string& path, absl::string_view digest);
+
+  std::string working_directory_;
+  absl::flat_hash_map<std::string, std::string> input_digests_;
+  absl::flat_hash_map<std::string, Entry> entries_;
+  int64_t hits_ = 0;
+};
+
+}  // namespace crubit
+
+#endif  // CRUBIT_RS_BINDINGS_FROM_CC_CACHED_FILE_SYSTEM_H_
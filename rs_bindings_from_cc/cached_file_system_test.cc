@@ -0,0 +1,97 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/cached_file_system.h"
+
+#include <memory>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "llvm/ADT/IntrusiveRefCntPtr.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/VirtualFileSystem.h"
+
+namespace crubit {
+namespace {
+
+// Returns the contents of `path` in `fs`, or "<error>" if it can't be read.
+std::string ReadFile(llvm::vfs::FileSystem& fs, llvm::StringRef path) {
+  auto buffer = fs.getBufferForFile(path);
+  if (!buffer) return "<error>";
+  return (*buffer)->getBuffer().str();
+}
+
+class CachedFileSystemTest : public testing::Test {
+ protected:
+  CachedFileSystemTest()
+      : underlying_fs_(llvm::makeIntrusiveRefCnt<llvm::vfs::OverlayFileSystem>(
+            llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>())) {
+    underlying_fs_->setCurrentWorkingDirectory("/execroot");
+    AddFile("/usr/include/system.h", "system");
+    AddFile("/execroot/a.h", "a");
+    cached_fs_ = llvm::makeIntrusiveRefCnt<CachedFileSystem>(underlying_fs_);
+  }
+
+  // Adds or replaces the file at `path`. The in-memory file system doesn't
+  // allow changing a file, so every file goes into a new overlay.
+  void AddFile(llvm::StringRef path, llvm::StringRef contents) {
+    auto fs = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+    underlying_fs_->pushOverlay(fs);
+    fs->addFile(path, 0, llvm::MemoryBuffer::getMemBufferCopy(contents));
+  }
+
+  llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> underlying_fs_;
+  llvm::IntrusiveRefCntPtr<CachedFileSystem> cached_fs_;
+};
+
+TEST_F(CachedFileSystemTest, CachesFilesOutsideOfWorkingDirectory) {
+  EXPECT_EQ(ReadFile(*cached_fs_, "/usr/include/system.h"), "system");
+  EXPECT_EQ(cached_fs_->hits(), 0);
+  EXPECT_EQ(ReadFile(*cached_fs_, "/usr/include/system.h"), "system");
+  EXPECT_TRUE(cached_fs_->status("/usr/include/system.h"));
+  EXPECT_EQ(cached_fs_->hits(), 2);
+}
+
+TEST_F(CachedFileSystemTest, DoesNotCacheFilesInWorkingDirectory) {
+  EXPECT_EQ(ReadFile(*cached_fs_, "a.h"), "a");
+  EXPECT_EQ(ReadFile(*cached_fs_, "/execroot/a.h"), "a");
+  EXPECT_EQ(ReadFile(*cached_fs_, "a.h"), "a");
+  EXPECT_EQ(cached_fs_->hits(), 0);
+}
+
+TEST_F(CachedFileSystemTest, DoesNotCacheMissingFiles) {
+  EXPECT_FALSE(cached_fs_->status("/usr/include/missing.h"));
+  AddFile("/usr/include/missing.h", "found");
+  EXPECT_EQ(ReadFile(*cached_fs_, "/usr/include/missing.h"), "found");
+  EXPECT_EQ(cached_fs_->hits(), 0);
+}
+
+TEST_F(CachedFileSystemTest, CachesInputsByDigest) {
+  cached_fs_->SetInputDigests({{"a.h", "digest1"}});
+  EXPECT_EQ(ReadFile(*cached_fs_, "a.h"), "a");
+  EXPECT_EQ(ReadFile(*cached_fs_, "a.h"), "a");
+  EXPECT_EQ(cached_fs_->hits(), 1);
+
+  // The next request sees an edited `a.h`, with a different digest.
+  AddFile("/execroot/a.h", "edited");
+  cached_fs_->SetInputDigests({{"a.h", "digest2"}});
+  EXPECT_EQ(ReadFile(*cached_fs_, "a.h"), "edited");
+  EXPECT_EQ(ReadFile(*cached_fs_, "a.h"), "edited");
+  EXPECT_EQ(cached_fs_->hits(), 2);
+}
+
+TEST_F(CachedFileSystemTest, DoesNotCacheInputsWithoutDigest) {
+  // Even outside of the working directory, an input without a digest may have
+  // changed since the last request.
+  cached_fs_->SetInputDigests({{"/usr/include/system.h", ""}});
+  EXPECT_EQ(ReadFile(*cached_fs_, "/usr/include/system.h"), "system");
+  AddFile("/usr/include/system.h", "edited");
+  EXPECT_EQ(ReadFile(*cached_fs_, "/usr/include/system.h"), "edited");
+  EXPECT_EQ(cached_fs_->hits(), 0);
+}
+
+}  // namespace
+}  // namespace crubit
@@ -34,13 +34,20 @@ ABSL_FLAG(std::string, crubit_support_path, "",
           "files.");
 ABSL_FLAG(std::string, clang_format_exe_path, "",
           "Path to a clang-format executable that will be used to format the "
-          ".cc files generated by the tool.");
+          ".cc files generated by the tool if --use_external_formatters is "
+          "set.");
 ABSL_FLAG(std::string, rustfmt_exe_path, "",
           "Path to a rustfmt executable that will be used to format the "
-          ".rs files generated by the tool.");
+          ".rs files generated by the tool if --use_external_formatters is "
+          "set.");
 ABSL_FLAG(std::string, rustfmt_config_path, "",
           "(optional) path to a rustfmt.toml file that should replace the "
           "default formatting of the .rs files generated by the tool.");
+ABSL_FLAG(bool, use_external_formatters, false,
+          "format the generated files with clang-format and rustfmt (see "
+          "--clang_format_exe_path and --rustfmt_exe_path) instead of the "
+          "built-in pretty printer. The output is more polished, but spawning "
+          "the formatters often takes longer than generating the bindings.");
 ABSL_FLAG(std::vector<std::string>, public_headers, std::vector<std::string>(),
           "public headers of the cc_library this tool should generate bindings "
           "for, in a format suitable for usage in google3-relative quote "
@@ -76,6 +83,27 @@ ABSL_FLAG(std::string, error_report_out, "",
 ABSL_FLAG(bool, generate_source_location_in_doc_comment, true,
           "add the source code location from which the binding originates in"
           "the doc comment of the binding");
+ABSL_FLAG(std::string, precompiled_header, "",
+          "(optional) path to a precompiled header, written by "
+          "--precompiled_header_out with the same macro, language and target "
+          "Clang arguments (include paths may differ), from which "
+          "the headers it contains are loaded instead of being parsed.");
+ABSL_FLAG(std::string, precompiled_header_out, "",
+          "(optional) output path for a precompiled header of the "
+          "--public_headers, which other invocations can then pass as "
+          "--precompiled_header.");
+ABSL_FLAG(std::string, generated_item_cache_dir, "",
+          "(optional) directory in which the generated bindings of each item "
+          "are cached across runs. Items whose declarations (and the "
+          "declarations they depend on) didn't change since a previous run "
+          "that used the same directory are not generated again.");
+ABSL_FLAG(std::string, stats_out, "",
+          "(optional) output path for the time spent in each phase of the "
+          "generation and the peak memory usage, in the JSON trace event "
+          "format of chrome://tracing.");
+ABSL_FLAG(bool, skip_dependency_function_bodies, false,
+          "skip parsing the bodies of functions declared in the headers of "
+          "other targets, which the bindings don't depend on");
 
 namespace crubit {
 
@@ -113,7 +141,13 @@ absl::StatusOr<Cmdline> Cmdline::Create() {
       absl::GetFlag(FLAGS_error_report_out),
       absl::GetFlag(FLAGS_generate_source_location_in_doc_comment)
           ? SourceLocationDocComment::Enabled
-          : SourceLocationDocComment::Disabled);
+          : SourceLocationDocComment::Disabled,
+      absl::GetFlag(FLAGS_precompiled_header),
+      absl::GetFlag(FLAGS_precompiled_header_out),
+      absl::GetFlag(FLAGS_use_external_formatters),
+      absl::GetFlag(FLAGS_generated_item_cache_dir),
+      absl::GetFlag(FLAGS_stats_out),
+      absl::GetFlag(FLAGS_skip_dependency_function_bodies));
 }
 
 absl::StatusOr<Cmdline> Cmdline::CreateFromArgs(
@@ -125,7 +159,10 @@ absl::StatusOr<Cmdline> Cmdline::CreateFromArgs(
     std::string target_args_str, std::vector<std::string> extra_rs_srcs,
     std::vector<std::string> srcs_to_scan_for_instantiations,
     std::string instantiations_out, std::string error_report_out,
-    SourceLocationDocComment generate_source_location_in_doc_comment) {
+    SourceLocationDocComment generate_source_location_in_doc_comment,
+    std::string precompiled_header, std::string precompiled_header_out,
+    bool use_external_formatters, std::string generated_item_cache_dir,
+    std::string stats_out, bool skip_dependency_function_bodies) {
   Cmdline cmdline;
   if (current_target.empty()) {
     return absl::InvalidArgumentError("please specify --target");
@@ -162,6 +199,10 @@ absl::StatusOr<Cmdline> Cmdline::CreateFromArgs(
   cmdline.rustfmt_exe_path_ = std::move(rustfmt_exe_path);
 
   cmdline.rustfmt_config_path_ = std::move(rustfmt_config_path);
+  cmdline.use_external_formatters_ = use_external_formatters;
+  cmdline.generated_item_cache_dir_ = std::move(generated_item_cache_dir);
+  cmdline.stats_out_ = std::move(stats_out);
+  cmdline.skip_dependency_function_bodies_ = skip_dependency_function_bodies;
   cmdline.do_nothing_ = do_nothing;
   cmdline.generate_source_location_in_doc_comment_ =
       generate_source_location_in_doc_comment;
@@ -185,6 +226,14 @@ absl::StatusOr<Cmdline> Cmdline::CreateFromArgs(
       std::move(srcs_to_scan_for_instantiations);
   cmdline.error_report_out_ = std::move(error_report_out);
 
+  if (!precompiled_header.empty() && !precompiled_header_out.empty()) {
+    return absl::InvalidArgumentError(
+        "--precompiled_header and --precompiled_header_out can't be used "
+        "together");
+  }
+  cmdline.precompiled_header_ = std::move(precompiled_header);
+  cmdline.precompiled_header_out_ = std::move(precompiled_header_out);
+
   if (target_args_str.empty()) {
     return absl::InvalidArgumentError("please specify --target_args");
   }
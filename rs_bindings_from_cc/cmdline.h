@@ -36,7 +36,12 @@ class Cmdline {
       std::string target_args_str, std::vector<std::string> extra_rs_sources,
       std::vector<std::string> srcs_to_scan_for_instantiations,
       std::string instantiations_out, std::string error_report_out,
-      SourceLocationDocComment generate_source_location_in_doc_comment) {
+      SourceLocationDocComment generate_source_location_in_doc_comment,
+      std::string precompiled_header = "",
+      std::string precompiled_header_out = "",
+      bool use_external_formatters = false,
+      std::string generated_item_cache_dir = "", std::string stats_out = "",
+      bool skip_dependency_function_bodies = false) {
     return CreateFromArgs(
         std::move(current_target), std::move(cc_out), std::move(rs_out),
         std::move(ir_out), std::move(namespaces_out),
@@ -45,7 +50,10 @@ class Cmdline {
         std::move(public_headers), std::move(target_args_str),
         std::move(extra_rs_sources), std::move(srcs_to_scan_for_instantiations),
         std::move(instantiations_out), std::move(error_report_out),
-        generate_source_location_in_doc_comment);
+        generate_source_location_in_doc_comment, std::move(precompiled_header),
+        std::move(precompiled_header_out), use_external_formatters,
+        std::move(generated_item_cache_dir), std::move(stats_out),
+        skip_dependency_function_bodies);
   }
 
   Cmdline(const Cmdline&) = delete;
@@ -65,7 +73,19 @@ class Cmdline {
   absl::string_view rustfmt_config_path() const { return rustfmt_config_path_; }
   absl::string_view instantiations_out() const { return instantiations_out_; }
   absl::string_view error_report_out() const { return error_report_out_; }
+  absl::string_view precompiled_header() const { return precompiled_header_; }
+  absl::string_view precompiled_header_out() const {
+    return precompiled_header_out_;
+  }
   bool do_nothing() const { return do_nothing_; }
+  bool use_external_formatters() const { return use_external_formatters_; }
+  absl::string_view generated_item_cache_dir() const {
+    return generated_item_cache_dir_;
+  }
+  absl::string_view stats_out() const { return stats_out_; }
+  bool skip_dependency_function_bodies() const {
+    return skip_dependency_function_bodies_;
+  }
   SourceLocationDocComment generate_source_location_in_doc_comment() const {
     return generate_source_location_in_doc_comment_;
   }
@@ -105,7 +125,10 @@ class Cmdline {
       std::string target_args_str, std::vector<std::string> extra_rs_sources,
       std::vector<std::string> srcs_to_scan_for_instantiations,
       std::string instantiations_out, std::string error_report_out,
-      SourceLocationDocComment generate_source_location_in_doc_comment);
+      SourceLocationDocComment generate_source_location_in_doc_comment,
+      std::string precompiled_header, std::string precompiled_header_out,
+      bool use_external_formatters, std::string generated_item_cache_dir,
+      std::string stats_out, bool skip_dependency_function_bodies);
 
   absl::StatusOr<BazelLabel> FindHeader(const HeaderName& header) const;
 
@@ -117,7 +140,13 @@ class Cmdline {
   std::string rustfmt_exe_path_;
   std::string rustfmt_config_path_;
   std::string error_report_out_;
+  std::string precompiled_header_;
+  std::string precompiled_header_out_;
   bool do_nothing_ = true;
+  bool use_external_formatters_ = false;
+  std::string generated_item_cache_dir_;
+  std::string stats_out_;
+  bool skip_dependency_function_bodies_ = false;
   SourceLocationDocComment generate_source_location_in_doc_comment_ =
       SourceLocationDocComment::Enabled;
 
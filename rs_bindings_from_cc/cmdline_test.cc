@@ -68,6 +68,9 @@ TEST(CmdlineTest, BasicCorrectInput) {
   EXPECT_EQ(cmdline.instantiations_out(), "instantiations_out");
   EXPECT_EQ(cmdline.error_report_out(), "error_report_out");
   EXPECT_EQ(cmdline.do_nothing(), false);
+  EXPECT_EQ(cmdline.use_external_formatters(), false);
+  EXPECT_EQ(cmdline.generated_item_cache_dir(), "");
+  EXPECT_EQ(cmdline.stats_out(), "");
   EXPECT_EQ(cmdline.current_target().value(), "//:t1");
   EXPECT_THAT(cmdline.public_headers(), ElementsAre(HeaderName("h1")));
   EXPECT_THAT(cmdline.extra_rs_srcs(), ElementsAre("extra_file.rs"));
@@ -364,5 +367,127 @@ TEST(CmdlineTest, RustfmtExePathEmpty) {
       StatusIs(absl::StatusCode::kInvalidArgument,
                HasSubstr("please specify --rustfmt_exe_path")));
 }
+
+TEST(CmdlineTest, PrecompiledHeader) {
+  constexpr absl::string_view kTargetsAndHeaders = R"([
+    {"t": "//:target1", "h": ["a.h", "b.h"]}
+  ])";
+  ASSERT_OK_AND_ASSIGN(
+      Cmdline cmdline,
+      Cmdline::CreateForTesting(
+          "//:target1", "cc_out", "rs_out", "ir_out", "namespaces_out",
+          "crubit_support_path", "clang_format_exe_path", "rustfmt_exe_path",
+          "rustfmt_config_path",
+          /* do_nothing= */ false, {"a.h"}, std::string(kTargetsAndHeaders),
+          /* extra_rs_srcs= */ {},
+          /* srcs_to_scan_for_instantiations= */ {},
+          /* instantiations_out= */ "", "error_report_out",
+          SourceLocationDocComment::Enabled, "deps.pch",
+          /* precompiled_header_out= */ ""));
+  EXPECT_EQ(cmdline.precompiled_header(), "deps.pch");
+  EXPECT_EQ(cmdline.precompiled_header_out(), "");
+}
+
+TEST(CmdlineTest, PrecompiledHeaderInAndOut) {
+  constexpr absl::string_view kTargetsAndHeaders = R"([
+    {"t": "//:target1", "h": ["a.h", "b.h"]}
+  ])";
+  ASSERT_THAT(
+      Cmdline::CreateForTesting(
+          "//:target1", "cc_out", "rs_out", "ir_out", "namespaces_out",
+          "crubit_support_path", "clang_format_exe_path", "rustfmt_exe_path",
+          "rustfmt_config_path",
+          /* do_nothing= */ false, {"a.h"}, std::string(kTargetsAndHeaders),
+          /* extra_rs_srcs= */ {},
+          /* srcs_to_scan_for_instantiations= */ {},
+          /* instantiations_out= */ "", "error_report_out",
+          SourceLocationDocComment::Enabled, "deps.pch", "out.pch"),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("--precompiled_header and --precompiled_header_out "
+                         "can't be used together")));
+}
+
+TEST(CmdlineTest, UseExternalFormatters) {
+  constexpr absl::string_view kTargetsAndHeaders = R"([
+    {"t": "//:target1", "h": ["a.h", "b.h"]}
+  ])";
+  ASSERT_OK_AND_ASSIGN(
+      Cmdline cmdline,
+      Cmdline::CreateForTesting(
+          "//:target1", "cc_out", "rs_out", "ir_out", "namespaces_out",
+          "crubit_support_path", "clang_format_exe_path", "rustfmt_exe_path",
+          "rustfmt_config_path",
+          /* do_nothing= */ false, {"a.h"}, std::string(kTargetsAndHeaders),
+          /* extra_rs_srcs= */ {},
+          /* srcs_to_scan_for_instantiations= */ {},
+          /* instantiations_out= */ "", "error_report_out",
+          SourceLocationDocComment::Enabled, /* precompiled_header= */ "",
+          /* precompiled_header_out= */ "",
+          /* use_external_formatters= */ true));
+  EXPECT_EQ(cmdline.use_external_formatters(), true);
+}
+
+TEST(CmdlineTest, GeneratedItemCacheDir) {
+  constexpr absl::string_view kTargetsAndHeaders = R"([
+    {"t": "//:target1", "h": ["a.h", "b.h"]}
+  ])";
+  ASSERT_OK_AND_ASSIGN(
+      Cmdline cmdline,
+      Cmdline::CreateForTesting(
+          "//:target1", "cc_out", "rs_out", "ir_out", "namespaces_out",
+          "crubit_support_path", "clang_format_exe_path", "rustfmt_exe_path",
+          "rustfmt_config_path",
+          /* do_nothing= */ false, {"a.h"}, std::string(kTargetsAndHeaders),
+          /* extra_rs_srcs= */ {},
+          /* srcs_to_scan_for_instantiations= */ {},
+          /* instantiations_out= */ "", "error_report_out",
+          SourceLocationDocComment::Enabled, /* precompiled_header= */ "",
+          /* precompiled_header_out= */ "",
+          /* use_external_formatters= */ false, "/tmp/item_cache"));
+  EXPECT_EQ(cmdline.generated_item_cache_dir(), "/tmp/item_cache");
+}
+
+TEST(CmdlineTest, StatsOut) {
+  constexpr absl::string_view kTargetsAndHeaders = R"([
+    {"t": "//:target1", "h": ["a.h", "b.h"]}
+  ])";
+  ASSERT_OK_AND_ASSIGN(
+      Cmdline cmdline,
+      Cmdline::CreateForTesting(
+          "//:target1", "cc_out", "rs_out", "ir_out", "namespaces_out",
+          "crubit_support_path", "clang_format_exe_path", "rustfmt_exe_path",
+          "rustfmt_config_path",
+          /* do_nothing= */ false, {"a.h"}, std::string(kTargetsAndHeaders),
+          /* extra_rs_srcs= */ {},
+          /* srcs_to_scan_for_instantiations= */ {},
+          /* instantiations_out= */ "", "error_report_out",
+          SourceLocationDocComment::Enabled, /* precompiled_header= */ "",
+          /* precompiled_header_out= */ "",
+          /* use_external_formatters= */ false,
+          /* generated_item_cache_dir= */ "", "stats.json"));
+  EXPECT_EQ(cmdline.stats_out(), "stats.json");
+}
+
+TEST(CmdlineTest, SkipDependencyFunctionBodies) {
+  constexpr absl::string_view kTargetsAndHeaders = R"([
+    {"t": "//:target1", "h": ["a.h", "b.h"]}
+  ])";
+  ASSERT_OK_AND_ASSIGN(
+      Cmdline cmdline,
+      Cmdline::CreateForTesting(
+          "//:target1", "cc_out", "rs_out", "ir_out", "namespaces_out",
+          "crubit_support_path", "clang_format_exe_path", "rustfmt_exe_path",
+          "rustfmt_config_path",
+          /* do_nothing= */ false, {"a.h"}, std::string(kTargetsAndHeaders),
+          /* extra_rs_srcs= */ {},
+          /* srcs_to_scan_for_instantiations= */ {},
+          /* instantiations_out= */ "", "error_report_out",
+          SourceLocationDocComment::Enabled, /* precompiled_header= */ "",
+          /* precompiled_header_out= */ "",
+          /* use_external_formatters= */ false,
+          /* generated_item_cache_dir= */ "", /* stats_out= */ "",
+          /* skip_dependency_function_bodies= */ true));
+  EXPECT_TRUE(cmdline.skip_dependency_function_bodies());
+}
 }  // namespace
 }  // namespace crubit
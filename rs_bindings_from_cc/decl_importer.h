@@ -5,6 +5,7 @@
 #ifndef CRUBIT_RS_BINDINGS_FROM_CC_DECL_IMPORTER_H_
 #define CRUBIT_RS_BINDINGS_FROM_CC_DECL_IMPORTER_H_
 
+#include <deque>
 #include <memory>
 #include <optional>
 #include <set>
@@ -17,6 +18,7 @@
 #include "lifetime_annotations/lifetime_annotations.h"
 #include "rs_bindings_from_cc/bazel_types.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/stats.h"
 #include "clang/AST/Type.h"
 
 namespace crubit {
@@ -60,6 +62,18 @@ class Invocation {
   // The main output of the import process
   IR ir_;
 
+  // Owns the items created during the import. Each item is allocated here
+  // once; the import cache and the sorting of items refer to it by pointer,
+  // and it is only moved into `ir_.items` at the end of the import.
+  std::deque<IR::Item> item_arena_;
+
+  // Where to record the time spent in the import, if anywhere.
+  Stats* stats_ = nullptr;
+
+  // Whether to skip parsing the bodies of functions from headers that aren't
+  // owned by `target_`. See `AstConsumer::shouldSkipFunctionBody`.
+  bool skip_dependency_function_bodies_ = false;
+
  private:
   const absl::flat_hash_map<HeaderName, BazelLabel>& header_targets_;
 };
@@ -90,11 +104,12 @@ class ImportContext {
   // Does not use or update the cache.
   virtual std::optional<IR::Item> ImportDecl(clang::Decl* decl) = 0;
 
-  // Returns the Item of a Decl, importing it first if necessary.
-  // Updates the cache.
-  virtual std::optional<IR::Item> GetDeclItem(clang::Decl* decl) = 0;
+  // Returns the Item of a Decl, importing it first if necessary, or null if it
+  // isn't imported. Updates the cache.
+  virtual const IR::Item* GetDeclItem(clang::Decl* decl) = 0;
 
-  virtual std::optional<IR::Item> GetImportedItem(const clang::Decl* decl) = 0;
+  // Returns the Item of a Decl if it has already been imported, or null.
+  virtual const IR::Item* GetImportedItem(const clang::Decl* decl) = 0;
 
   // Imports children of `decl`.
   //
@@ -107,6 +122,15 @@ class ImportContext {
   virtual std::string GetMangledName(
       const clang::NamedDecl* named_decl) const = 0;
 
+  // Returns the ID of a decl (see `GenerateItemId`), which is only computed
+  // once per decl.
+  virtual ItemId GetItemId(const clang::Decl* decl) const = 0;
+
+  // Returns the ID of the parent namespace of a decl, or `std::nullopt` for top
+  // level decls (see `GetEnclosingNamespace`).
+  virtual std::optional<ItemId> GetEnclosingNamespaceId(
+      const clang::Decl* decl) const = 0;
+
   // Returs the label of the target that contains a decl.
   virtual BazelLabel GetOwningTarget(const clang::Decl* decl) const = 0;
 
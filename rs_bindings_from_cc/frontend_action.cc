@@ -19,4 +19,12 @@ std::unique_ptr<clang::ASTConsumer> FrontendAction::CreateASTConsumer(
   return std::make_unique<AstConsumer>(instance, invocation_);
 }
 
+bool FrontendAction::BeginInvocation(clang::CompilerInstance& instance) {
+  // The parser then asks the AST consumer which function bodies to skip.
+  if (invocation_.skip_dependency_function_bodies_) {
+    instance.getFrontendOpts().SkipFunctionBodies = true;
+  }
+  return clang::ASTFrontendAction::BeginInvocation(instance);
+}
+
 }  // namespace crubit
@@ -23,6 +23,9 @@ class FrontendAction : public clang::ASTFrontendAction {
   std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(
       clang::CompilerInstance& instance, llvm::StringRef) override;
 
+ protected:
+  bool BeginInvocation(clang::CompilerInstance& instance) override;
+
  private:
   Invocation& invocation_;
 };
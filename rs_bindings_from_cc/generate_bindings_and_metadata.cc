@@ -17,6 +17,7 @@
 #include "rs_bindings_from_cc/ir.h"
 #include "rs_bindings_from_cc/ir_from_cc.h"
 #include "rs_bindings_from_cc/src_code_gen.h"
+#include "rs_bindings_from_cc/stats.h"
 
 namespace crubit {
 
@@ -57,14 +58,20 @@ std::vector<const Record*> FindInstantiationsInNamespace(const IR& ir,
 absl::StatusOr<BindingsAndMetadata> GenerateBindingsAndMetadata(
     Cmdline& cmdline, std::vector<std::string> clang_args,
     absl::flat_hash_map<const HeaderName, const std::string>
-        virtual_headers_contents_for_testing) {
+        virtual_headers_contents_for_testing,
+    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> file_system,
+    Stats* stats) {
   std::vector<absl::string_view> clang_args_view;
   clang_args_view.insert(clang_args_view.end(), clang_args.begin(),
                          clang_args.end());
 
-  CRUBIT_ASSIGN_OR_RETURN(
-      std::vector<std::string> requested_instantiations,
-      CollectInstantiations(cmdline.srcs_to_scan_for_instantiations()));
+  std::vector<std::string> requested_instantiations;
+  {
+    Stats::Phase phase(stats, "CollectInstantiations");
+    CRUBIT_ASSIGN_OR_RETURN(
+        requested_instantiations,
+        CollectInstantiations(cmdline.srcs_to_scan_for_instantiations()));
+  }
 
   CRUBIT_ASSIGN_OR_RETURN(
       IR ir, IrFromCc({.current_target = cmdline.current_target(),
@@ -75,20 +82,49 @@ absl::StatusOr<BindingsAndMetadata> GenerateBindingsAndMetadata(
                        .extra_rs_srcs = cmdline.extra_rs_srcs(),
                        .clang_args = clang_args_view,
                        .extra_instantiations = requested_instantiations,
-                       .crubit_features = cmdline.target_to_features()}));
+                       .crubit_features = cmdline.target_to_features(),
+                       .file_system = file_system,
+                       .precompiled_header = cmdline.precompiled_header(),
+                       .skip_dependency_function_bodies =
+                           cmdline.skip_dependency_function_bodies(),
+                       .stats = stats}));
+
+  if (stats != nullptr) {
+    stats->SetCounter("items", ir.items.size());
+    stats->SetCounter("unsupported_items",
+                      ir.get_items_if<UnsupportedItem>().size());
+  }
+
+  if (!cmdline.precompiled_header_out().empty()) {
+    Stats::Phase phase(stats, "PrecompileHeaders");
+    CRUBIT_RETURN_IF_ERROR(PrecompileHeaders(
+        {.public_headers = cmdline.public_headers(),
+         .clang_args = clang_args_view,
+         .file_system = std::move(file_system)},
+        cmdline.precompiled_header_out()));
+  }
 
   if (!cmdline.instantiations_out().empty()) {
     ir.crate_root_path = "__cc_template_instantiations_rs_api";
   }
 
   bool generate_error_report = !cmdline.error_report_out().empty();
-  CRUBIT_ASSIGN_OR_RETURN(
-      Bindings bindings,
-      GenerateBindings(ir, cmdline.crubit_support_path(),
-                       cmdline.clang_format_exe_path(),
-                       cmdline.rustfmt_exe_path(),
-                       cmdline.rustfmt_config_path(), generate_error_report,
-                       cmdline.generate_source_location_in_doc_comment()));
+  // Without the paths to the external formatters, `GenerateBindings` uses its
+  // built-in pretty printer.
+  bool use_external_formatters = cmdline.use_external_formatters();
+  Bindings bindings;
+  {
+    Stats::Phase phase(stats, "GenerateBindings");
+    CRUBIT_ASSIGN_OR_RETURN(
+        bindings,
+        GenerateBindings(
+            ir, cmdline.crubit_support_path(),
+            use_external_formatters ? cmdline.clang_format_exe_path() : "",
+            use_external_formatters ? cmdline.rustfmt_exe_path() : "",
+            cmdline.rustfmt_config_path(), generate_error_report,
+            cmdline.generate_source_location_in_doc_comment(),
+            cmdline.generated_item_cache_dir(), stats));
+  }
 
   absl::flat_hash_map<std::string, std::string> instantiations;
   std::optional<const Namespace*> ns =
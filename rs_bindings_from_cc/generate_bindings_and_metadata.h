@@ -12,6 +12,9 @@
 #include "rs_bindings_from_cc/cmdline.h"
 #include "rs_bindings_from_cc/collect_namespaces.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/stats.h"
+#include "llvm/ADT/IntrusiveRefCntPtr.h"
+#include "llvm/Support/VirtualFileSystem.h"
 
 namespace crubit {
 // Contains generated bindings and all related metadata, such as the IR.
@@ -33,10 +36,18 @@ struct BindingsAndMetadata {
 };
 
 // Returns `BindingsAndMetadata` as requested by the user on the command line.
+//
+// Headers are read from `file_system`, or from the real file system if it is
+// null.
+//
+// If `stats` is not null, the time spent in each phase and the number of
+// generated items are recorded in it.
 absl::StatusOr<BindingsAndMetadata> GenerateBindingsAndMetadata(
     Cmdline& cmdline, std::vector<std::string> clang_args,
     absl::flat_hash_map<const HeaderName, const std::string>
-        virtual_headers_contents_for_testing = {});
+        virtual_headers_contents_for_testing = {},
+    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> file_system = nullptr,
+    Stats* stats = nullptr);
 
 }  // namespace crubit
 
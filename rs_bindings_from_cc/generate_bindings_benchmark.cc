@@ -0,0 +1,149 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Benchmarks `GenerateBindingsAndMetadata` on synthetic headers of increasing
+// size (see `synthetic_header.h`), and prints the time spent in each phase,
+// the throughput in IR items per second and the peak memory usage.
+//
+// The sizes are benchmarked in increasing order in the same process, so the
+// peak resident set size reported for a size is the one of that size.
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/status/status.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "common/file_io.h"
+#include "common/status_macros.h"
+#include "rs_bindings_from_cc/cmdline.h"
+#include "rs_bindings_from_cc/generate_bindings_and_metadata.h"
+#include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/stats.h"
+#include "rs_bindings_from_cc/synthetic_header.h"
+#include "llvm/Support/raw_ostream.h"
+
+ABSL_FLAG(std::vector<std::string>, sizes,
+          std::vector<std::string>({"100", "1000", "10000", "100000"}),
+          "The numbers of top-level declarations in the benchmarked headers.");
+ABSL_FLAG(int, record_percent, 50,
+          "The percentage of the declarations that are records.");
+ABSL_FLAG(int, template_percent, 10,
+          "The percentage of the declarations that are class template "
+          "instantiations. The remaining declarations are functions.");
+ABSL_FLAG(int, methods_per_record, 4, "The number of methods of each record.");
+ABSL_FLAG(int, fields_per_record, 2, "The number of fields of each record.");
+ABSL_FLAG(int, decls_per_namespace, 100,
+          "The number of declarations in each namespace, or 0 for none.");
+ABSL_FLAG(bool, comments, true,
+          "Whether the headers contain doc comments and other comments.");
+ABSL_FLAG(std::string, trace_out_dir, "",
+          "(optional) directory in which to write the Chrome trace of each "
+          "size, as `<size>.json`.");
+
+namespace crubit {
+namespace {
+
+constexpr absl::string_view kHeaderName = "synthetic.h";
+constexpr absl::string_view kTargetArgs = R"([
+  {"t": "//benchmark:synthetic", "h": ["synthetic.h"],
+   "f": ["supported", "experimental"]}
+])";
+
+absl::Status RunBenchmark(int num_decls) {
+  SyntheticHeaderOptions options = {
+      .num_decls = num_decls,
+      .record_percent = absl::GetFlag(FLAGS_record_percent),
+      .template_percent = absl::GetFlag(FLAGS_template_percent),
+      .methods_per_record = absl::GetFlag(FLAGS_methods_per_record),
+      .fields_per_record = absl::GetFlag(FLAGS_fields_per_record),
+      .decls_per_namespace = absl::GetFlag(FLAGS_decls_per_namespace),
+      .comments = absl::GetFlag(FLAGS_comments),
+  };
+  std::string header = SyntheticHeader(options);
+
+  // The formatters are only used with `use_external_formatters`, so their
+  // paths don't matter.
+  CRUBIT_ASSIGN_OR_RETURN(
+      Cmdline cmdline,
+      Cmdline::CreateForTesting(
+          "//benchmark:synthetic", "cc_out", "rs_out", "ir_out",
+          "namespaces_out", "crubit_support_path", "clang_format_exe_path",
+          "rustfmt_exe_path", "rustfmt_config_path",
+          /* do_nothing= */ false, {std::string(kHeaderName)},
+          std::string(kTargetArgs),
+          /* extra_rs_srcs= */ {},
+          /* srcs_to_scan_for_instantiations= */ {},
+          /* instantiations_out= */ "", /* error_report_out= */ "",
+          SourceLocationDocComment::Enabled));
+
+  Stats stats;
+  absl::Time start = absl::Now();
+  CRUBIT_ASSIGN_OR_RETURN(
+      BindingsAndMetadata bindings_and_metadata,
+      GenerateBindingsAndMetadata(
+          cmdline, /* clang_args= */ {},
+          {{HeaderName(std::string(kHeaderName)), std::move(header)}},
+          /* file_system= */ nullptr, &stats));
+  absl::Duration wall_time = absl::Now() - start;
+
+  int64_t num_items = bindings_and_metadata.ir.items.size();
+  std::cout << absl::StrFormat(
+      "decls=%d items=%d wall=%s items/sec=%.0f rs_api=%dKiB "
+      "peak_rss=%dMiB\n",
+      num_decls, num_items, absl::FormatDuration(wall_time),
+      num_items / std::max(absl::ToDoubleSeconds(wall_time), 1e-9),
+      bindings_and_metadata.rs_api.size() / 1024,
+      Stats::PeakRssBytes() / (1024 * 1024));
+  for (const Stats::PhaseRecord& phase : stats.phases()) {
+    std::cout << absl::StrFormat("  %-28s %s\n", phase.name,
+                                 absl::FormatDuration(phase.wall_time));
+  }
+
+  std::string trace_out_dir = absl::GetFlag(FLAGS_trace_out_dir);
+  if (!trace_out_dir.empty()) {
+    CRUBIT_RETURN_IF_ERROR(
+        SetFileContents(absl::StrCat(trace_out_dir, "/", num_decls, ".json"),
+                        stats.ToChromeTraceJson()));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status Main() {
+  std::vector<int> sizes;
+  for (const std::string& size : absl::GetFlag(FLAGS_sizes)) {
+    int num_decls;
+    if (!absl::SimpleAtoi(size, &num_decls) || num_decls <= 0) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("invalid --sizes entry: ", size));
+    }
+    sizes.push_back(num_decls);
+  }
+  std::sort(sizes.begin(), sizes.end());
+  for (int num_decls : sizes) {
+    CRUBIT_RETURN_IF_ERROR(RunBenchmark(num_decls));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+}  // namespace crubit
+
+int main(int argc, char* argv[]) {
+  absl::ParseCommandLine(argc, argv);
+  absl::Status status = crubit::Main();
+  if (!status.ok()) {
+    llvm::errs() << status.message() << "\n";
+    return -1;
+  }
+  return 0;
+}
@@ -44,6 +44,7 @@
 #include "clang/AST/DeclFriend.h"
 #include "clang/AST/Mangle.h"
 #include "clang/AST/RawCommentList.h"
+#include "clang/AST/RecordLayout.h"
 #include "clang/AST/Type.h"
 #include "clang/Basic/FileManager.h"
 #include "clang/Basic/LLVM.h"
@@ -51,7 +52,10 @@
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Basic/Specifiers.h"
+#include "clang/Basic/TargetInfo.h"
+#include "clang/Lex/Preprocessor.h"
 #include "clang/Sema/Sema.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/FormatVariadic.h"
@@ -65,11 +69,11 @@ constexpr absl::string_view kTypeStatusPayloadUrl =
 
 // Checks if the return value from `GetDeclItem` indicates that the import was
 // successful.
-absl::Status CheckImportStatus(const std::optional<IR::Item>& item) {
-  if (!item.has_value()) {
+absl::Status CheckImportStatus(const IR::Item* item) {
+  if (item == nullptr) {
     return absl::InvalidArgumentError("The import has been skipped");
   }
-  if (auto* unsupported = std::get_if<UnsupportedItem>(&*item)) {
+  if (auto* unsupported = std::get_if<UnsupportedItem>(item)) {
     return absl::InvalidArgumentError(unsupported->message);
   }
   return absl::OkStatus();
@@ -158,6 +162,93 @@ absl::StatusOr<absl::string_view> ConvertCcCallConvIntoRsAbi(
                        clang::FunctionType::getNameForCallConv(cc_call_conv))));
 }
 
+// Returns whether the span `decl` holds a pointer to its first element,
+// followed by its number of elements, like `cc_std::Span`.
+//
+// The members of spans are private, so their offsets can't be asserted with
+// `offsetof` in the generated C++ code, like the sizes of spans are.
+bool HasSpanLayout(const clang::CXXRecordDecl& decl,
+                   clang::QualType element_type, clang::ASTContext& ctx) {
+  const clang::CXXRecordDecl* definition = decl.getDefinition();
+  if (definition == nullptr || definition->isInvalidDecl() ||
+      definition->getNumBases() != 0 || definition->isPolymorphic()) {
+    return false;
+  }
+  std::vector<const clang::FieldDecl*> fields(definition->field_begin(),
+                                              definition->field_end());
+  if (fields.size() != 2 || fields[0]->isBitField() ||
+      fields[1]->isBitField()) {
+    return false;
+  }
+  const clang::ASTRecordLayout& layout = ctx.getASTRecordLayout(definition);
+  uint64_t pointer_width = ctx.getTypeSize(ctx.VoidPtrTy);
+  // The number of elements may be wrapped in a struct, e.g. by libstdc++.
+  return ctx.hasSameType(fields[0]->getType(),
+                         ctx.getPointerType(element_type)) &&
+         layout.getFieldOffset(0) == 0 &&
+         ctx.getTypeSize(fields[1]->getType()) == pointer_width &&
+         layout.getFieldOffset(1) == pointer_width;
+}
+
+// Returns whether the `std::vector` `decl` has the layout of `cc_std::Vector`,
+// i.e. the layout of libc++: pointers to the first element, past the last
+// element, and past the end of the allocation, in this order.
+//
+// Like for spans, the members are private, so their offsets are checked here
+// rather than in the generated C++ code.
+bool HasVectorLayout(const clang::CXXRecordDecl& decl,
+                     clang::QualType element_type, clang::ASTContext& ctx) {
+  const clang::CXXRecordDecl* definition = decl.getDefinition();
+  if (definition == nullptr || definition->isInvalidDecl() ||
+      definition->getNumBases() != 0 || definition->isPolymorphic()) {
+    return false;
+  }
+  const clang::ASTRecordLayout& layout = ctx.getASTRecordLayout(definition);
+  uint64_t pointer_width = ctx.getTypeSize(ctx.VoidPtrTy);
+  if (layout.getSize() != ctx.toCharUnitsFromBits(3 * pointer_width)) {
+    return false;
+  }
+  clang::QualType pointer_type = ctx.getPointerType(element_type);
+  bool has_begin = false;
+  bool has_end = false;
+  bool has_end_cap = false;
+  for (const clang::FieldDecl* field : definition->fields()) {
+    if (field->getIdentifier() == nullptr || field->isBitField()) continue;
+    uint64_t offset = layout.getFieldOffset(field->getFieldIndex());
+    llvm::StringRef name = field->getName();
+    if (name == "__begin_") {
+      has_begin =
+          offset == 0 && ctx.hasSameType(field->getType(), pointer_type);
+    } else if (name == "__end_") {
+      has_end = offset == pointer_width &&
+                ctx.hasSameType(field->getType(), pointer_type);
+    } else if (name == "__end_cap_" || name == "__cap_") {
+      // `__end_cap_` also holds the allocator, which takes no space. It was
+      // renamed to `__cap_` in LLVM 19.
+      has_end_cap = offset == 2 * pointer_width;
+    }
+  }
+  return has_begin && has_end && has_end_cap;
+}
+
+// Returns whether the `std::string` `decl` has the layout of
+// `cc_std::StdString`: the default layout of libc++, on a little-endian
+// target.
+bool HasStdStringLayout(const clang::CXXRecordDecl& decl, clang::Sema& sema) {
+  clang::Preprocessor& preprocessor = sema.getPreprocessor();
+  if (!preprocessor.isMacroDefined("_LIBCPP_VERSION") ||
+      preprocessor.isMacroDefined("_LIBCPP_ABI_ALTERNATE_STRING_LAYOUT") ||
+      sema.getASTContext().getTargetInfo().isBigEndian()) {
+    return false;
+  }
+  // libc++ declares `std` in an inline namespace named after its ABI version,
+  // and ABI versions after 1 use the alternate layout.
+  const auto* inline_namespace =
+      llvm::dyn_cast<clang::NamespaceDecl>(decl.getDeclContext());
+  return inline_namespace != nullptr && inline_namespace->isInline() &&
+         inline_namespace->getName() == "__1";
+}
+
 }  // namespace
 
 // Multiple IR items can be associated with the same source location (e.g. the
@@ -191,49 +282,33 @@ static int GetDeclOrder(const clang::Decl* decl) {
   return 999;
 }
 
+// Orders items by their source range, then by GetDeclOrder, then by
+// GetNameForSourceOrder. Items are sorted with SortInSourceOrder, which only
+// computes the names when they are needed to break ties.
 class Importer::SourceOrderKey {
  public:
   explicit SourceOrderKey(clang::SourceRange source_range, int decl_order = 0,
-                          std::string name = "")
-      : source_range_(source_range), decl_order_(decl_order), name_(name) {}
+                          const clang::Decl* decl = nullptr)
+      : source_range_(source_range), decl_order_(decl_order), decl_(decl) {}
 
   SourceOrderKey(const SourceOrderKey&) = default;
   SourceOrderKey& operator=(const SourceOrderKey&) = default;
 
-  bool isBefore(const SourceOrderKey& other,
-                const clang::SourceManager& sm) const {
-    if (!source_range_.isValid() || !other.source_range_.isValid()) {
-      if (source_range_.isValid() != other.source_range_.isValid())
-        return !source_range_.isValid() && other.source_range_.isValid();
-    } else {
-      if (source_range_.getBegin() != other.source_range_.getBegin()) {
-        return sm.isBeforeInTranslationUnit(source_range_.getBegin(),
-                                            other.source_range_.getBegin());
-      }
-      if (source_range_.getEnd() != other.source_range_.getEnd()) {
-        return sm.isBeforeInTranslationUnit(source_range_.getEnd(),
-                                            other.source_range_.getEnd());
-      }
-    }
-
-    if (decl_order_ < other.decl_order_) {
-      return true;
-    } else if (decl_order_ > other.decl_order_) {
-      return false;
-    }
-    return name_ < other.name_;
-  }
+  clang::SourceRange source_range() const { return source_range_; }
+  int decl_order() const { return decl_order_; }
+  // The decl to take the name from, or null for items without a name (e.g.
+  // comments).
+  const clang::Decl* decl() const { return decl_; }
 
  private:
   clang::SourceRange source_range_;
   int decl_order_;
-  std::string name_;
+  const clang::Decl* decl_;
 };
 
 Importer::SourceOrderKey Importer::GetSourceOrderKey(
     const clang::Decl* decl) const {
-  return SourceOrderKey(decl->getSourceRange(), GetDeclOrder(decl),
-                        GetNameForSourceOrder(decl));
+  return SourceOrderKey(decl->getSourceRange(), GetDeclOrder(decl), decl);
 }
 
 Importer::SourceOrderKey Importer::GetSourceOrderKey(
@@ -261,20 +336,91 @@ class Importer::SourceLocationComparator {
   }
 
   using OrderedItemId = std::pair<SourceOrderKey, ItemId>;
-  using OrderedItem = std::pair<SourceOrderKey, IR::Item>;
+  using OrderedItem = std::pair<SourceOrderKey, IR::Item*>;
 
-  template <typename OrderedItemOrId>
-  bool operator()(const OrderedItemOrId& a, const OrderedItemOrId& b) const {
-    auto a_source_order = a.first;
-    auto b_source_order = b.first;
-    return a_source_order.isBefore(b_source_order, sm_);
-  }
   explicit SourceLocationComparator(const clang::SourceManager& sm) : sm_(sm) {}
 
  private:
   const clang::SourceManager& sm_;
 };
 
+template <typename T>
+void Importer::SortInSourceOrder(
+    std::vector<std::pair<SourceOrderKey, T>>& items) const {
+  // Comparing source locations is expensive (they can be in different files,
+  // or in macro expansions), so the distinct locations are ranked once, and
+  // the items are then sorted by packed integer keys:
+  //   (begin rank << 32 | end rank, decl order << 32 | name rank, index).
+  // Items with an invalid source range get the rank 0, and go first.
+  std::vector<clang::SourceLocation> locations;
+  locations.reserve(2 * items.size());
+  for (const auto& [key, _] : items) {
+    if (key.source_range().isValid()) {
+      locations.push_back(key.source_range().getBegin());
+      locations.push_back(key.source_range().getEnd());
+    }
+  }
+  llvm::sort(locations, [](clang::SourceLocation a, clang::SourceLocation b) {
+    return a.getRawEncoding() < b.getRawEncoding();
+  });
+  locations.erase(std::unique(locations.begin(), locations.end()),
+                  locations.end());
+  llvm::sort(locations, SourceLocationComparator(ctx_.getSourceManager()));
+  llvm::DenseMap<clang::SourceLocation, uint64_t> location_ranks;
+  location_ranks.reserve(locations.size());
+  for (size_t i = 0; i < locations.size(); ++i) {
+    location_ranks[locations[i]] = i + 1;
+  }
+
+  std::vector<std::tuple<uint64_t, uint64_t, size_t>> keys;
+  keys.reserve(items.size());
+  for (size_t i = 0; i < items.size(); ++i) {
+    const SourceOrderKey& key = items[i].first;
+    uint64_t location = 0;
+    if (key.source_range().isValid()) {
+      location = location_ranks.lookup(key.source_range().getBegin()) << 32 |
+                 location_ranks.lookup(key.source_range().getEnd());
+    }
+    uint64_t order = static_cast<uint64_t>(key.decl_order()) << 32;
+    keys.push_back({location, order, i});
+  }
+  llvm::sort(keys);
+
+  // Names only matter for items with the same location and decl order (e.g.
+  // the members of implicit class template specializations), so they are only
+  // computed (and ranked) within such runs.
+  for (auto run_begin = keys.begin(); run_begin != keys.end();) {
+    auto run_end = std::find_if(run_begin, keys.end(), [&](const auto& key) {
+      return std::get<0>(key) != std::get<0>(*run_begin) ||
+             std::get<1>(key) != std::get<1>(*run_begin);
+    });
+    if (run_end - run_begin > 1) {
+      std::vector<std::pair<std::string, size_t>> names;
+      names.reserve(run_end - run_begin);
+      for (auto it = run_begin; it != run_end; ++it) {
+        const clang::Decl* decl = items[std::get<2>(*it)].first.decl();
+        names.push_back({decl ? GetNameForSourceOrder(decl) : "",
+                         static_cast<size_t>(it - run_begin)});
+      }
+      llvm::sort(names);
+      uint64_t name_rank = 0;
+      for (size_t i = 0; i < names.size(); ++i) {
+        if (i > 0 && names[i].first != names[i - 1].first) ++name_rank;
+        std::get<1>(*(run_begin + names[i].second)) |= name_rank;
+      }
+      llvm::sort(run_begin, run_end);
+    }
+    run_begin = run_end;
+  }
+
+  std::vector<std::pair<SourceOrderKey, T>> sorted_items;
+  sorted_items.reserve(items.size());
+  for (const auto& key : keys) {
+    sorted_items.push_back(std::move(items[std::get<2>(key)]));
+  }
+  items = std::move(sorted_items);
+}
+
 static std::vector<clang::Decl*> GetCanonicalChildren(
     const clang::DeclContext* decl_context) {
   std::vector<clang::Decl*> result;
@@ -338,8 +484,8 @@ std::vector<ItemId> Importer::GetItemIdsInSourceOrder(
       continue;
     }
     // Only add item ids for decls that can be successfully imported.
-    if (item.has_value()) {
-      auto item_id = GenerateItemId(decl);
+    if (item != nullptr) {
+      auto item_id = GetItemId(decl);
       // TODO(rosica): Drop this check when we start importing also other
       // redecls, not just the canonical
       if (visited_item_ids.find(item_id) == visited_item_ids.end()) {
@@ -358,9 +504,10 @@ std::vector<ItemId> Importer::GetItemIdsInSourceOrder(
   }
 
   for (auto& [_, comment] : ordered_comments) {
-    items.push_back({GetSourceOrderKey(comment), GenerateItemId(comment)});
+    items.push_back({GetSourceOrderKey(comment),
+                     GenerateItemId(comment, ctx_.getSourceManager())});
   }
-  llvm::sort(items, compare_locations);
+  SortInSourceOrder(items);
 
   std::vector<ItemId> ordered_item_ids;
   ordered_item_ids.reserve(items.size());
@@ -375,12 +522,9 @@ std::vector<ItemId> Importer::GetOrderedItemIdsOfTemplateInstantiations()
   std::vector<SourceLocationComparator::OrderedItemId> items;
   items.reserve(class_template_instantiations_.size());
   for (const auto* decl : class_template_instantiations_) {
-    items.push_back({GetSourceOrderKey(decl), GenerateItemId(decl)});
+    items.push_back({GetSourceOrderKey(decl), GetItemId(decl)});
   }
-
-  clang::SourceManager& sm = ctx_.getSourceManager();
-  auto compare_locations = SourceLocationComparator(sm);
-  llvm::sort(items, compare_locations);
+  SortInSourceOrder(items);
 
   std::vector<ItemId> ordered_item_ids;
   ordered_item_ids.reserve(items.size());
@@ -414,27 +558,24 @@ void Importer::Import(clang::TranslationUnitDecl* translation_unit_decl) {
   for (auto& comment : comments_) {
     ordered_items.push_back(
         {GetSourceOrderKey(comment),
-         Comment{.text = comment->getFormattedText(sm, sm.getDiagnostics()),
-                 .id = GenerateItemId(comment)}});
+         &invocation_.item_arena_.emplace_back(
+             Comment{.text = comment->getFormattedText(sm, sm.getDiagnostics()),
+                     .id = GenerateItemId(comment, sm)})});
   }
 
   ImportDeclsFromDeclContext(translation_unit_decl);
   for (const auto& [decl, item] : import_cache_) {
-    if (item.has_value()) {
+    if (item != nullptr) {
       if (std::holds_alternative<UnsupportedItem>(*item) &&
           !IsFromCurrentTarget(decl)) {
         continue;
       }
-      ordered_items.push_back({GetSourceOrderKey(decl), *item});
+      ordered_items.push_back({GetSourceOrderKey(decl), item});
     }
   }
 
-  llvm::sort(ordered_items, SourceLocationComparator(sm));
+  SortInSourceOrder(ordered_items);
 
-  invocation_.ir_.items.reserve(ordered_items.size());
-  for (auto& ordered_item : ordered_items) {
-    invocation_.ir_.items.push_back(ordered_item.second);
-  }
   invocation_.ir_.top_level_item_ids =
       GetItemIdsInSourceOrder(translation_unit_decl);
 
@@ -442,6 +583,15 @@ void Importer::Import(clang::TranslationUnitDecl* translation_unit_decl) {
   // into a separate namespace (maybe `crubit::instantiated_templates` ?).
   llvm::copy(GetOrderedItemIdsOfTemplateInstantiations(),
              std::back_inserter(invocation_.ir_.top_level_item_ids));
+
+  // Last, because this leaves the items in the import cache moved-from. The
+  // cache is cleared, and decls can no longer be looked up.
+  invocation_.ir_.items.reserve(ordered_items.size());
+  for (auto& [_, item] : ordered_items) {
+    invocation_.ir_.items.push_back(std::move(*item));
+  }
+  import_cache_.clear();
+  items_moved_to_ir_ = true;
 }
 
 void Importer::ImportDeclsFromDeclContext(
@@ -451,7 +601,8 @@ void Importer::ImportDeclsFromDeclContext(
   }
 }
 
-std::optional<IR::Item> Importer::GetDeclItem(clang::Decl* decl) {
+const IR::Item* Importer::GetDeclItem(clang::Decl* decl) {
+  CHECK(!items_moved_to_ir_) << "Decls can't be imported after Import()";
   // TODO(jeanpierreda): Move `decl->getCanonicalDecl()` from callers into here.
   if (auto it = import_cache_.find(decl); it != import_cache_.end()) {
     return it->second;
@@ -490,7 +641,11 @@ std::optional<IR::Item> Importer::GetDeclItem(clang::Decl* decl) {
   // Note: insert_or_assign, not insert, in case a record, so as to overwrite
   // any null entries introduced by cycles.
 
-  std::optional<IR::Item> result = ImportDecl(decl);
+  std::optional<IR::Item> imported = ImportDecl(decl);
+  IR::Item* result =
+      imported.has_value()
+          ? &invocation_.item_arena_.emplace_back(std::move(*imported))
+          : nullptr;
   auto [it, inserted] = import_cache_.try_emplace(decl, result);
   if (!inserted) {
     // TODO(jeanpierreda): Fix and promote to CHECK.
@@ -502,7 +657,7 @@ std::optional<IR::Item> Importer::GetDeclItem(clang::Decl* decl) {
     //
     // Alternatively, maybe it's sufficient to check that they're _equal_.
     // It's not a bug at all to import it twice if it has no effect.
-    LOG_IF(INFO, !it->second.has_value())
+    LOG_IF(INFO, it->second == nullptr)
         << "re-entrant import discovered, where the re-entrant import had a "
            "non-null value."
         << "\n  trying to import a " << decl->getDeclKindName()
@@ -562,12 +717,13 @@ std::optional<IR::Item> Importer::ImportDecl(clang::Decl* decl) {
   return std::nullopt;
 }
 
-std::optional<IR::Item> Importer::GetImportedItem(const clang::Decl* decl) {
+const IR::Item* Importer::GetImportedItem(const clang::Decl* decl) {
+  CHECK(!items_moved_to_ir_) << "Decls can't be looked up after Import()";
   auto it = import_cache_.find(decl);
   if (it != import_cache_.end()) {
     return it->second;
   }
-  return std::nullopt;
+  return nullptr;
 }
 
 BazelLabel Importer::GetOwningTarget(const clang::Decl* decl) const {
@@ -577,10 +733,14 @@ BazelLabel Importer::GetOwningTarget(const clang::Decl* decl) const {
     return invocation_.target_;
   }
 
-  clang::SourceManager& source_manager = ctx_.getSourceManager();
-  auto source_location = decl->getLocation();
+  return GetOwningTargetOfLocation(invocation_, ctx_.getSourceManager(),
+                                   decl->getLocation());
+}
 
-  // If the header this decl comes from is not associated with a target we
+BazelLabel GetOwningTargetOfLocation(
+    const Invocation& invocation, const clang::SourceManager& source_manager,
+    clang::SourceLocation source_location) {
+  // If the header this location comes from is not associated with a target we
   // consider it a textual header. In that case we go up the include stack
   // until we find a header that has an owning target.
 
@@ -598,7 +758,7 @@ BazelLabel Importer::GetOwningTarget(const clang::Decl* decl) const {
       filename = filename->substr(2);
     }
 
-    if (auto target = invocation_.header_target(HeaderName(filename->str()))) {
+    if (auto target = invocation.header_target(HeaderName(filename->str()))) {
       return *target;
     }
     source_location = source_manager.getIncludeLoc(id);
@@ -621,7 +781,7 @@ IR::Item Importer::ImportUnsupportedItem(const clang::Decl* decl,
   return UnsupportedItem{.name = name,
                          .message = error,
                          .source_loc = source_loc,
-                         .id = GenerateItemId(decl)};
+                         .id = GetItemId(decl)};
 }
 
 IR::Item Importer::ImportUnsupportedItem(const clang::Decl* decl,
@@ -664,7 +824,6 @@ std::string Importer::ConvertSourceLocation(clang::SourceLocation loc) const {
   // For macros: https://clang.llvm.org/doxygen/SourceManager_8h.html:
   // Spelling location: where the macro is originally defined.
   // Expansion location: where the macro is expanded.
-  const clang::SourceLocation& spelling_loc = sm.getSpellingLoc(loc);
   // TODO(b/261185414): The "google3" prefix should probably come from a command
   // line argument.
   // TODO(b/261185414): Consider linking to the symbol instead of to the line
@@ -677,30 +836,26 @@ std::string Importer::ConvertSourceLocation(clang::SourceLocation loc) const {
       };
   constexpr absl::string_view kSourceLocUnknown = "<unknown location>";
   std::string spelling_loc_str;
-  if (absl::string_view spelling_filename = sm.getFilename(spelling_loc);
+  auto [spelling_file, spelling_offset] = sm.getDecomposedSpellingLoc(loc);
+  if (absl::string_view spelling_filename = GetSourcePath(spelling_file);
       spelling_filename.empty()) {
     spelling_loc_str = kSourceLocUnknown;
   } else {
-    uint32_t spelling_line = sm.getSpellingLineNumber(loc);
-    if (absl::StartsWith(spelling_filename, "./")) {
-      spelling_filename = spelling_filename.substr(2);
-    }
+    uint32_t spelling_line = sm.getLineNumber(spelling_file, spelling_offset);
     spelling_loc_str =
         kSourceLocationFunc(kGeneratedFrom, spelling_filename, spelling_line);
   }
   if (!loc.isMacroID()) {
     return spelling_loc_str;
   }
-  const clang::SourceLocation& expansion_loc = sm.getExpansionLoc(loc);
+  auto [expansion_file, expansion_offset] = sm.getDecomposedExpansionLoc(loc);
   std::string expansion_loc_str;
-  if (absl::string_view expansion_filename = sm.getFilename(expansion_loc);
+  if (absl::string_view expansion_filename = GetSourcePath(expansion_file);
       expansion_filename.empty()) {
     expansion_loc_str = kSourceLocUnknown;
   } else {
-    uint32_t expansion_line = sm.getExpansionLineNumber(loc);
-    if (absl::StartsWith(expansion_filename, "./")) {
-      expansion_filename = expansion_filename.substr(2);
-    }
+    uint32_t expansion_line =
+        sm.getLineNumber(expansion_file, expansion_offset);
     expansion_loc_str =
         kSourceLocationFunc(kExpandedAt, expansion_filename, expansion_line);
   }
@@ -709,6 +864,12 @@ std::string Importer::ConvertSourceLocation(clang::SourceLocation loc) const {
 
 absl::StatusOr<MappedType> Importer::ConvertTemplateSpecializationType(
     const clang::TemplateSpecializationType* type) {
+  if (std::optional<MappedType> span_type =
+          ConvertContiguousStorageType(type, ContiguousStorageType::kSpan);
+      span_type.has_value()) {
+    return *std::move(span_type);
+  }
+
   // Qualifiers are handled separately in TypeMapper::ConvertQualType().
   std::string type_string = clang::QualType(type, 0).getAsString();
 
@@ -752,17 +913,69 @@ absl::StatusOr<MappedType> Importer::ConvertTypeDecl(clang::NamedDecl* decl) {
         "No generated bindings found for '$0'", decl->getNameAsString()));
   }
 
-  ItemId decl_id = GenerateItemId(decl);
+  ItemId decl_id = GetItemId(decl);
   return MappedType::WithDeclId(decl_id);
 }
 
+std::optional<MappedType> Importer::ConvertContiguousStorageType(
+    const clang::Type* type, ContiguousStorageType::Kind kind) {
+  std::optional<ContiguousStorageType> storage =
+      GetContiguousStorageType(*type);
+  if (!storage.has_value() || storage->kind != kind) return std::nullopt;
+  clang::CXXRecordDecl* decl = type->getAsCXXRecordDecl();
+  bool has_layout = false;
+  switch (kind) {
+    case ContiguousStorageType::kSpan:
+    case ContiguousStorageType::kVector:
+      // Instantiates the type, like in `ConvertTemplateSpecializationType`, so
+      // that its layout can be checked.
+      (void)sema_.isCompleteType(decl->getLocation(),
+                                 ctx_.getRecordType(decl));
+      has_layout = kind == ContiguousStorageType::kSpan
+                       ? HasSpanLayout(*decl, storage->element_type, ctx_)
+                       : HasVectorLayout(*decl, storage->element_type, ctx_);
+      break;
+    case ContiguousStorageType::kString:
+      has_layout = HasStdStringLayout(*decl, sema_);
+      break;
+  }
+  if (!has_layout) return std::nullopt;
+
+  // The elements of spans and vectors don't have lifetimes.
+  std::optional<clang::tidy::lifetimes::ValueLifetimes> no_lifetimes;
+  absl::StatusOr<MappedType> element_type =
+      ConvertQualType(storage->element_type.getUnqualifiedType(), no_lifetimes,
+                      /*ref_qualifier_kind=*/std::nullopt);
+  // Otherwise, `type` is imported like other class template specializations.
+  if (!element_type.ok()) return std::nullopt;
+
+  std::string rs_name;
+  std::vector<RsType> rs_type_args = {std::move(element_type->rs_type)};
+  switch (kind) {
+    case ContiguousStorageType::kSpan:
+      rs_name = storage->element_type.isConstQualified() ? "::cc_std::Span"
+                                                         : "::cc_std::SpanMut";
+      break;
+    case ContiguousStorageType::kVector:
+      rs_name = "::cc_std::Vector";
+      break;
+    case ContiguousStorageType::kString:
+      rs_name = "::cc_std::StdString";
+      rs_type_args.clear();
+      break;
+  }
+  return MappedType{
+      .rs_type = RsType{.name = std::move(rs_name),
+                        .type_args = std::move(rs_type_args)},
+      .cc_type = CcType{.name = std::move(storage->cc_name)},
+  };
+}
+
 absl::StatusOr<MappedType> Importer::ConvertType(
     const clang::Type* type,
     std::optional<clang::tidy::lifetimes::ValueLifetimes>& lifetimes,
     std::optional<clang::RefQualifierKind> ref_qualifier_kind, bool nullable) {
   // Qualifiers are handled separately in ConvertQualType().
-  std::string type_string = clang::QualType(type, 0).getAsString();
-
   if (auto override_type = GetTypeMapOverride(*type);
       override_type.has_value()) {
     return *std::move(override_type);
@@ -812,14 +1025,27 @@ absl::StatusOr<MappedType> Importer::ConvertType(
       }
     }
 
-    CRUBIT_ASSIGN_OR_RETURN(
-        MappedType mapped_pointee_type,
-        ConvertQualType(pointee_type, lifetimes, ref_qualifier_kind));
+    // Vectors and strings are only mapped behind pointers and references,
+    // because Rust code can't destroy them.
+    std::optional<MappedType> mapped_pointee_type =
+        ConvertContiguousStorageType(pointee_type.getTypePtr(),
+                                     ContiguousStorageType::kVector);
+    if (!mapped_pointee_type.has_value()) {
+      mapped_pointee_type = ConvertContiguousStorageType(
+          pointee_type.getTypePtr(), ContiguousStorageType::kString);
+    }
+    if (mapped_pointee_type.has_value()) {
+      mapped_pointee_type->cc_type.is_const = pointee_type.isConstQualified();
+    } else {
+      CRUBIT_ASSIGN_OR_RETURN(
+          mapped_pointee_type,
+          ConvertQualType(pointee_type, lifetimes, ref_qualifier_kind));
+    }
     if (type->isPointerType()) {
-      return MappedType::PointerTo(std::move(mapped_pointee_type), lifetime,
+      return MappedType::PointerTo(*std::move(mapped_pointee_type), lifetime,
                                    ref_qualifier_kind, nullable);
     } else if (type->isLValueReferenceType()) {
-      return MappedType::LValueReferenceTo(std::move(mapped_pointee_type),
+      return MappedType::LValueReferenceTo(*std::move(mapped_pointee_type),
                                            lifetime);
     } else {
       CHECK(type->isRValueReferenceType());
@@ -827,7 +1053,7 @@ absl::StatusOr<MappedType> Importer::ConvertType(
         return absl::UnimplementedError(
             "Unsupported type: && without lifetime");
       }
-      return MappedType::RValueReferenceTo(std::move(mapped_pointee_type),
+      return MappedType::RValueReferenceTo(*std::move(mapped_pointee_type),
                                            *lifetime);
     }
   } else if (const auto* builtin_type =
@@ -885,6 +1111,11 @@ absl::StatusOr<MappedType> Importer::ConvertType(
         return absl::UnimplementedError("Unsupported builtin type");
     }
   } else if (const auto* tag_type = type->getAsAdjusted<clang::TagType>()) {
+    if (std::optional<MappedType> span_type =
+            ConvertContiguousStorageType(type, ContiguousStorageType::kSpan);
+        span_type.has_value()) {
+      return *std::move(span_type);
+    }
     return ConvertTypeDecl(tag_type->getDecl());
   } else if (const auto* typedef_type =
                  type->getAsAdjusted<clang::TypedefType>()) {
@@ -933,10 +1164,26 @@ absl::StatusOr<MappedType> Importer::ConvertQualType(
     std::optional<clang::tidy::lifetimes::ValueLifetimes>& lifetimes,
     std::optional<clang::RefQualifierKind> ref_qualifier_kind, bool nullable) {
   qual_type = GetUnelaboratedType(std::move(qual_type), ctx_);
-  std::string type_string = qual_type.getAsString();
+
+  // Only pointers and references use (and consume) `lifetimes`, so the
+  // conversion of other types, and of pointers and references without
+  // lifetimes, is cached. The cache is keyed by the sugared type, because
+  // type aliases are converted differently from the types they alias.
+  bool cacheable =
+      !lifetimes.has_value() ||
+      !(qual_type->isPointerType() || qual_type->isReferenceType());
+  TypeCacheKey cache_key = {qual_type.getAsOpaquePtr(), ref_qualifier_kind,
+                            nullable};
+  if (cacheable) {
+    if (auto it = type_cache_.find(cache_key); it != type_cache_.end()) {
+      return it->second;
+    }
+  }
+
   absl::StatusOr<MappedType> type = ConvertType(
       qual_type.getTypePtr(), lifetimes, ref_qualifier_kind, nullable);
   if (!type.ok()) {
+    std::string type_string = qual_type.getAsString();
     absl::Status error = absl::UnimplementedError(absl::Substitute(
         "Unsupported type '$0': $1", type_string, type.status().message()));
     error.SetPayload(kTypeStatusPayloadUrl, absl::Cord(type_string));
@@ -946,14 +1193,61 @@ absl::StatusOr<MappedType> Importer::ConvertQualType(
   // Handle cv-qualification.
   type->cc_type.is_const = qual_type.isConstQualified();
   if (qual_type.isVolatileQualified()) {
-    return absl::UnimplementedError(
-        absl::StrCat("Unsupported `volatile` qualifier: ", type_string));
+    return absl::UnimplementedError(absl::StrCat(
+        "Unsupported `volatile` qualifier: ", qual_type.getAsString()));
   }
 
+  // Errors aren't cached: e.g. the decl of a type may fail to import while it
+  // is still being imported.
+  if (cacheable) type_cache_.try_emplace(cache_key, *type);
   return type;
 }
 
+absl::string_view Importer::GetSourcePath(clang::FileID file_id) const {
+  auto [it, inserted] = source_paths_.try_emplace(file_id);
+  if (inserted) {
+    const clang::SourceManager& sm = ctx_.getSourceManager();
+    // The name is owned by the FileManager, which outlives the importer.
+    absl::string_view path = sm.getFilename(sm.getLocForStartOfFile(file_id));
+    if (absl::StartsWith(path, "./")) {
+      path = path.substr(2);
+    }
+    it->second = path;
+  }
+  return it->second;
+}
+
 std::string Importer::GetMangledName(const clang::NamedDecl* named_decl) const {
+  if (auto it = mangled_names_.find(named_decl); it != mangled_names_.end()) {
+    return it->second;
+  }
+  std::string name = MangleName(named_decl);
+  mangled_names_.try_emplace(named_decl, name);
+  return name;
+}
+
+ItemId Importer::GetItemId(const clang::Decl* decl) const {
+  // All redeclarations but namespaces share their ID, so they share an entry.
+  if (!clang::isa<clang::NamespaceDecl>(decl)) {
+    decl = decl->getCanonicalDecl();
+  }
+  auto [it, inserted] = item_ids_.try_emplace(decl);
+  if (inserted) {
+    it->second = GenerateItemId(decl);
+  }
+  return it->second;
+}
+
+std::optional<ItemId> Importer::GetEnclosingNamespaceId(
+    const clang::Decl* decl) const {
+  if (const clang::NamespaceDecl* namespace_decl =
+          GetEnclosingNamespace(decl)) {
+    return GetItemId(namespace_decl);
+  }
+  return std::nullopt;
+}
+
+std::string Importer::MangleName(const clang::NamedDecl* named_decl) const {
   if (auto record_decl = clang::dyn_cast<clang::RecordDecl>(named_decl)) {
     // Mangled record names are used to 1) provide valid Rust identifiers for
     // C++ template specializations, and 2) help build unique names for virtual
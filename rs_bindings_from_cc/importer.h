@@ -9,10 +9,13 @@
 #include <optional>
 #include <set>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/die_if_null.h"
+#include "absl/strings/string_view.h"
 #include "common/status_macros.h"
 #include "rs_bindings_from_cc/decl_importer.h"
 #include "rs_bindings_from_cc/importers/class_template.h"
@@ -25,8 +28,12 @@
 #include "rs_bindings_from_cc/importers/type_alias.h"
 #include "rs_bindings_from_cc/importers/type_map_override.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/type_map.h"
 #include "clang/AST/Mangle.h"
 #include "clang/AST/RawCommentList.h"
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/SourceManager.h"
+#include "llvm/ADT/DenseMap.h"
 
 namespace crubit {
 
@@ -64,9 +71,12 @@ class Importer final : public ImportContext {
   IR::Item ImportUnsupportedItem(const clang::Decl* decl,
                                  std::set<std::string> errors) override;
   std::optional<IR::Item> ImportDecl(clang::Decl* decl) override;
-  std::optional<IR::Item> GetImportedItem(const clang::Decl* decl) override;
+  const IR::Item* GetImportedItem(const clang::Decl* decl) override;
   std::vector<ItemId> GetItemIdsInSourceOrder(clang::Decl* decl) override;
   std::string GetMangledName(const clang::NamedDecl* named_decl) const override;
+  ItemId GetItemId(const clang::Decl* decl) const override;
+  std::optional<ItemId> GetEnclosingNamespaceId(
+      const clang::Decl* decl) const override;
   BazelLabel GetOwningTarget(const clang::Decl* decl) const override;
   bool IsFromCurrentTarget(const clang::Decl* decl) const override;
   absl::StatusOr<UnqualifiedIdentifier> GetTranslatedName(
@@ -108,6 +118,18 @@ class Importer final : public ImportContext {
   // ordering Items.
   SourceOrderKey GetSourceOrderKey(const clang::RawComment* comment) const;
 
+  // Sorts `items` by their SourceOrderKey.
+  template <typename T>
+  void SortInSourceOrder(
+      std::vector<std::pair<SourceOrderKey, T>>& items) const;
+
+  // Mangles the name of `named_decl`. Use the cached GetMangledName instead.
+  std::string MangleName(const clang::NamedDecl* named_decl) const;
+
+  // Returns the path of a file as shown in source locations, or an empty
+  // string if `file_id` isn't a file. Cached per file.
+  absl::string_view GetSourcePath(clang::FileID file_id) const;
+
   // Returns a name for `decl` that should be used for ordering declarations.
   std::string GetNameForSourceOrder(const clang::Decl* decl) const;
 
@@ -116,7 +138,7 @@ class Importer final : public ImportContext {
   // deterministic/reproducible order.
   std::vector<ItemId> GetOrderedItemIdsOfTemplateInstantiations() const;
 
-  std::optional<IR::Item> GetDeclItem(clang::Decl* decl) override;
+  const IR::Item* GetDeclItem(clang::Decl* decl) override;
   // Stores the comments of this target in source order.
   void ImportFreeComments();
 
@@ -132,6 +154,12 @@ class Importer final : public ImportContext {
       std::optional<clang::RefQualifierKind> ref_qualifier_kind, bool nullable);
   absl::StatusOr<MappedType> ConvertTypeDecl(clang::NamedDecl* decl);
 
+  // Converts `type` into the generic Rust type of `cc_std` which mirrors its
+  // layout, if it is a contiguous storage type of the given `kind` (see
+  // `GetContiguousStorageType`) whose elements have bindings.
+  std::optional<MappedType> ConvertContiguousStorageType(
+      const clang::Type* type, ContiguousStorageType::Kind kind);
+
   // Converts `type` into a MappedType, after first importing the Record behind
   // the template instantiation.
   absl::StatusOr<MappedType> ConvertTemplateSpecializationType(
@@ -141,8 +169,23 @@ class Importer final : public ImportContext {
   // to successfully match a decl "wins", and no other importers are tried.
   std::vector<std::unique_ptr<DeclImporter>> decl_importers_;
   std::unique_ptr<clang::MangleContext> mangler_;
-  absl::flat_hash_map<const clang::Decl*, std::optional<IR::Item>>
-      import_cache_;
+  // Caches of GetMangledName, GetItemId and GetSourcePath, which are called
+  // many times for the same decls and files.
+  mutable absl::flat_hash_map<const clang::NamedDecl*, std::string>
+      mangled_names_;
+  mutable absl::flat_hash_map<const clang::Decl*, ItemId> item_ids_;
+  mutable llvm::DenseMap<clang::FileID, absl::string_view> source_paths_;
+  // The converted types, keyed by the (opaque) QualType, ref-qualifier, and
+  // nullability. See ConvertQualType.
+  using TypeCacheKey =
+      std::tuple<void*, std::optional<clang::RefQualifierKind>, bool>;
+  absl::flat_hash_map<TypeCacheKey, MappedType> type_cache_;
+  // The items of the decls which have been imported (or null, if they aren't
+  // imported), in `invocation_.item_arena_`.
+  absl::flat_hash_map<const clang::Decl*, IR::Item*> import_cache_;
+  // Whether `Import` moved the imported items into `invocation_.ir_`, after
+  // which the import cache is empty and must not be used.
+  bool items_moved_to_ir_ = false;
   absl::flat_hash_set<const clang::ClassTemplateSpecializationDecl*>
       class_template_instantiations_;
   std::vector<const clang::RawComment*> comments_;
@@ -155,6 +198,13 @@ class Importer final : public ImportContext {
   absl::flat_hash_set<const clang::NamedDecl*> known_type_decls_;
 };  // class Importer
 
+// Returns the target that owns the header in which `source_location` is
+// expanded. Textual headers are owned by the target of the header that includes
+// them.
+BazelLabel GetOwningTargetOfLocation(
+    const Invocation& invocation, const clang::SourceManager& source_manager,
+    clang::SourceLocation source_location);
+
 }  // namespace crubit
 
 #endif  // CRUBIT_RS_BINDINGS_FROM_CC_IMPORTER_H_
@@ -2,6 +2,7 @@
 // Exceptions. See /LICENSE for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <cstdlib>
 #include <optional>
 #include <string>
 #include <type_traits>
@@ -10,10 +11,13 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "common/file_io.h"
 #include "common/status_test_matchers.h"
 #include "common/test_utils.h"
 #include "rs_bindings_from_cc/bazel_types.h"
@@ -28,6 +32,7 @@ using ::testing::AnyOf;
 using ::testing::Contains;
 using ::testing::Each;
 using ::testing::ElementsAre;
+using ::testing::HasSubstr;
 using ::testing::IsEmpty;
 using ::testing::Not;
 using ::testing::Pointee;
@@ -119,6 +124,11 @@ auto ParamsAre(const Args&... matchers) {
 // Matches a Func that is inline.
 MATCHER(IsInline, "") { return arg.is_inline; }
 
+// Matches a Func that is a trivial field accessor.
+MATCHER(IsTrivialFieldAccessor, "") {
+  return arg.trivial_field_accessor.has_value();
+}
+
 // Matches a FuncParam with a type that matches all given matchers.
 template <typename... Args>
 auto ParamType(const Args&... matchers) {
@@ -354,6 +364,163 @@ TEST(ImporterTest, TwoFuncsFromTwoHeaders) {
                                    VariantWith<Func>(IdentifierIs("Bar"))));
 }
 
+TEST(ImporterTest, PrecompiledDependencyHeader) {
+  absl::flat_hash_map<const HeaderName, const std::string> virtual_headers = {
+      {HeaderName("test/dep.h"), "struct Dep { int x; };"},
+      {HeaderName("test/user.h"), "#include \"test/dep.h\"\nvoid Use(Dep);"}};
+  std::string precompiled_header =
+      absl::StrCat(testing::TempDir(), "/precompiled_dependency_header.pch");
+  std::vector<HeaderName> dep_headers = {HeaderName("test/dep.h")};
+  ASSERT_OK(PrecompileHeaders(
+      {.public_headers = dep_headers,
+       .virtual_headers_contents_for_testing = virtual_headers},
+      precompiled_header));
+
+  std::vector<HeaderName> user_headers = {HeaderName("test/user.h")};
+  ASSERT_OK_AND_ASSIGN(
+      IR ir,
+      IrFromCc({.current_target = BazelLabel{"//test:user"},
+                .public_headers = user_headers,
+                .virtual_headers_contents_for_testing = virtual_headers,
+                .headers_to_targets =
+                    {{HeaderName("test/dep.h"), BazelLabel{"//test:dep"}},
+                     {HeaderName("test/user.h"), BazelLabel{"//test:user"}}},
+                .precompiled_header = precompiled_header}));
+  EXPECT_THAT(ItemsWithoutBuiltins(ir),
+              AllOf(Contains(VariantWith<Func>(IdentifierIs("Use"))),
+                    Contains(VariantWith<Record>(RsNameIs("Dep")))));
+
+  // A precompiled header built for other macros is rejected, rather than
+  // silently used.
+  std::vector<absl::string_view> other_clang_args = {"-DOTHER_CONFIG"};
+  EXPECT_THAT(
+      IrFromCc({.current_target = BazelLabel{"//test:user"},
+                .public_headers = user_headers,
+                .virtual_headers_contents_for_testing = virtual_headers,
+                .headers_to_targets =
+                    {{HeaderName("test/dep.h"), BazelLabel{"//test:dep"}},
+                     {HeaderName("test/user.h"), BazelLabel{"//test:user"}}},
+                .clang_args = other_clang_args,
+                .precompiled_header = precompiled_header}),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("different Clang arguments")));
+}
+
+TEST(ImporterTest, PrecompiledHeaderWithOtherIncludePaths) {
+  // Every target has its own include paths, which don't have to match the
+  // ones the precompiled header was built with.
+  absl::flat_hash_map<const HeaderName, const std::string> virtual_headers = {
+      {HeaderName("test/dep.h"), "struct Dep { int x; };"},
+      {HeaderName("test/user.h"), "#include \"test/dep.h\"\nvoid Use(Dep);"}};
+  std::string precompiled_header = absl::StrCat(
+      testing::TempDir(), "/precompiled_header_with_include_paths.pch");
+  std::vector<HeaderName> dep_headers = {HeaderName("test/dep.h")};
+  std::vector<absl::string_view> dep_clang_args = {"-Idep_include",
+                                                   "-isystem", "dep_system"};
+  ASSERT_OK(PrecompileHeaders(
+      {.public_headers = dep_headers,
+       .virtual_headers_contents_for_testing = virtual_headers,
+       .clang_args = dep_clang_args},
+      precompiled_header));
+
+  std::vector<HeaderName> user_headers = {HeaderName("test/user.h")};
+  std::vector<absl::string_view> user_clang_args = {
+      "-Iuser_include", "-iquote", "user_quote", "-isystem", "user_system"};
+  ASSERT_OK_AND_ASSIGN(
+      IR ir,
+      IrFromCc({.current_target = BazelLabel{"//test:user"},
+                .public_headers = user_headers,
+                .virtual_headers_contents_for_testing = virtual_headers,
+                .headers_to_targets =
+                    {{HeaderName("test/dep.h"), BazelLabel{"//test:dep"}},
+                     {HeaderName("test/user.h"), BazelLabel{"//test:user"}}},
+                .clang_args = user_clang_args,
+                .precompiled_header = precompiled_header}));
+  EXPECT_THAT(ItemsWithoutBuiltins(ir),
+              AllOf(Contains(VariantWith<Func>(IdentifierIs("Use"))),
+                    Contains(VariantWith<Record>(RsNameIs("Dep")))));
+}
+
+TEST(ImporterTest, EmptyPrecompiledHeaderIsIgnored) {
+  // `--do_nothing` writes an empty file in place of the precompiled header.
+  absl::flat_hash_map<const HeaderName, const std::string> virtual_headers = {
+      {HeaderName("test/dep.h"), "struct Dep { int x; };"},
+      {HeaderName("test/user.h"), "#include \"test/dep.h\"\nvoid Use(Dep);"}};
+  std::string precompiled_header =
+      absl::StrCat(testing::TempDir(), "/empty_precompiled_header.pch");
+  ASSERT_OK(SetFileContents(precompiled_header, ""));
+
+  std::vector<HeaderName> user_headers = {HeaderName("test/user.h")};
+  ASSERT_OK_AND_ASSIGN(
+      IR ir,
+      IrFromCc({.current_target = BazelLabel{"//test:user"},
+                .public_headers = user_headers,
+                .virtual_headers_contents_for_testing = virtual_headers,
+                .headers_to_targets =
+                    {{HeaderName("test/dep.h"), BazelLabel{"//test:dep"}},
+                     {HeaderName("test/user.h"), BazelLabel{"//test:user"}}},
+                .precompiled_header = precompiled_header}));
+  EXPECT_THAT(ItemsWithoutBuiltins(ir),
+              AllOf(Contains(VariantWith<Func>(IdentifierIs("Use"))),
+                    Contains(VariantWith<Record>(RsNameIs("Dep")))));
+}
+
+TEST(ImporterTest, SkipDependencyFunctionBodies) {
+  // The body of `Dep` doesn't compile, so the import only succeeds if it isn't
+  // parsed.
+  absl::flat_hash_map<const HeaderName, const std::string> virtual_headers = {
+      {HeaderName("test/dep.h"), "inline int Dep() { return undeclared; }"},
+      {HeaderName("test/user.h"),
+       "#include \"test/dep.h\"\n"
+       "struct User { int x() const { return x_; } int x_; };"}};
+  std::vector<HeaderName> user_headers = {HeaderName("test/user.h")};
+  ASSERT_OK_AND_ASSIGN(
+      IR ir,
+      IrFromCc({.current_target = BazelLabel{"//test:user"},
+                .public_headers = user_headers,
+                .virtual_headers_contents_for_testing = virtual_headers,
+                .headers_to_targets =
+                    {{HeaderName("test/dep.h"), BazelLabel{"//test:dep"}},
+                     {HeaderName("test/user.h"), BazelLabel{"//test:user"}}},
+                .skip_dependency_function_bodies = true}));
+  // The bodies of the current target are still parsed.
+  EXPECT_THAT(ItemsWithoutBuiltins(ir),
+              Contains(VariantWith<Func>(
+                  AllOf(IdentifierIs("x"), IsTrivialFieldAccessor()))));
+}
+
+TEST(ImporterTest, ItemIdsAreDeterministic) {
+  absl::string_view header = R"cc(
+    // Comment about the namespace.
+    namespace ns {
+    struct S {
+      int field;
+    };
+    }  // namespace ns
+    namespace ns {
+    void Foo(ns::S s);
+    }  // namespace ns
+  )cc";
+  // Imports the header in another process (a re-execution of this test, with
+  // its own heap addresses and hash seeds), which writes the IR to a file.
+  std::string other_process_ir_path =
+      absl::StrCat(testing::TempDir(), "/item_ids_are_deterministic.json");
+  GTEST_FLAG_SET(death_test_style, "threadsafe");
+  EXPECT_EXIT(
+      {
+        absl::StatusOr<IR> ir = IrFromCc({header});
+        bool ok = ir.ok() &&
+                  SetFileContents(other_process_ir_path, IrToJson(*ir)).ok();
+        std::exit(ok ? 0 : 1);
+      },
+      testing::ExitedWithCode(0), "");
+
+  ASSERT_OK_AND_ASSIGN(IR ir, IrFromCc({header}));
+  ASSERT_OK_AND_ASSIGN(std::string other_process_ir,
+                       GetFileContents(other_process_ir_path));
+  EXPECT_EQ(IrToJson(ir), other_process_ir);
+}
+
 TEST(ImporterTest, NonInlineFunc) {
   ASSERT_OK_AND_ASSIGN(IR ir, IrFromCc({"void Foo() {}"}));
   EXPECT_THAT(ItemsWithoutBuiltins(ir),
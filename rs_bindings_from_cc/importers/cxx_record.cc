@@ -12,16 +12,21 @@
 #include "absl/log/check.h"
 #include "absl/log/die_if_null.h"
 #include "absl/log/log.h"
+#include "absl/status/statusor.h"
 #include "rs_bindings_from_cc/ast_convert.h"
+#include "rs_bindings_from_cc/ast_util.h"
 #include "rs_bindings_from_cc/bazel_types.h"
 #include "clang/AST/ASTContext.h"
+#include "clang/AST/Attr.h"
 #include "clang/AST/CXXInheritance.h"
 #include "clang/AST/Decl.h"
 #include "clang/AST/PrettyPrinter.h"
 #include "clang/AST/RecordLayout.h"
 #include "clang/AST/Type.h"
+#include "clang/AST/VTableBuilder.h"
 #include "clang/Basic/Specifiers.h"
 #include "clang/Sema/Sema.h"
+#include "llvm/Support/Casting.h"
 #include "llvm/Support/ErrorHandling.h"
 namespace crubit {
 
@@ -67,6 +72,15 @@ std::string GetClassTemplateSpecializationCcName(
       .getAsString(policy);
 }
 
+// Returns whether the types of the non-public fields of `record_decl` should
+// be imported, as requested by `CRUBIT_INTERNAL_IMPORT_PRIVATE_FIELDS`.
+// Repeating the attribute is harmless.
+bool ImportsPrivateFields(const clang::CXXRecordDecl* record_decl) {
+  absl::StatusOr<const clang::AnnotateAttr*> attr =
+      GetAnnotateAttr(record_decl, "crubit_internal_import_private_fields");
+  return !attr.ok() || *attr != nullptr;
+}
+
 AccessSpecifier TranslateAccessSpecifier(clang::AccessSpecifier access) {
   switch (access) {
     case clang::AS_public:
@@ -269,10 +283,10 @@ std::optional<IR::Item> CXXRecordDeclImporter::Import(
     return IncompleteRecord{
         .cc_name = std::move(cc_name),
         .rs_name = std::move(rs_name),
-        .id = GenerateItemId(record_decl),
+        .id = ictx_.GetItemId(record_decl),
         .owning_target = ictx_.GetOwningTarget(record_decl),
         .record_type = *record_type,
-        .enclosing_namespace_id = GetEnclosingNamespaceId(record_decl)};
+        .enclosing_namespace_id = ictx_.GetEnclosingNamespaceId(record_decl)};
   }
 
   // At this point we know that the import of `record_decl` will succeed /
@@ -298,7 +312,7 @@ std::optional<IR::Item> CXXRecordDeclImporter::Import(
       .rs_name = std::move(rs_name),
       .cc_name = std::move(cc_name),
       .mangled_cc_name = ictx_.GetMangledName(record_decl),
-      .id = GenerateItemId(record_decl),
+      .id = ictx_.GetItemId(record_decl),
       .owning_target = ictx_.GetOwningTarget(record_decl),
       .defining_target = std::move(defining_target),
       .doc_comment = std::move(doc_comment),
@@ -324,7 +338,7 @@ std::optional<IR::Item> CXXRecordDeclImporter::Import(
       .is_explicit_class_template_instantiation_definition =
           is_explicit_class_template_instantiation_definition,
       .child_item_ids = std::move(item_ids),
-      .enclosing_namespace_id = GetEnclosingNamespaceId(record_decl),
+      .enclosing_namespace_id = ictx_.GetEnclosingNamespaceId(record_decl),
   };
 
   // If the align attribute was attached to the typedef decl, we should
@@ -369,6 +383,7 @@ std::vector<Field> CXXRecordDeclImporter::ImportFields(
   std::vector<Field> fields;
   const clang::ASTRecordLayout& layout =
       ictx_.ctx_.getASTRecordLayout(record_decl);
+  bool imports_private_fields = ImportsPrivateFields(record_decl);
   for (const clang::FieldDecl* field_decl : record_decl->fields()) {
     clang::AccessSpecifier access = field_decl->getAccess();
     if (access == clang::AS_none) {
@@ -387,6 +402,13 @@ std::vector<Field> CXXRecordDeclImporter::ImportFields(
       case clang::AS_protected:
       case clang::AS_private:
       case clang::AS_none:
+        // The field stays private in Rust, but its type lets inline accessors
+        // be reimplemented in Rust (see `TrivialFieldAccessor`).
+        if (imports_private_fields) {
+          type = ictx_.ConvertQualType(field_decl->getType(), no_lifetimes,
+                                       std::nullopt);
+          break;
+        }
         // As a performance optimization (i.e. to keep the generated code
         // small) we can emit private fields as opaque blobs of bytes.  This
         // may avoid the need to include supporting types in the generated
@@ -402,9 +424,9 @@ std::vector<Field> CXXRecordDeclImporter::ImportFields(
     if (field_record) {
       // If it is a record as a direct member, its item must be already
       // imported.
-      auto item = ictx_.GetImportedItem(field_record);
-      if (item.has_value()) {
-        if (const auto* record = std::get_if<Record>(&item.value())) {
+      const IR::Item* item = ictx_.GetImportedItem(field_record);
+      if (item != nullptr) {
+        if (const auto* record = std::get_if<Record>(item)) {
           is_inheritable = record->is_inheritable;
         }
       }
@@ -482,23 +504,37 @@ std::vector<BaseClass> CXXRecordDeclImporter::GetUnambiguousPublicBases(
         continue;
       }
 
-      std::optional<int64_t> offset = {0};
+      // The offset of the base class subobject within the nearest virtual
+      // base on the path, or within the derived class if there is none.
+      int64_t offset = 0;
+      const clang::CXXRecordDecl* vbase = nullptr;
       for (const clang::CXXBasePathElement& base_path_element : path) {
+        const clang::CXXRecordDecl* path_base = ABSL_DIE_IF_NULL(
+            base_path_element.Base->getType()->getAsCXXRecordDecl());
         if (base_path_element.Base->isVirtual()) {
-          offset.reset();
-          break;
+          vbase = path_base;
+          offset = 0;
+          continue;
         }
-        *offset +=
-            {ictx_.ctx_.getASTRecordLayout(base_path_element.Class)
-                 .getBaseClassOffset(ABSL_DIE_IF_NULL(
-                     base_path_element.Base->getType()->getAsCXXRecordDecl()))
-                 .getQuantity()};
+        offset += ictx_.ctx_.getASTRecordLayout(base_path_element.Class)
+                      .getBaseClassOffset(path_base)
+                      .getQuantity();
       }
-      CHECK((!offset.has_value() || *offset >= 0) &&
+      CHECK(offset >= 0 &&
             "Concrete base classes should have non-negative offsets.");
-      bases.push_back(
-          BaseClass{.base_record_id = GenerateItemId(base_record_decl),
-                    .offset = offset});
+      BaseClass base_class{.base_record_id = ictx_.GetItemId(base_record_decl)};
+      if (vbase == nullptr) {
+        base_class.offset = offset;
+      } else if (auto* vtable_context =
+                     llvm::dyn_cast<clang::ItaniumVTableContext>(
+                         ictx_.ctx_.getVTableContext())) {
+        base_class.virtual_base_offset = VirtualBaseOffset{
+            .vbase_offset_offset =
+                vtable_context->getVirtualBaseOffsetOffset(&record_decl, vbase)
+                    .getQuantity(),
+            .offset_in_vbase = offset};
+      }
+      bases.push_back(base_class);
       break;
     }
   }
@@ -62,12 +62,12 @@ std::optional<IR::Item> EnumDeclImporter::Import(clang::EnumDecl* enum_decl) {
 
   return Enum{
       .identifier = *enum_name,
-      .id = GenerateItemId(enum_decl),
+      .id = ictx_.GetItemId(enum_decl),
       .owning_target = ictx_.GetOwningTarget(enum_decl),
       .source_loc = ictx_.ConvertSourceLocation(enum_decl->getBeginLoc()),
       .underlying_type = *std::move(type),
       .enumerators = enumerators,
-      .enclosing_namespace_id = GetEnclosingNamespaceId(enum_decl),
+      .enclosing_namespace_id = ictx_.GetEnclosingNamespaceId(enum_decl),
   };
 }
 
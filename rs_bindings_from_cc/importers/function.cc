@@ -6,9 +6,11 @@
 
 #include <optional>
 
+#include "absl/status/statusor.h"
 #include "absl/strings/substitute.h"
 #include "lifetime_annotations/lifetime_error.h"
 #include "rs_bindings_from_cc/ast_util.h"
+#include "clang/AST/Attr.h"
 #include "clang/AST/Type.h"
 #include "clang/Sema/Sema.h"
 #include "llvm/ADT/StringRef.h"
@@ -27,6 +29,14 @@ static bool IsInStdNamespace(const clang::FunctionDecl* decl) {
   return false;
 }
 
+// Returns whether `decl` requests a batch thunk with
+// `CRUBIT_INTERNAL_BATCH_THUNK`. Repeating the attribute is harmless.
+static bool HasBatchThunk(const clang::FunctionDecl* decl) {
+  absl::StatusOr<const clang::AnnotateAttr*> attr =
+      GetAnnotateAttr(decl, "crubit_internal_batch_thunk");
+  return !attr.ok() || *attr != nullptr;
+}
+
 Identifier FunctionDeclImporter::GetTranslatedParamName(
     const clang::ParmVarDecl* param_decl) {
   int param_pos = param_decl->getFunctionScopeIndex();
@@ -43,6 +53,83 @@ Identifier FunctionDeclImporter::GetTranslatedParamName(
   return *name;
 }
 
+// Returns the field of `*this` that `expr` refers to, or null if `expr` is not
+// a plain (e.g. not a bit-field) member of the class of `method_decl`.
+static const clang::FieldDecl* GetThisField(
+    const clang::CXXMethodDecl* method_decl, const clang::Expr* expr) {
+  const auto* member_expr =
+      clang::dyn_cast<clang::MemberExpr>(expr->IgnoreParenImpCasts());
+  if (member_expr == nullptr || !member_expr->isArrow() ||
+      !clang::isa<clang::CXXThisExpr>(
+          member_expr->getBase()->IgnoreParenImpCasts())) {
+    return nullptr;
+  }
+  const auto* field_decl =
+      clang::dyn_cast<clang::FieldDecl>(member_expr->getMemberDecl());
+  if (field_decl == nullptr ||
+      field_decl->getParent() != method_decl->getParent() ||
+      field_decl->isBitField() || field_decl->getIdentifier() == nullptr ||
+      !field_decl->getType()->isScalarType()) {
+    return nullptr;
+  }
+  return field_decl;
+}
+
+std::optional<TrivialFieldAccessor>
+FunctionDeclImporter::GetTrivialFieldAccessor(
+    const clang::CXXMethodDecl* method_decl) {
+  if (!method_decl->isInstance() || method_decl->isVirtual() ||
+      !method_decl->isInlined() || method_decl->getIdentifier() == nullptr ||
+      method_decl->getRefQualifier() != clang::RQ_None ||
+      method_decl->getParent()->isUnion()) {
+    return std::nullopt;
+  }
+  const auto* body =
+      clang::dyn_cast_or_null<clang::CompoundStmt>(method_decl->getBody());
+  if (body == nullptr || body->size() != 1) return std::nullopt;
+  const clang::Stmt* stmt = body->body_front();
+  clang::ASTContext& ctx = ictx_.ctx_;
+
+  std::optional<TrivialFieldAccessor::Kind> kind;
+  const clang::FieldDecl* field_decl = nullptr;
+  if (const auto* return_stmt = clang::dyn_cast<clang::ReturnStmt>(stmt)) {
+    // `return field_;`
+    if (method_decl->getNumParams() != 0 ||
+        return_stmt->getRetValue() == nullptr) {
+      return std::nullopt;
+    }
+    field_decl = GetThisField(method_decl, return_stmt->getRetValue());
+    if (field_decl == nullptr ||
+        !ctx.hasSameUnqualifiedType(field_decl->getType(),
+                                    method_decl->getReturnType())) {
+      return std::nullopt;
+    }
+    kind = TrivialFieldAccessor::kGetter;
+  } else if (const auto* assign = clang::dyn_cast<clang::BinaryOperator>(stmt);
+             assign != nullptr && assign->getOpcode() == clang::BO_Assign) {
+    // `field_ = value;`
+    if (method_decl->getNumParams() != 1 || method_decl->isConst() ||
+        !method_decl->getReturnType()->isVoidType()) {
+      return std::nullopt;
+    }
+    const clang::ParmVarDecl* param = method_decl->getParamDecl(0);
+    const auto* rhs =
+        clang::dyn_cast<clang::DeclRefExpr>(assign->getRHS()->IgnoreImpCasts());
+    field_decl = GetThisField(method_decl, assign->getLHS());
+    if (field_decl == nullptr || rhs == nullptr || rhs->getDecl() != param ||
+        !ctx.hasSameUnqualifiedType(field_decl->getType(), param->getType())) {
+      return std::nullopt;
+    }
+    kind = TrivialFieldAccessor::kSetter;
+  } else {
+    return std::nullopt;
+  }
+
+  absl::StatusOr<Identifier> field = ictx_.GetTranslatedIdentifier(field_decl);
+  if (!field.ok()) return std::nullopt;
+  return TrivialFieldAccessor{.kind = *kind, .field = *std::move(field)};
+}
+
 std::optional<IR::Item> FunctionDeclImporter::Import(
     clang::FunctionDecl* function_decl) {
   if (!ictx_.IsFromCurrentTarget(function_decl)) return std::nullopt;
@@ -222,6 +309,7 @@ std::optional<IR::Item> FunctionDeclImporter::Import(
              });
 
   std::optional<MemberFuncMetadata> member_func_metadata;
+  std::optional<TrivialFieldAccessor> trivial_field_accessor;
   if (auto* method_decl =
           clang::dyn_cast<clang::CXXMethodDecl>(function_decl)) {
     std::optional<MemberFuncMetadata::InstanceMethodMetadata> instance_metadata;
@@ -242,12 +330,15 @@ std::optional<IR::Item> FunctionDeclImporter::Import(
           .reference = reference,
           .is_const = method_decl->isConst(),
           .is_virtual = method_decl->isVirtual(),
+          .is_final = method_decl->hasAttr<clang::FinalAttr>() ||
+                      method_decl->getParent()->isEffectivelyFinal(),
       };
     }
 
     member_func_metadata = MemberFuncMetadata{
-        .record_id = GenerateItemId(method_decl->getParent()),
+        .record_id = ictx_.GetItemId(method_decl->getParent()),
         .instance_method_metadata = instance_metadata};
+    trivial_field_accessor = GetTrivialFieldAccessor(method_decl);
   }
 
   if (!errors.empty()) {
@@ -299,8 +390,10 @@ std::optional<IR::Item> FunctionDeclImporter::Import(
       .is_member_or_descendant_of_class_template =
           is_member_or_descendant_of_class_template,
       .source_loc = ictx_.ConvertSourceLocation(function_decl->getBeginLoc()),
-      .id = GenerateItemId(function_decl),
-      .enclosing_namespace_id = GetEnclosingNamespaceId(function_decl),
+      .id = ictx_.GetItemId(function_decl),
+      .enclosing_namespace_id = ictx_.GetEnclosingNamespaceId(function_decl),
+      .trivial_field_accessor = std::move(trivial_field_accessor),
+      .has_batch_thunk = HasBatchThunk(function_decl),
   };
 }
 
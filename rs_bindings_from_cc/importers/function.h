@@ -20,6 +20,11 @@ class FunctionDeclImporter : public DeclImporterBase<clang::FunctionDecl> {
 
  private:
   Identifier GetTranslatedParamName(const clang::ParmVarDecl* param_decl);
+
+  // Returns the field accessed by `method_decl` if its body only returns a
+  // scalar field of `*this` or only assigns its parameter to one.
+  std::optional<TrivialFieldAccessor> GetTrivialFieldAccessor(
+      const clang::CXXMethodDecl* method_decl);
 };
 
 }  // namespace crubit
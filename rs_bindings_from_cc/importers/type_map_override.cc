@@ -11,6 +11,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "common/status_macros.h"
+#include "rs_bindings_from_cc/ast_util.h"
 #include "rs_bindings_from_cc/ir.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/Attr.h"
@@ -53,24 +54,6 @@ absl::StatusOr<absl::string_view> EvaluateAsStringLiteral(
   return {string_literal->getString()};
 }
 
-// Gets the requested attribute for `decl`.
-// `decl` must not be null.
-absl::StatusOr<const clang::AnnotateAttr*> GetAnnotateAttr(
-    const clang::Decl* decl, absl::string_view attribute) {
-  const clang::AnnotateAttr* found_attr = nullptr;
-  for (clang::AnnotateAttr* attr :
-       decl->specific_attrs<clang::AnnotateAttr>()) {
-    if (attr->getAnnotation() != llvm::StringRef(attribute)) continue;
-
-    if (found_attr != nullptr)
-      return absl::InvalidArgumentError(
-          absl::StrCat("Only one `", attribute,
-                       "` attribute may be placed on a declaration."));
-    found_attr = attr;
-  }
-  return found_attr;
-}
-
 // Gets the crubit_internal_rust_type attribute for `decl`.
 // `decl` must not be null.
 absl::StatusOr<std::optional<absl::string_view>> GetRustTypeAttribute(
@@ -145,7 +128,7 @@ std::optional<IR::Item> TypeMapOverrideImporter::Import(
       .owning_target = ictx_.GetOwningTarget(type_decl),
       .size_align = std::move(size_align),
       .is_same_abi = *is_same_abi,
-      .id = GenerateItemId(type_decl),
+      .id = ictx_.GetItemId(type_decl),
   };
 }
 
@@ -14,14 +14,89 @@
 #include <vector>
 
 #include "absl/log/check.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "common/strong_int.h"
 #include "rs_bindings_from_cc/bazel_types.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/DeclBase.h"
+#include "clang/AST/RawCommentList.h"
 #include "clang/AST/Type.h"
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Index/USRGeneration.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
 
 namespace crubit {
 
+namespace {
+
+// Returns an `ItemId` for the stable hash of `key`.
+//
+// The hash is truncated to 63 bits, so that the ID can be represented as a
+// non-negative JSON integer.
+ItemId ItemIdFromKey(llvm::StringRef key) {
+  return ItemId(llvm::xxHash64(key) & 0x7fff'ffff'ffff'ffff);
+}
+
+// Writes a description of `loc` that doesn't depend on the address at which
+// the source files happen to be loaded.
+void WriteLocation(llvm::raw_ostream& os, clang::SourceLocation loc,
+                   const clang::SourceManager& sm) {
+  if (loc.isInvalid()) {
+    os << "<invalid>";
+    return;
+  }
+  // Declarations expanded from the same macro invocation share their
+  // expansion location, but not their spelling location.
+  clang::SourceLocation expansion_loc = sm.getExpansionLoc(loc);
+  clang::SourceLocation spelling_loc = sm.getSpellingLoc(loc);
+  os << sm.getFilename(expansion_loc) << ":"
+     << sm.getFileOffset(expansion_loc) << ":"
+     << sm.getFilename(spelling_loc) << ":" << sm.getFileOffset(spelling_loc);
+}
+
+}  // namespace
+
+ItemId GenerateItemId(const clang::Decl* decl) {
+  if (!clang::isa<clang::NamespaceDecl>(decl)) {
+    decl = decl->getCanonicalDecl();
+  }
+  llvm::SmallString<128> key;
+  llvm::raw_svector_ostream os(key);
+  os << decl->getDeclKindName() << "@";
+  // `generateUSRForDecl` returns true (and may leave partial output) if the
+  // declaration doesn't have a USR, e.g. for friend declarations. The
+  // location alone then has to distinguish the declaration.
+  llvm::SmallString<128> usr;
+  if (!clang::index::generateUSRForDecl(decl, usr)) {
+    os << usr;
+  }
+  // Template instantiations have distinct USRs, but share the location of
+  // their template.
+  os << "@";
+  WriteLocation(os, decl->getLocation(),
+                decl->getASTContext().getSourceManager());
+  return ItemIdFromKey(key);
+}
+
+ItemId GenerateItemId(const clang::RawComment* comment,
+                      const clang::SourceManager& sm) {
+  llvm::SmallString<128> key;
+  llvm::raw_svector_ostream os(key);
+  os << "comment@";
+  WriteLocation(os, comment->getBeginLoc(), sm);
+  return ItemIdFromKey(key);
+}
+
+ItemId GenerateUseModItemId(absl::string_view path) {
+  return ItemIdFromKey(absl::StrCat("use_mod@", path));
+}
+
 template <class T>
 llvm::json::Value toJSON(const T& t) {
   return t.ToJson();
@@ -284,6 +359,7 @@ llvm::json::Value MemberFuncMetadata::InstanceMethodMetadata::ToJson() const {
       {"reference", reference_str},
       {"is_const", is_const},
       {"is_virtual", is_virtual},
+      {"is_final", is_final},
   };
 }
 
@@ -323,6 +399,23 @@ llvm::json::Value UseMod::ToJson() const {
   };
 }
 
+llvm::json::Value TrivialFieldAccessor::ToJson() const {
+  const char* kind_str = nullptr;
+  switch (kind) {
+    case kGetter:
+      kind_str = "Getter";
+      break;
+    case kSetter:
+      kind_str = "Setter";
+      break;
+  }
+
+  return llvm::json::Object{
+      {"kind", kind_str},
+      {"field", field},
+  };
+}
+
 llvm::json::Value Func::ToJson() const {
   llvm::json::Object func{
       {"name", name},
@@ -341,6 +434,8 @@ llvm::json::Value Func::ToJson() const {
       {"id", id},
       {"enclosing_namespace_id", enclosing_namespace_id},
       {"adl_enclosing_record", adl_enclosing_record},
+      {"trivial_field_accessor", trivial_field_accessor},
+      {"has_batch_thunk", has_batch_thunk},
   };
 
   return llvm::json::Object{
@@ -390,11 +485,22 @@ llvm::json::Value toJSON(const SpecialMemberFunc& f) {
   }
 }
 
-llvm::json::Value BaseClass::ToJson() const {
+llvm::json::Value VirtualBaseOffset::ToJson() const {
   return llvm::json::Object{
+      {"vbase_offset_offset", vbase_offset_offset},
+      {"offset_in_vbase", offset_in_vbase},
+  };
+}
+
+llvm::json::Value BaseClass::ToJson() const {
+  llvm::json::Object base{
       {"base_record_id", base_record_id},
       {"offset", offset},
   };
+  if (virtual_base_offset.has_value()) {
+    base.insert({"virtual_base_offset", virtual_base_offset->ToJson()});
+  }
+  return base;
 }
 
 static std::string RecordTypeToString(RecordType record_type) {
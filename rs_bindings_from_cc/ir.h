@@ -31,6 +31,7 @@
 #include "clang/AST/DeclBase.h"
 #include "clang/AST/DeclTemplate.h"
 #include "clang/AST/RawCommentList.h"
+#include "clang/Basic/SourceManager.h"
 #include "llvm/ADT/APSInt.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/JSON.h"
@@ -94,34 +95,39 @@ inline std::ostream& operator<<(std::ostream& o, const HeaderName& h) {
 // edges that don't follow the JSON tree structure (for example between types
 // and records), as well as location of comments and items we don't yet support.
 //  We use ItemIds for this.
+//
+// ItemIds are derived from the contents of the headers rather than from
+// pointers, so that the same headers always produce the same IR. This lets
+// build systems cache (and skip rebuilding) everything that depends on the IR.
 CRUBIT_DEFINE_STRONG_INT_TYPE(ItemId, uintptr_t);
 
-inline ItemId GenerateItemId(const clang::Decl* decl) {
-  if (auto namespace_decl = clang::dyn_cast<clang::NamespaceDecl>(decl)) {
-    return ItemId(reinterpret_cast<uintptr_t>(namespace_decl));
-  }
-  return ItemId(reinterpret_cast<uintptr_t>(decl->getCanonicalDecl()));
-}
+// Returns the ID of `decl`, which is shared by all its redeclarations except
+// for namespaces: each `namespace` block gets its own ID.
+//
+// The ID is a hash of the USR of the (canonical) declaration and of its source
+// location.
+ItemId GenerateItemId(const clang::Decl* decl);
 
-inline ItemId GenerateItemId(const clang::RawComment* comment) {
-  return ItemId(reinterpret_cast<uintptr_t>(comment));
-}
+// Returns the ID of `comment`, which is a hash of its source location.
+ItemId GenerateItemId(const clang::RawComment* comment,
+                      const clang::SourceManager& sm);
+
+// Returns the ID of the `UseMod` item for the Rust source file at `path`.
+ItemId GenerateUseModItemId(absl::string_view path);
 
-// Returns the ID of the parent namespace, if such exists, and `std::nullopt`
-// for top level decls. We use this function to assign a parent namespace to all
-// the IR items.
-inline std::optional<ItemId> GetEnclosingNamespaceId(const clang::Decl* decl) {
+// Returns the parent namespace, if such exists, and null for top level decls.
+// We use this function to assign a parent namespace to all the IR items.
+inline const clang::NamespaceDecl* GetEnclosingNamespace(
+    const clang::Decl* decl) {
   auto enclosing_namespace =
       decl->getDeclContext()->getEnclosingNamespaceContext();
-  if (enclosing_namespace->isTranslationUnit()) return std::nullopt;
+  if (enclosing_namespace->isTranslationUnit()) return nullptr;
 
   // Class template specializations are always emitted in the top-level
   // namespace.  See also Importer::GetOrderedItemIdsOfTemplateInstantiations.
-  if (clang::isa<clang::ClassTemplateSpecializationDecl>(decl))
-    return std::nullopt;
+  if (clang::isa<clang::ClassTemplateSpecializationDecl>(decl)) return nullptr;
 
-  auto namespace_decl = clang::cast<clang::NamespaceDecl>(enclosing_namespace);
-  return GenerateItemId(namespace_decl);
+  return clang::cast<clang::NamespaceDecl>(enclosing_namespace);
 }
 
 // A numerical ID that uniquely identifies a lifetime.
@@ -333,6 +339,9 @@ class IntegerConstant {
   IntegerConstant(const IntegerConstant& other) = default;
   IntegerConstant& operator=(const IntegerConstant& other) = default;
 
+  bool is_negative() const { return is_negative_; }
+  uint64_t wrapped_value() const { return wrapped_value_; }
+
   llvm::json::Value ToJson() const;
 
  private:
@@ -412,6 +421,9 @@ struct MemberFuncMetadata {
     ReferenceQualification reference = kUnqualified;
     bool is_const = false;
     bool is_virtual = false;
+    // Whether no derived class can override the method: it is declared
+    // `final`, or its class is.
+    bool is_final = false;
   };
 
   llvm::json::Value ToJson() const;
@@ -425,6 +437,25 @@ struct MemberFuncMetadata {
   std::optional<InstanceMethodMetadata> instance_method_metadata;
 };
 
+// The body of an inline member function that does nothing but read or write a
+// field of `*this`, e.g. `int x() const { return x_; }` or
+// `void set_x(int x) { x_ = x; }`.
+//
+// Such functions can be reimplemented in Rust instead of being called through
+// a C++ thunk, which would otherwise be an opaque call in non-LTO builds.
+struct TrivialFieldAccessor {
+  llvm::json::Value ToJson() const;
+
+  enum Kind : char {
+    kGetter,  // Returns the field by value, and takes no parameters.
+    kSetter,  // Assigns its only parameter to the field, and returns void.
+  };
+
+  Kind kind;
+  // The identifier of the field, as in `Field::identifier`.
+  Identifier field;
+};
+
 // A function involved in the bindings.
 struct Func {
   llvm::json::Value ToJson() const;
@@ -451,6 +482,12 @@ struct Func {
   // Rust type modeling in src_code_gen makes it much easier to do on the
   // consuming end.
   std::optional<ItemId> adl_enclosing_record;
+  // If present, the body of this function is a trivial field accessor.
+  std::optional<TrivialFieldAccessor> trivial_field_accessor;
+  // Whether the bindings should also include a batch variant of the function,
+  // which calls it for each element of slices of arguments (see
+  // `CRUBIT_INTERNAL_BATCH_THUNK`).
+  bool has_batch_thunk = false;
 };
 
 inline std::ostream& operator<<(std::ostream& o, const Func& f) {
@@ -518,6 +555,19 @@ inline std::ostream& operator<<(std::ostream& o, const SpecialMemberFunc& f) {
   return o << std::string(llvm::formatv("{0:2}", toJSON(f)));
 }
 
+// Where to find a base class subobject reached through a virtual base class,
+// on ABIs which store the offsets of virtual bases in the vtable (Itanium).
+struct VirtualBaseOffset {
+  llvm::json::Value ToJson() const;
+
+  // The offset, from the address point of the vtable of the derived class, of
+  // the entry holding the offset of the nearest virtual base on the path.
+  int64_t vbase_offset_offset;
+
+  // The offset of the base class subobject within that virtual base.
+  int64_t offset_in_vbase;
+};
+
 // A base class subobject of a struct or class.
 struct BaseClass {
   llvm::json::Value ToJson() const;
@@ -527,6 +577,10 @@ struct BaseClass {
   // for nonvirtual inheritance, and always empty if a virtual base class is
   // anywhere in the inheritance chain.
   std::optional<int64_t> offset;
+
+  // If a virtual base class is in the inheritance chain, and the ABI allows
+  // it, how to find the base class subobject without calling into C++.
+  std::optional<VirtualBaseOffset> virtual_base_offset;
 };
 
 enum RecordType {
@@ -832,6 +886,10 @@ inline std::string ItemToString(const std::optional<IR::Item>& item) {
   if (item.has_value()) return ItemToString(*item);
   return "null";
 }
+inline std::string ItemToString(const IR::Item* item) {
+  if (item != nullptr) return ItemToString(*item);
+  return "null";
+}
 
 }  // namespace crubit
 
@@ -18,6 +18,9 @@ use std::hash::{Hash, Hasher};
 use std::io::Read;
 use std::rc::Rc;
 
+mod ir_binary;
+pub use ir_binary::deserialize_ir_binary;
+
 /// Common data about all items.
 pub trait GenericItem {
     fn id(&self) -> ItemId;
@@ -354,6 +357,7 @@ pub struct InstanceMethodMetadata {
     pub reference: ReferenceQualification,
     pub is_const: bool,
     pub is_virtual: bool,
+    pub is_final: bool,
 }
 
 #[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
@@ -363,6 +367,21 @@ pub struct MemberFuncMetadata {
     pub instance_method_metadata: Option<InstanceMethodMetadata>,
 }
 
+#[derive(Copy, Clone, Debug, PartialEq, Eq, Hash, Deserialize)]
+pub enum TrivialFieldAccessorKind {
+    Getter,
+    Setter,
+}
+
+/// The body of an inline member function that does nothing but read or write
+/// a field of `*this`, and that can therefore be reimplemented in Rust.
+#[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
+#[serde(deny_unknown_fields)]
+pub struct TrivialFieldAccessor {
+    pub kind: TrivialFieldAccessorKind,
+    pub field: Identifier,
+}
+
 #[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
 #[serde(deny_unknown_fields)]
 pub struct FuncParam {
@@ -394,6 +413,8 @@ pub struct Func {
     pub id: ItemId,
     pub enclosing_namespace_id: Option<ItemId>,
     pub adl_enclosing_record: Option<ItemId>,
+    pub trivial_field_accessor: Option<TrivialFieldAccessor>,
+    pub has_batch_thunk: bool,
 }
 
 impl GenericItem for Func {
@@ -472,6 +493,15 @@ pub enum SpecialMemberFunc {
 pub struct BaseClass {
     pub base_record_id: ItemId,
     pub offset: Option<i64>,
+    #[serde(default)]
+    pub virtual_base_offset: Option<VirtualBaseOffset>,
+}
+
+#[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
+#[serde(deny_unknown_fields)]
+pub struct VirtualBaseOffset {
+    pub vbase_offset_offset: i64,
+    pub offset_in_vbase: i64,
 }
 
 #[derive(Debug, PartialEq, Eq, Hash, Clone, Deserialize)]
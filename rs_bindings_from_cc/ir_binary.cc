@@ -0,0 +1,410 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/ir_binary.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/container/node_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "rs_bindings_from_cc/bazel_types.h"
+#include "rs_bindings_from_cc/ir.h"
+
+namespace crubit {
+
+namespace {
+
+// Writes the body of the binary IR, interning strings and types as it goes.
+// The tables are only known once the whole body has been written, so `Finish`
+// assembles the header, the tables, and the body at the end.
+class BinaryIrWriter {
+ public:
+  // Returns the complete encoding: header, string and type tables, and `body`.
+  std::string Finish(absl::string_view body) const {
+    BinaryIrWriter header;
+    header.out_.reserve(kBinaryIrMagic.size() + strings_bytes_ +
+                        5 * strings_.size() + types_bytes_ + body.size() +
+                        16);
+    header.out_.append(kBinaryIrMagic.data(), kBinaryIrMagic.size());
+    header.WriteUnsigned(kBinaryIrSchemaVersion);
+    header.WriteUnsigned(strings_.size());
+    for (absl::string_view s : strings_) {
+      header.WriteUnsigned(s.size());
+      header.out_.append(s.data(), s.size());
+    }
+    header.WriteUnsigned(types_.size());
+    for (absl::string_view type : types_) {
+      header.out_.append(type.data(), type.size());
+    }
+    header.out_.append(body.data(), body.size());
+    return std::move(header.out_);
+  }
+
+  // Takes the bytes written so far, leaving the writer empty (but keeping the
+  // string table).
+  std::string TakeBytes() { return std::exchange(out_, std::string()); }
+
+  void WriteUnsigned(uint64_t value) {
+    while (value >= 0x80) {
+      out_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    out_.push_back(static_cast<char>(value));
+  }
+
+  void WriteSigned(int64_t value) {
+    WriteUnsigned((static_cast<uint64_t>(value) << 1) ^
+                  static_cast<uint64_t>(value >> 63));
+  }
+
+  void WriteBool(bool value) { out_.push_back(value ? 1 : 0); }
+
+  void WriteString(absl::string_view value) {
+    auto [it, inserted] =
+        string_indices_.try_emplace(std::string(value), strings_.size());
+    if (inserted) {
+      // Node keys are stable, so the table can refer to them directly.
+      strings_.push_back(it->first);
+      strings_bytes_ += value.size();
+    }
+    WriteUnsigned(it->second);
+  }
+
+  void Write(ItemId id) { WriteUnsigned(id.value()); }
+  void Write(const BazelLabel& label) { WriteString(label.value()); }
+  void Write(const Identifier& identifier) {
+    WriteString(identifier.Ident());
+  }
+
+  template <typename T>
+  void Write(const std::optional<T>& value) {
+    WriteBool(value.has_value());
+    if (value.has_value()) Write(*value);
+  }
+
+  template <typename T>
+  void Write(const std::vector<T>& values) {
+    WriteUnsigned(values.size());
+    for (const T& value : values) Write(value);
+  }
+
+  void Write(const std::optional<std::string>& value) {
+    WriteBool(value.has_value());
+    if (value.has_value()) WriteString(*value);
+  }
+
+  void Write(const HeaderName& header) { WriteString(header.IncludePath()); }
+
+  void Write(LifetimeId id) { WriteSigned(id.value()); }
+
+  void Write(const LifetimeName& lifetime) {
+    WriteString(lifetime.name);
+    Write(lifetime.id);
+  }
+
+  void Write(const RsType& type) {
+    WriteBool(!type.decl_id.has_value());
+    if (!type.decl_id.has_value()) WriteString(type.name);
+    Write(type.lifetime_args);
+    Write(type.type_args);
+    Write(type.decl_id);
+  }
+
+  void Write(const CcType& type) {
+    WriteBool(!type.decl_id.has_value());
+    if (!type.decl_id.has_value()) WriteString(type.name);
+    WriteBool(type.is_const);
+    Write(type.type_args);
+    Write(type.decl_id);
+  }
+
+  // Types are interned like strings: the same types are used all over the IR
+  // (e.g. in every signature which takes an `int` or a `const T&`).
+  void Write(const MappedType& type) {
+    std::string out = TakeBytes();
+    Write(type.rs_type);
+    Write(type.cc_type);
+    std::string encoded = std::exchange(out_, std::move(out));
+    auto [it, inserted] =
+        type_indices_.try_emplace(std::move(encoded), types_.size());
+    if (inserted) {
+      types_.push_back(it->first);
+      types_bytes_ += it->first.size();
+    }
+    WriteUnsigned(it->second);
+  }
+
+  void Write(const IntegerConstant& value) {
+    WriteBool(value.is_negative());
+    WriteUnsigned(value.wrapped_value());
+  }
+
+  void Write(const UnqualifiedIdentifier& name) {
+    if (auto* id = std::get_if<Identifier>(&name)) {
+      WriteUnsigned(0);
+      Write(*id);
+    } else if (auto* op = std::get_if<Operator>(&name)) {
+      WriteUnsigned(1);
+      WriteString(op->Name());
+    } else {
+      switch (std::get<SpecialName>(name)) {
+        case SpecialName::kConstructor:
+          WriteUnsigned(2);
+          break;
+        case SpecialName::kDestructor:
+          WriteUnsigned(3);
+          break;
+      }
+    }
+  }
+
+  void Write(const FuncParam& param) {
+    Write(param.type);
+    Write(param.identifier);
+  }
+
+  void Write(const MemberFuncMetadata::InstanceMethodMetadata& metadata) {
+    WriteUnsigned(metadata.reference);
+    WriteBool(metadata.is_const);
+    WriteBool(metadata.is_virtual);
+    WriteBool(metadata.is_final);
+  }
+
+  void Write(const MemberFuncMetadata& metadata) {
+    Write(metadata.record_id);
+    Write(metadata.instance_method_metadata);
+  }
+
+  void Write(const TrivialFieldAccessor& accessor) {
+    WriteUnsigned(accessor.kind);
+    Write(accessor.field);
+  }
+
+  void Write(const Func& func) {
+    Write(func.name);
+    Write(func.owning_target);
+    WriteString(func.mangled_name);
+    Write(func.doc_comment);
+    Write(func.return_type);
+    Write(func.params);
+    Write(func.lifetime_params);
+    WriteBool(func.is_inline);
+    Write(func.member_func_metadata);
+    WriteBool(func.has_c_calling_convention);
+    WriteBool(func.is_member_or_descendant_of_class_template);
+    WriteString(func.source_loc);
+    Write(func.id);
+    Write(func.enclosing_namespace_id);
+    Write(func.adl_enclosing_record);
+    Write(func.trivial_field_accessor);
+    WriteBool(func.has_batch_thunk);
+  }
+
+  void Write(const absl::StatusOr<MappedType>& type) {
+    WriteBool(type.ok());
+    if (type.ok()) {
+      Write(*type);
+    } else {
+      WriteString(type.status().message());
+    }
+  }
+
+  void Write(const Field& field) {
+    Write(field.identifier);
+    Write(field.doc_comment);
+    Write(field.type);
+    WriteUnsigned(field.access);
+    WriteUnsigned(field.offset);
+    WriteUnsigned(field.size);
+    WriteBool(field.is_no_unique_address);
+    WriteBool(field.is_bitfield);
+    WriteBool(field.is_inheritable);
+  }
+
+  void Write(SpecialMemberFunc f) { WriteUnsigned(static_cast<uint64_t>(f)); }
+
+  void Write(const VirtualBaseOffset& vbase) {
+    WriteSigned(vbase.vbase_offset_offset);
+    WriteSigned(vbase.offset_in_vbase);
+  }
+
+  void Write(const BaseClass& base) {
+    Write(base.base_record_id);
+    WriteBool(base.offset.has_value());
+    if (base.offset.has_value()) WriteSigned(*base.offset);
+    Write(base.virtual_base_offset);
+  }
+
+  void Write(const SizeAlign& size_align) {
+    WriteUnsigned(size_align.size);
+    WriteUnsigned(size_align.alignment);
+  }
+
+  void Write(const Record& record) {
+    WriteString(record.rs_name);
+    WriteString(record.cc_name);
+    WriteString(record.mangled_cc_name);
+    Write(record.id);
+    Write(record.owning_target);
+    Write(record.defining_target);
+    Write(record.doc_comment);
+    WriteString(record.source_loc);
+    Write(record.unambiguous_public_bases);
+    Write(record.fields);
+    Write(record.lifetime_params);
+    Write(record.size_align);
+    WriteBool(record.is_derived_class);
+    WriteBool(record.override_alignment);
+    Write(record.copy_constructor);
+    Write(record.move_constructor);
+    Write(record.destructor);
+    WriteBool(record.is_trivial_abi);
+    WriteBool(record.is_inheritable);
+    WriteBool(record.is_abstract);
+    WriteUnsigned(record.record_type);
+    WriteBool(record.is_aggregate);
+    WriteBool(record.is_anon_record_with_typedef);
+    Write(record.child_item_ids);
+    Write(record.enclosing_namespace_id);
+  }
+
+  void Write(const IncompleteRecord& record) {
+    WriteString(record.cc_name);
+    WriteString(record.rs_name);
+    Write(record.id);
+    Write(record.owning_target);
+    WriteUnsigned(record.record_type);
+    Write(record.enclosing_namespace_id);
+  }
+
+  void Write(const Enumerator& enumerator) {
+    Write(enumerator.identifier);
+    Write(enumerator.value);
+  }
+
+  void Write(const Enum& enum_) {
+    Write(enum_.identifier);
+    Write(enum_.id);
+    Write(enum_.owning_target);
+    WriteString(enum_.source_loc);
+    Write(enum_.underlying_type);
+    Write(enum_.enumerators);
+    Write(enum_.enclosing_namespace_id);
+  }
+
+  void Write(const TypeAlias& type_alias) {
+    Write(type_alias.identifier);
+    Write(type_alias.id);
+    Write(type_alias.owning_target);
+    Write(type_alias.doc_comment);
+    Write(type_alias.underlying_type);
+    WriteString(type_alias.source_loc);
+    Write(type_alias.enclosing_record_id);
+    Write(type_alias.enclosing_namespace_id);
+  }
+
+  void Write(const UnsupportedItem& unsupported) {
+    WriteString(unsupported.name);
+    WriteString(unsupported.message);
+    WriteString(unsupported.source_loc);
+    Write(unsupported.id);
+  }
+
+  void Write(const Comment& comment) {
+    WriteString(comment.text);
+    Write(comment.id);
+  }
+
+  void Write(const Namespace& ns) {
+    Write(ns.name);
+    Write(ns.id);
+    Write(ns.canonical_namespace_id);
+    Write(ns.owning_target);
+    Write(ns.child_item_ids);
+    Write(ns.enclosing_namespace_id);
+    WriteBool(ns.is_inline);
+  }
+
+  void Write(const UseMod& use_mod) {
+    WriteString(use_mod.path);
+    Write(use_mod.mod_name);
+    Write(use_mod.id);
+  }
+
+  void Write(const TypeMapOverride& type_override) {
+    WriteString(type_override.rs_name);
+    WriteString(type_override.cc_name);
+    Write(type_override.owning_target);
+    Write(type_override.size_align);
+    WriteBool(type_override.is_same_abi);
+    Write(type_override.id);
+  }
+
+  void Write(const IR::Item& item) {
+    // Items are length-prefixed: write the payload on its own first.
+    std::string prefix = TakeBytes();
+    std::visit([&](auto&& item) { Write(item); }, item);
+    std::string payload = std::exchange(out_, std::move(prefix));
+    WriteUnsigned(item.index());
+    WriteUnsigned(payload.size());
+    out_.append(payload);
+  }
+
+  void Write(const IR& ir) {
+    Write(ir.public_headers);
+    Write(ir.current_target);
+    Write(ir.items);
+    Write(ir.top_level_item_ids);
+    WriteBool(!ir.crate_root_path.empty());
+    if (!ir.crate_root_path.empty()) WriteString(ir.crate_root_path);
+
+    // Sorted, so that the output doesn't depend on hash map iteration order.
+    std::vector<std::pair<absl::string_view, std::vector<absl::string_view>>>
+        features;
+    features.reserve(ir.crubit_features.size());
+    for (const auto& [target, target_features] : ir.crubit_features) {
+      std::vector<absl::string_view> names(target_features.begin(),
+                                           target_features.end());
+      std::sort(names.begin(), names.end());
+      features.emplace_back(target.value(), std::move(names));
+    }
+    std::sort(features.begin(), features.end());
+    WriteUnsigned(features.size());
+    for (const auto& [target, names] : features) {
+      WriteString(target);
+      WriteUnsigned(names.size());
+      for (absl::string_view name : names) WriteString(name);
+    }
+  }
+
+ private:
+  std::string out_;
+  // The string table, in index order. Points into `string_indices_` keys.
+  std::vector<absl::string_view> strings_;
+  absl::node_hash_map<std::string, uint64_t> string_indices_;
+  size_t strings_bytes_ = 0;
+  // The type table, in index order, as the encodings of the types. Points
+  // into `type_indices_` keys.
+  std::vector<absl::string_view> types_;
+  absl::node_hash_map<std::string, uint64_t> type_indices_;
+  size_t types_bytes_ = 0;
+};
+
+}  // namespace
+
+std::string IrToBinary(const IR& ir) {
+  BinaryIrWriter writer;
+  writer.Write(ir);
+  std::string body = writer.TakeBytes();
+  return writer.Finish(body);
+}
+
+}  // namespace crubit
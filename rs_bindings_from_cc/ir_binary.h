@@ -0,0 +1,56 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// A compact binary encoding of the `IR`, used to hand the IR from the C++
+// importer to the Rust code generator without going through JSON.
+//
+// The JSON produced by `IR::ToJson` stays the human-readable format (it backs
+// `--ir_out` and the tests); this encoding is an internal transport format
+// whose only reader is `deserialize_ir_binary` in `ir_binary.rs`.
+//
+// Layout:
+//
+//   magic          "CRUBITIR" (8 bytes)
+//   version        varint, must equal `kBinaryIrSchemaVersion`
+//   string table   varint count, then each string as varint length + bytes
+//   type table     varint count, then each `MappedType`
+//   body           the `IR` fields, in `IR` declaration order
+//
+// Within the body:
+//   * unsigned integers (and `ItemId`s) are LEB128 varints,
+//   * signed integers are zigzag-encoded varints,
+//   * `bool`s are a single byte,
+//   * strings are varint indices into the string table (so that every
+//     distinct string - names, labels, source locations - is stored once),
+//   * `MappedType`s outside of the type table are varint indices into it,
+//   * `std::optional`s are a presence byte followed by the value,
+//   * sequences are a varint element count followed by the elements,
+//   * enums and variants are a varint tag followed by the payload,
+//   * every item is a varint tag (its index in `IR::Item`), a varint byte
+//     length, and the payload, so a reader can skip items it doesn't need.
+//
+// Any change to the `IR` structs must be reflected in `ir_binary.cc` and
+// `ir_binary.rs`, and must bump `kBinaryIrSchemaVersion` on both sides.
+#ifndef CRUBIT_RS_BINDINGS_FROM_CC_IR_BINARY_H_
+#define CRUBIT_RS_BINDINGS_FROM_CC_IR_BINARY_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "rs_bindings_from_cc/ir.h"
+
+namespace crubit {
+
+// LINT.IfChange
+inline constexpr absl::string_view kBinaryIrMagic = "CRUBITIR";
+inline constexpr uint64_t kBinaryIrSchemaVersion = 6;
+// LINT.ThenChange(//depot/rs_bindings_from_cc/ir_binary.rs)
+
+// Serializes `ir` into the binary format described above.
+std::string IrToBinary(const IR& ir);
+
+}  // namespace crubit
+
+#endif  // CRUBIT_RS_BINDINGS_FROM_CC_IR_BINARY_H_
@@ -0,0 +1,665 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//! Decoder for the binary IR encoding. See `rs_bindings_from_cc/ir_binary.h`
+//! for the format, and `IrToBinary` in `ir_binary.cc` for the encoder.
+
+use super::*;
+
+use arc_anyhow::{bail, ensure, Context, Result};
+use std::collections::HashMap;
+use std::rc::Rc;
+
+// LINT.IfChange
+const MAGIC: &[u8] = b"CRUBITIR";
+const SCHEMA_VERSION: u64 = 6;
+// LINT.ThenChange(//depot/rs_bindings_from_cc/ir_binary.h)
+
+/// Deserialize `IR` from the binary encoding produced by `IrToBinary`.
+pub fn deserialize_ir_binary(bytes: &[u8]) -> Result<IR> {
+    let flat_ir = Decoder::new(bytes)?.flat_ir().context("Malformed binary IR")?;
+    Ok(make_ir(flat_ir))
+}
+
+struct Decoder<'a> {
+    bytes: &'a [u8],
+    pos: usize,
+    strings: Vec<Rc<str>>,
+    types: Vec<MappedType>,
+}
+
+impl<'a> Decoder<'a> {
+    /// Validates the header and reads the string and type tables.
+    fn new(bytes: &'a [u8]) -> Result<Self> {
+        ensure!(bytes.starts_with(MAGIC), "Not a binary IR (bad magic)");
+        let mut decoder = Decoder { bytes, pos: MAGIC.len(), strings: vec![], types: vec![] };
+        let version = decoder.unsigned()?;
+        ensure!(
+            version == SCHEMA_VERSION,
+            "Unsupported binary IR schema version {version} (expected {SCHEMA_VERSION})"
+        );
+        let count = decoder.len()?;
+        decoder.strings.reserve(count);
+        for _ in 0..count {
+            let len = decoder.len()?;
+            let raw = decoder.take(len)?;
+            let s = std::str::from_utf8(raw).context("String table entry is not UTF-8")?;
+            decoder.strings.push(s.into());
+        }
+        let count = decoder.len()?;
+        decoder.types.reserve(count);
+        for _ in 0..count {
+            let ty = MappedType { rs_type: decoder.rs_type()?, cc_type: decoder.cc_type()? };
+            decoder.types.push(ty);
+        }
+        Ok(decoder)
+    }
+
+    fn take(&mut self, len: usize) -> Result<&'a [u8]> {
+        let end = self.pos.checked_add(len).filter(|end| *end <= self.bytes.len());
+        let Some(end) = end else {
+            bail!("Unexpected end of binary IR at offset {}", self.pos);
+        };
+        let result = &self.bytes[self.pos..end];
+        self.pos = end;
+        Ok(result)
+    }
+
+    fn byte(&mut self) -> Result<u8> {
+        Ok(self.take(1)?[0])
+    }
+
+    fn unsigned(&mut self) -> Result<u64> {
+        let mut result = 0u64;
+        let mut shift = 0;
+        loop {
+            let byte = self.byte()?;
+            ensure!(shift < 64, "Varint too long at offset {}", self.pos);
+            result |= u64::from(byte & 0x7f) << shift;
+            if byte & 0x80 == 0 {
+                return Ok(result);
+            }
+            shift += 7;
+        }
+    }
+
+    fn signed(&mut self) -> Result<i64> {
+        let zigzag = self.unsigned()?;
+        Ok((zigzag >> 1) as i64 ^ -((zigzag & 1) as i64))
+    }
+
+    fn usize(&mut self) -> Result<usize> {
+        Ok(usize::try_from(self.unsigned()?)?)
+    }
+
+    /// A sequence length. Every element takes at least one byte, so lengths
+    /// longer than the rest of the input are rejected before allocating.
+    fn len(&mut self) -> Result<usize> {
+        let len = self.usize()?;
+        ensure!(len <= self.bytes.len() - self.pos, "Invalid length {len} at offset {}", self.pos);
+        Ok(len)
+    }
+
+    fn bool(&mut self) -> Result<bool> {
+        match self.byte()? {
+            0 => Ok(false),
+            1 => Ok(true),
+            other => bail!("Invalid bool {other} at offset {}", self.pos - 1),
+        }
+    }
+
+    fn string(&mut self) -> Result<Rc<str>> {
+        let idx = self.usize()?;
+        match self.strings.get(idx) {
+            Some(s) => Ok(s.clone()),
+            None => bail!("Invalid string index {idx} at offset {}", self.pos),
+        }
+    }
+
+    fn option<T>(&mut self, f: impl FnOnce(&mut Self) -> Result<T>) -> Result<Option<T>> {
+        if self.bool()? {
+            Ok(Some(f(self)?))
+        } else {
+            Ok(None)
+        }
+    }
+
+    fn vec<T>(&mut self, mut f: impl FnMut(&mut Self) -> Result<T>) -> Result<Vec<T>> {
+        let len = self.len()?;
+        let mut result = Vec::with_capacity(len);
+        for _ in 0..len {
+            result.push(f(self)?);
+        }
+        Ok(result)
+    }
+
+    fn item_id(&mut self) -> Result<ItemId> {
+        Ok(ItemId(self.usize()?))
+    }
+
+    fn opt_item_id(&mut self) -> Result<Option<ItemId>> {
+        self.option(Self::item_id)
+    }
+
+    fn opt_string(&mut self) -> Result<Option<Rc<str>>> {
+        self.option(Self::string)
+    }
+
+    fn bazel_label(&mut self) -> Result<BazelLabel> {
+        Ok(BazelLabel(self.string()?))
+    }
+
+    fn identifier(&mut self) -> Result<Identifier> {
+        Ok(Identifier { identifier: self.string()? })
+    }
+
+    fn lifetime_id(&mut self) -> Result<LifetimeId> {
+        Ok(LifetimeId(i32::try_from(self.signed()?)?))
+    }
+
+    fn lifetime_name(&mut self) -> Result<LifetimeName> {
+        Ok(LifetimeName { name: self.string()?, id: self.lifetime_id()? })
+    }
+
+    fn rs_type(&mut self) -> Result<RsType> {
+        Ok(RsType {
+            name: self.opt_string()?,
+            lifetime_args: self.vec(Self::lifetime_id)?.into(),
+            type_args: self.vec(Self::rs_type)?.into(),
+            decl_id: self.opt_item_id()?,
+        })
+    }
+
+    fn cc_type(&mut self) -> Result<CcType> {
+        Ok(CcType {
+            name: self.opt_string()?,
+            is_const: self.bool()?,
+            type_args: self.vec(Self::cc_type)?,
+            decl_id: self.opt_item_id()?,
+        })
+    }
+
+    fn mapped_type(&mut self) -> Result<MappedType> {
+        let idx = self.usize()?;
+        match self.types.get(idx) {
+            Some(ty) => Ok(ty.clone()),
+            None => bail!("Invalid type index {idx} at offset {}", self.pos),
+        }
+    }
+
+    fn integer_constant(&mut self) -> Result<IntegerConstant> {
+        Ok(IntegerConstant { is_negative: self.bool()?, wrapped_value: self.unsigned()? })
+    }
+
+    fn unqualified_identifier(&mut self) -> Result<UnqualifiedIdentifier> {
+        Ok(match self.unsigned()? {
+            0 => UnqualifiedIdentifier::Identifier(self.identifier()?),
+            1 => UnqualifiedIdentifier::Operator(Operator { name: self.string()? }),
+            2 => UnqualifiedIdentifier::Constructor,
+            3 => UnqualifiedIdentifier::Destructor,
+            other => bail!("Invalid UnqualifiedIdentifier tag {other}"),
+        })
+    }
+
+    fn func_param(&mut self) -> Result<FuncParam> {
+        Ok(FuncParam { type_: self.mapped_type()?, identifier: self.identifier()? })
+    }
+
+    fn instance_method_metadata(&mut self) -> Result<InstanceMethodMetadata> {
+        let reference = match self.unsigned()? {
+            0 => ReferenceQualification::LValue,
+            1 => ReferenceQualification::RValue,
+            2 => ReferenceQualification::Unqualified,
+            other => bail!("Invalid ReferenceQualification tag {other}"),
+        };
+        Ok(InstanceMethodMetadata {
+            reference,
+            is_const: self.bool()?,
+            is_virtual: self.bool()?,
+            is_final: self.bool()?,
+        })
+    }
+
+    fn member_func_metadata(&mut self) -> Result<MemberFuncMetadata> {
+        Ok(MemberFuncMetadata {
+            record_id: self.item_id()?,
+            instance_method_metadata: self.option(Self::instance_method_metadata)?,
+        })
+    }
+
+    fn trivial_field_accessor(&mut self) -> Result<TrivialFieldAccessor> {
+        let kind = match self.unsigned()? {
+            0 => TrivialFieldAccessorKind::Getter,
+            1 => TrivialFieldAccessorKind::Setter,
+            other => bail!("Invalid TrivialFieldAccessorKind tag {other}"),
+        };
+        Ok(TrivialFieldAccessor { kind, field: self.identifier()? })
+    }
+
+    fn func(&mut self) -> Result<Func> {
+        Ok(Func {
+            name: self.unqualified_identifier()?,
+            owning_target: self.bazel_label()?,
+            mangled_name: self.string()?,
+            doc_comment: self.opt_string()?,
+            return_type: self.mapped_type()?,
+            params: self.vec(Self::func_param)?,
+            lifetime_params: self.vec(Self::lifetime_name)?,
+            is_inline: self.bool()?,
+            member_func_metadata: self.option(Self::member_func_metadata)?,
+            has_c_calling_convention: self.bool()?,
+            is_member_or_descendant_of_class_template: self.bool()?,
+            source_loc: self.string()?,
+            id: self.item_id()?,
+            enclosing_namespace_id: self.opt_item_id()?,
+            adl_enclosing_record: self.opt_item_id()?,
+            trivial_field_accessor: self.option(Self::trivial_field_accessor)?,
+            has_batch_thunk: self.bool()?,
+        })
+    }
+
+    fn access_specifier(&mut self) -> Result<AccessSpecifier> {
+        Ok(match self.unsigned()? {
+            0 => AccessSpecifier::Public,
+            1 => AccessSpecifier::Protected,
+            2 => AccessSpecifier::Private,
+            other => bail!("Invalid AccessSpecifier tag {other}"),
+        })
+    }
+
+    fn field(&mut self) -> Result<Field> {
+        Ok(Field {
+            identifier: self.option(Self::identifier)?,
+            doc_comment: self.opt_string()?,
+            type_: if self.bool()? {
+                Ok(self.mapped_type()?)
+            } else {
+                Err(self.string()?.to_string())
+            },
+            access: self.access_specifier()?,
+            offset: self.usize()?,
+            size: self.usize()?,
+            is_no_unique_address: self.bool()?,
+            is_bitfield: self.bool()?,
+            is_inheritable: self.bool()?,
+        })
+    }
+
+    fn special_member_func(&mut self) -> Result<SpecialMemberFunc> {
+        Ok(match self.unsigned()? {
+            0 => SpecialMemberFunc::Trivial,
+            1 => SpecialMemberFunc::NontrivialMembers,
+            2 => SpecialMemberFunc::NontrivialUserDefined,
+            3 => SpecialMemberFunc::Unavailable,
+            other => bail!("Invalid SpecialMemberFunc tag {other}"),
+        })
+    }
+
+    fn virtual_base_offset(&mut self) -> Result<VirtualBaseOffset> {
+        Ok(VirtualBaseOffset {
+            vbase_offset_offset: self.signed()?,
+            offset_in_vbase: self.signed()?,
+        })
+    }
+
+    fn base_class(&mut self) -> Result<BaseClass> {
+        Ok(BaseClass {
+            base_record_id: self.item_id()?,
+            offset: self.option(Self::signed)?,
+            virtual_base_offset: self.option(Self::virtual_base_offset)?,
+        })
+    }
+
+    fn size_align(&mut self) -> Result<SizeAlign> {
+        Ok(SizeAlign { size: self.usize()?, alignment: self.usize()? })
+    }
+
+    fn record_type(&mut self) -> Result<RecordType> {
+        Ok(match self.unsigned()? {
+            0 => RecordType::Struct,
+            1 => RecordType::Union,
+            2 => RecordType::Class,
+            other => bail!("Invalid RecordType tag {other}"),
+        })
+    }
+
+    fn record(&mut self) -> Result<Record> {
+        Ok(Record {
+            rs_name: self.string()?,
+            cc_name: self.string()?,
+            mangled_cc_name: self.string()?,
+            id: self.item_id()?,
+            owning_target: self.bazel_label()?,
+            defining_target: self.option(Self::bazel_label)?,
+            doc_comment: self.opt_string()?,
+            source_loc: self.string()?,
+            unambiguous_public_bases: self.vec(Self::base_class)?,
+            fields: self.vec(Self::field)?,
+            lifetime_params: self.vec(Self::lifetime_name)?,
+            size_align: self.size_align()?,
+            is_derived_class: self.bool()?,
+            override_alignment: self.bool()?,
+            copy_constructor: self.special_member_func()?,
+            move_constructor: self.special_member_func()?,
+            destructor: self.special_member_func()?,
+            is_trivial_abi: self.bool()?,
+            is_inheritable: self.bool()?,
+            is_abstract: self.bool()?,
+            record_type: self.record_type()?,
+            is_aggregate: self.bool()?,
+            is_anon_record_with_typedef: self.bool()?,
+            child_item_ids: self.vec(Self::item_id)?,
+            enclosing_namespace_id: self.opt_item_id()?,
+        })
+    }
+
+    fn incomplete_record(&mut self) -> Result<IncompleteRecord> {
+        Ok(IncompleteRecord {
+            cc_name: self.string()?,
+            rs_name: self.string()?,
+            id: self.item_id()?,
+            owning_target: self.bazel_label()?,
+            record_type: self.record_type()?,
+            enclosing_namespace_id: self.opt_item_id()?,
+        })
+    }
+
+    fn enumerator(&mut self) -> Result<Enumerator> {
+        Ok(Enumerator { identifier: self.identifier()?, value: self.integer_constant()? })
+    }
+
+    fn enum_(&mut self) -> Result<Enum> {
+        Ok(Enum {
+            identifier: self.identifier()?,
+            id: self.item_id()?,
+            owning_target: self.bazel_label()?,
+            source_loc: self.string()?,
+            underlying_type: self.mapped_type()?,
+            enumerators: self.vec(Self::enumerator)?,
+            enclosing_namespace_id: self.opt_item_id()?,
+        })
+    }
+
+    fn type_alias(&mut self) -> Result<TypeAlias> {
+        Ok(TypeAlias {
+            identifier: self.identifier()?,
+            id: self.item_id()?,
+            owning_target: self.bazel_label()?,
+            doc_comment: self.opt_string()?,
+            underlying_type: self.mapped_type()?,
+            source_loc: self.string()?,
+            enclosing_record_id: self.opt_item_id()?,
+            enclosing_namespace_id: self.opt_item_id()?,
+        })
+    }
+
+    fn unsupported_item(&mut self) -> Result<UnsupportedItem> {
+        Ok(UnsupportedItem {
+            name: self.string()?,
+            message: self.string()?,
+            source_loc: Some(self.string()?),
+            id: self.item_id()?,
+            cause: Default::default(),
+        })
+    }
+
+    fn comment(&mut self) -> Result<Comment> {
+        Ok(Comment { text: self.string()?, id: self.item_id()? })
+    }
+
+    fn namespace(&mut self) -> Result<Namespace> {
+        Ok(Namespace {
+            name: self.identifier()?,
+            id: self.item_id()?,
+            canonical_namespace_id: self.item_id()?,
+            owning_target: self.bazel_label()?,
+            child_item_ids: self.vec(Self::item_id)?,
+            enclosing_namespace_id: self.opt_item_id()?,
+            is_inline: self.bool()?,
+        })
+    }
+
+    fn use_mod(&mut self) -> Result<UseMod> {
+        Ok(UseMod { path: self.string()?, mod_name: self.identifier()?, id: self.item_id()? })
+    }
+
+    fn type_map_override(&mut self) -> Result<TypeMapOverride> {
+        Ok(TypeMapOverride {
+            rs_name: self.string()?,
+            cc_name: self.string()?,
+            owning_target: self.bazel_label()?,
+            size_align: self.option(Self::size_align)?,
+            is_same_abi: self.bool()?,
+            id: self.item_id()?,
+        })
+    }
+
+    fn item(&mut self) -> Result<Item> {
+        let tag = self.unsigned()?;
+        let len = self.len()?;
+        let end = self.pos + len;
+        // Tags are indices into the C++ `IR::Item` variant.
+        let item = match tag {
+            0 => Item::Func(Rc::new(self.func()?)),
+            1 => Item::Record(Rc::new(self.record()?)),
+            2 => Item::IncompleteRecord(Rc::new(self.incomplete_record()?)),
+            3 => Item::Enum(Rc::new(self.enum_()?)),
+            4 => Item::TypeAlias(Rc::new(self.type_alias()?)),
+            5 => Item::UnsupportedItem(Rc::new(self.unsupported_item()?)),
+            6 => Item::Comment(Rc::new(self.comment()?)),
+            7 => Item::Namespace(Rc::new(self.namespace()?)),
+            8 => Item::UseMod(Rc::new(self.use_mod()?)),
+            9 => Item::TypeMapOverride(Rc::new(self.type_map_override()?)),
+            other => bail!("Invalid item tag {other}"),
+        };
+        ensure!(self.pos == end, "Item with tag {tag} has a payload size mismatch");
+        Ok(item)
+    }
+
+    fn crubit_features(&mut self) -> Result<HashMap<BazelLabel, CrubitFeaturesIR>> {
+        let len = self.len()?;
+        let mut result = HashMap::with_capacity(len);
+        for _ in 0..len {
+            let target = self.bazel_label()?;
+            let mut features = flagset::FlagSet::<CrubitFeature>::default();
+            for feature in self.vec(Self::string)? {
+                features |= match &*feature {
+                    "experimental" => CrubitFeature::Experimental,
+                    "supported" => CrubitFeature::Supported,
+                    other => bail!("Unexpected Crubit feature: {other}"),
+                };
+            }
+            result.insert(target, CrubitFeaturesIR(features));
+        }
+        Ok(result)
+    }
+
+    fn flat_ir(mut self) -> Result<FlatIR> {
+        let flat_ir = FlatIR {
+            public_headers: self.vec(|d| Ok(HeaderName { name: d.string()? }))?,
+            current_target: self.bazel_label()?,
+            items: self.vec(Self::item)?,
+            top_level_item_ids: self.vec(Self::item_id)?,
+            crate_root_path: self.opt_string()?,
+            crubit_features: self.crubit_features()?,
+        };
+        ensure!(self.pos == self.bytes.len(), "Trailing bytes at offset {}", self.pos);
+        Ok(flat_ir)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// A minimal encoder mirroring `BinaryIrWriter` in `ir_binary.cc`, enough
+    /// to exercise the decoder without going through C++.
+    #[derive(Default)]
+    struct Encoder {
+        strings: Vec<String>,
+        /// The encodings of the types in the type table.
+        types: Vec<Vec<u8>>,
+        body: Vec<u8>,
+    }
+
+    impl Encoder {
+        fn unsigned(&mut self, mut value: u64) {
+            while value >= 0x80 {
+                self.body.push((value as u8 & 0x7f) | 0x80);
+                value >>= 7;
+            }
+            self.body.push(value as u8);
+        }
+        fn string(&mut self, s: &str) {
+            let idx = match self.strings.iter().position(|x| x == s) {
+                Some(idx) => idx,
+                None => {
+                    self.strings.push(s.to_string());
+                    self.strings.len() - 1
+                }
+            };
+            self.unsigned(idx as u64);
+        }
+        fn finish(self) -> Vec<u8> {
+            let mut out = Encoder::default();
+            out.body.extend_from_slice(MAGIC);
+            out.unsigned(SCHEMA_VERSION);
+            out.unsigned(self.strings.len() as u64);
+            for s in &self.strings {
+                out.unsigned(s.len() as u64);
+                out.body.extend_from_slice(s.as_bytes());
+            }
+            out.unsigned(self.types.len() as u64);
+            for ty in &self.types {
+                out.body.extend_from_slice(ty);
+            }
+            out.body.extend_from_slice(&self.body);
+            out.body
+        }
+    }
+
+    #[test]
+    fn test_empty_ir() {
+        let mut e = Encoder::default();
+        e.unsigned(1); // public_headers
+        e.string("foo/bar.h");
+        e.string("//foo:bar"); // current_target
+        e.unsigned(0); // items
+        e.unsigned(0); // top_level_item_ids
+        e.body.push(0); // crate_root_path
+        e.unsigned(1); // crubit_features
+        e.string("//foo:bar");
+        e.unsigned(1);
+        e.string("supported");
+        let ir = deserialize_ir_binary(&e.finish()).unwrap();
+        let expected = FlatIR {
+            public_headers: vec![HeaderName { name: "foo/bar.h".into() }],
+            current_target: "//foo:bar".into(),
+            top_level_item_ids: vec![],
+            items: vec![],
+            crate_root_path: None,
+            crubit_features: [(
+                BazelLabel::from("//foo:bar"),
+                CrubitFeaturesIR(CrubitFeature::Supported.into()),
+            )]
+            .into_iter()
+            .collect(),
+        };
+        assert_eq!(ir.flat_ir, expected);
+    }
+
+    #[test]
+    fn test_comment_item() {
+        let mut e = Encoder::default();
+        e.unsigned(0); // public_headers
+        e.string("//foo:bar"); // current_target
+        e.unsigned(1); // items
+        let mut payload = Encoder::default();
+        payload.unsigned(1); // text: index of "hello" in `e.strings`
+        payload.unsigned(300); // id
+        e.strings.push("hello".to_string());
+        e.unsigned(6); // Comment
+        e.unsigned(payload.body.len() as u64);
+        e.body.extend_from_slice(&payload.body);
+        e.unsigned(1); // top_level_item_ids
+        e.unsigned(300);
+        e.body.push(1); // crate_root_path
+        e.string("__cc_template_instantiations_rs_api");
+        e.unsigned(0); // crubit_features
+        let ir = deserialize_ir_binary(&e.finish()).unwrap();
+        assert_eq!(
+            ir.comments().map(|c| (&*c.text, c.id)).collect::<Vec<_>>(),
+            vec![("hello", ItemId::new_for_testing(300))]
+        );
+        assert_eq!(
+            ir.top_level_item_ids().copied().collect::<Vec<_>>(),
+            vec![ItemId::new_for_testing(300)]
+        );
+        assert_eq!(ir.crate_root_path().as_deref(), Some("__cc_template_instantiations_rs_api"));
+    }
+
+    #[test]
+    fn test_interned_mapped_type() {
+        let mut e = Encoder::default();
+        let mut ty = Encoder::default();
+        ty.body.push(1); // rs_type.name: index of "i32" in `e.strings`
+        ty.unsigned(0);
+        ty.unsigned(0); // rs_type.lifetime_args
+        ty.unsigned(0); // rs_type.type_args
+        ty.body.push(0); // rs_type.decl_id
+        ty.body.push(1); // cc_type.name: index of "int" in `e.strings`
+        ty.unsigned(1);
+        ty.body.push(0); // cc_type.is_const
+        ty.unsigned(0); // cc_type.type_args
+        ty.body.push(0); // cc_type.decl_id
+        e.strings.extend(["i32".to_string(), "int".to_string()]);
+        e.types.push(ty.body);
+        e.unsigned(0);
+        e.unsigned(0);
+        e.unsigned(1); // not in the type table
+        let bytes = e.finish();
+        let mut d = Decoder::new(&bytes).unwrap();
+        let first = d.mapped_type().unwrap();
+        assert_eq!(first.rs_type.name.as_deref(), Some("i32"));
+        assert_eq!(first.cc_type.name.as_deref(), Some("int"));
+        assert_eq!(d.mapped_type().unwrap(), first);
+        let err = d.mapped_type().unwrap_err();
+        assert!(format!("{err:#}").contains("Invalid type index 1"), "{err:#}");
+    }
+
+    #[test]
+    fn test_signed_roundtrip() {
+        for value in [0i64, 1, -1, 63, -64, i64::MAX, i64::MIN] {
+            let mut e = Encoder::default();
+            e.unsigned(((value as u64) << 1) ^ ((value >> 63) as u64));
+            let bytes = e.finish();
+            let mut d = Decoder::new(&bytes).unwrap();
+            assert_eq!(d.signed().unwrap(), value);
+        }
+    }
+
+    #[test]
+    fn test_bad_magic() {
+        let err = deserialize_ir_binary(b"{\"current_target\": \"//foo:bar\"}").unwrap_err();
+        assert!(format!("{err:#}").contains("bad magic"), "{err:#}");
+    }
+
+    #[test]
+    fn test_bad_version() {
+        let mut bytes = MAGIC.to_vec();
+        bytes.push(99);
+        let err = deserialize_ir_binary(&bytes).unwrap_err();
+        assert!(format!("{err:#}").contains("schema version 99"), "{err:#}");
+    }
+
+    #[test]
+    fn test_truncated() {
+        let mut e = Encoder::default();
+        e.unsigned(0);
+        e.string("//foo:bar");
+        e.unsigned(5); // items, but none follow
+        let err = deserialize_ir_binary(&e.finish()).unwrap_err();
+        assert!(format!("{err:#}").contains("Malformed binary IR"), "{err:#}");
+    }
+}
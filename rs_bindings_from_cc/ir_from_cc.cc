@@ -9,10 +9,12 @@
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
@@ -20,8 +22,17 @@
 #include "rs_bindings_from_cc/bazel_types.h"
 #include "rs_bindings_from_cc/frontend_action.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/stats.h"
+#include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/FrontendAction.h"
+#include "clang/Frontend/FrontendActions.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/ADT/IntrusiveRefCntPtr.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/xxhash.h"
 
 namespace crubit {
 
@@ -30,28 +41,130 @@ static constexpr absl::string_view kVirtualHeaderPath =
 static constexpr absl::string_view kVirtualInputPath =
     "ir_from_cc_virtual_input.cc";
 
+// Precompiled headers are built from an empty main file, with the headers
+// passed as `-include`s. The main file is recorded in the precompiled header
+// and validated when it is loaded, so `IrFromCc` recreates it identically.
+static constexpr absl::string_view kVirtualPrecompiledHeaderInputPath =
+    "ir_from_cc_virtual_precompiled_header_input.cc";
+
+// Returns the file system that clang reads from: `in_memory_file_system`
+// (with the virtual headers from `options` added to it) layered over
+// `options.file_system`, or over the real file system if there is none.
+static llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> CreateFileSystem(
+    const IrFromCcOptions& options,
+    llvm::IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem>
+        in_memory_file_system) {
+  auto overlay_file_system =
+      llvm::makeIntrusiveRefCnt<llvm::vfs::OverlayFileSystem>(
+          options.file_system != nullptr ? options.file_system
+                                         : llvm::vfs::getRealFileSystem());
+  overlay_file_system->pushOverlay(in_memory_file_system);
+
+  for (auto const& name_and_content :
+       options.virtual_headers_contents_for_testing) {
+    in_memory_file_system->addFile(
+        name_and_content.first.IncludePath(), 0,
+        llvm::MemoryBuffer::getMemBuffer(name_and_content.second));
+  }
+  in_memory_file_system->addFile(kVirtualPrecompiledHeaderInputPath, 0,
+                                 llvm::MemoryBuffer::getMemBuffer(""));
+  return overlay_file_system;
+}
+
+static std::vector<std::string> ClangArgs(const IrFromCcOptions& options) {
+  std::vector<std::string> args_as_strings = {
+      "-std=gnu++17",
+      // Parse non-doc comments that are used as documentation
+      "-fparse-all-comments"};
+  args_as_strings.insert(args_as_strings.end(), options.clang_args.begin(),
+                         options.clang_args.end());
+  return args_as_strings;
+}
+
+// Returns a `-D` argument that records the arguments among `args` that must
+// be the same for a precompiled header and the headers which use it: macros,
+// and language and target options (including the sysroot).
+//
+// Both `PrecompileHeaders` and `IrFromCc` pass it to Clang, which checks that
+// the macros of a precompiled header match the command line that loads it, and
+// rejects the precompiled header otherwise. Without it, a precompiled header
+// built for other arguments (e.g. for a different `-std`, or without a `-D`
+// that the headers test) would be loaded silently.
+//
+// Include paths and `-include` are left out: every target has its own, and the
+// precompiled header already contains the headers that it was built from.
+static std::string PrecompiledHeaderIdDefine(
+    absl::Span<const std::string> args) {
+  static constexpr absl::string_view kRelevantPrefixes[] = {
+      "-D", "-U", "-std", "-f", "-m", "-target", "--target", "--sysroot",
+      "-isysroot", "-nostd", "-x"};
+  // Per-target options which share a prefix with the ones above.
+  static constexpr absl::string_view kIgnoredPrefixes[] = {
+      "-fmodule-map-file=", "-fmodule-name="};
+  static constexpr absl::string_view kTakesValue[] = {
+      "-D", "-U", "-target", "--sysroot", "-isysroot", "-x"};
+  auto starts_with_any = [](const std::string& arg, const auto& prefixes) {
+    return absl::c_any_of(prefixes, [&](absl::string_view prefix) {
+      return absl::StartsWith(arg, prefix);
+    });
+  };
+  std::string id;
+  bool is_value = false;
+  for (const std::string& arg : args) {
+    if (is_value || (starts_with_any(arg, kRelevantPrefixes) &&
+                     !starts_with_any(arg, kIgnoredPrefixes))) {
+      absl::StrAppend(&id, arg, "\n");
+    }
+    is_value = !is_value && absl::c_linear_search(kTakesValue, arg);
+  }
+  return absl::StrCat("-D__CRUBIT_PRECOMPILED_HEADER_ID=",
+                      absl::Hex(llvm::xxHash64(id)));
+}
+
+namespace {
+
+// Writes the precompiled header to `output_path`, regardless of the output
+// file on the command line.
+class GeneratePrecompiledHeaderAction : public clang::GeneratePCHAction {
+ public:
+  explicit GeneratePrecompiledHeaderAction(absl::string_view output_path)
+      : output_path_(output_path) {}
+
+ protected:
+  bool BeginInvocation(clang::CompilerInstance& instance) override {
+    instance.getFrontendOpts().OutputFile = output_path_;
+    return clang::GeneratePCHAction::BeginInvocation(instance);
+  }
+
+ private:
+  std::string output_path_;
+};
+
+}  // namespace
+
 absl::StatusOr<IR> IrFromCc(IrFromCcOptions options) {
   // Caller should verify that the inputs are not empty.
   CHECK(!options.extra_source_code_for_testing.empty() ||
         !options.public_headers.empty() ||
         !options.extra_instantiations.empty());
 
-  clang::tooling::FileContentMappings file_contents;
-
-  for (auto const& name_and_content :
-       options.virtual_headers_contents_for_testing) {
-    file_contents.push_back({std::string(name_and_content.first.IncludePath()),
-                             name_and_content.second});
-  }
+  // The virtual input file and the virtual headers are layered over the file
+  // system we were given (or the real one), so that a caching file system can
+  // be shared across invocations.
+  auto in_memory_file_system =
+      llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> file_system =
+      CreateFileSystem(options, in_memory_file_system);
 
   // Tests may inject `extra_source_code_for_testing` - it needs to be appended
-  // to `public_headers` and exposed via `file_contents` virtual file system.
+  // to `public_headers` and exposed via the in-memory file system.
   std::vector<HeaderName> augmented_public_headers(
       options.public_headers.begin(), options.public_headers.end());
   if (!options.extra_source_code_for_testing.empty()) {
-    file_contents.push_back(
-        {std::string(kVirtualHeaderPath),
-         std::string(options.extra_source_code_for_testing)});
+    in_memory_file_system->addFile(
+        kVirtualHeaderPath, 0,
+        llvm::MemoryBuffer::getMemBuffer(
+            options.extra_source_code_for_testing));
     HeaderName header_name = HeaderName(std::string(kVirtualHeaderPath));
     augmented_public_headers.push_back(header_name);
     options.headers_to_targets.insert({header_name, options.current_target});
@@ -76,20 +189,46 @@ absl::StatusOr<IR> IrFromCc(IrFromCcOptions options) {
                               "}  // namespace $0\n",
                               kInstantiationsNamespaceName);
   }
-  std::vector<std::string> args_as_strings = {
-      "-std=gnu++17",
-      // Parse non-doc comments that are used as documentation
-      "-fparse-all-comments"};
-  args_as_strings.insert(args_as_strings.end(), options.clang_args.begin(),
-                         options.clang_args.end());
+  std::vector<std::string> args_as_strings = ClangArgs(options);
+  if (!options.precompiled_header.empty()) {
+    // `--do_nothing` writes an empty file instead of a precompiled header, in
+    // which case the headers are parsed from source.
+    llvm::ErrorOr<llvm::vfs::Status> status =
+        file_system->status(llvm::StringRef(options.precompiled_header.data(),
+                                            options.precompiled_header.size()));
+    if (!status || status->getSize() != 0) {
+      std::string id_define = PrecompiledHeaderIdDefine(args_as_strings);
+      args_as_strings.push_back("-include-pch");
+      args_as_strings.push_back(std::string(options.precompiled_header));
+      args_as_strings.push_back(std::move(id_define));
+    }
+  }
+
+  in_memory_file_system->addFile(
+      kVirtualInputPath, 0,
+      llvm::MemoryBuffer::getMemBuffer(virtual_input_file_content));
 
   Invocation invocation(options.current_target, augmented_public_headers,
                         options.headers_to_targets);
-  if (!clang::tooling::runToolOnCodeWithArgs(
-          std::make_unique<FrontendAction>(invocation),
-          virtual_input_file_content, args_as_strings, kVirtualInputPath,
-          "rs_bindings_from_cc",
-          std::make_shared<clang::PCHContainerOperations>(), file_contents)) {
+  invocation.stats_ = options.stats;
+  invocation.skip_dependency_function_bodies_ =
+      options.skip_dependency_function_bodies;
+  bool success;
+  {
+    Stats::Phase phase(options.stats, "Frontend");
+    success = clang::tooling::runToolOnCodeWithArgs(
+        std::make_unique<FrontendAction>(invocation),
+        virtual_input_file_content, file_system, args_as_strings,
+        kVirtualInputPath, "rs_bindings_from_cc",
+        std::make_shared<clang::PCHContainerOperations>());
+  }
+  if (!success) {
+    if (!options.precompiled_header.empty()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Could not compile header contents (the precompiled header ",
+          options.precompiled_header,
+          " is rejected if it was built with different Clang arguments)"));
+    }
     return absl::Status(absl::StatusCode::kInvalidArgument,
                         "Could not compile header contents");
   }
@@ -101,7 +240,7 @@ absl::StatusOr<IR> IrFromCc(IrFromCcOptions options) {
     // TODO(jeanpierreda): It'd be nice to give these human-readable names, e.g. the
     // name of the file without the `.rs`, but it's also annoying to handle name
     // collisions.
-    ItemId id(reinterpret_cast<uintptr_t>(&extra_source));
+    ItemId id = GenerateUseModItemId(extra_source);
     invocation.ir_.items.push_back(UseMod{
         .path = extra_source,
         .mod_name = Identifier(absl::StrCat("__crubit_mod_", i)),
@@ -111,7 +250,35 @@ absl::StatusOr<IR> IrFromCc(IrFromCcOptions options) {
     ++i;
   }
   invocation.ir_.crubit_features = std::move(options.crubit_features);
-  return invocation.ir_;
+  return std::move(invocation.ir_);
+}
+
+absl::Status PrecompileHeaders(const IrFromCcOptions& options,
+                               absl::string_view output_path) {
+  CHECK(!options.public_headers.empty());
+  CHECK(options.precompiled_header.empty());
+
+  auto in_memory_file_system =
+      llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> file_system =
+      CreateFileSystem(options, in_memory_file_system);
+
+  std::vector<std::string> args_as_strings = ClangArgs(options);
+  args_as_strings.push_back(PrecompiledHeaderIdDefine(args_as_strings));
+  for (const HeaderName& header_name : options.public_headers) {
+    args_as_strings.push_back("-include");
+    args_as_strings.push_back(std::string(header_name.IncludePath()));
+  }
+
+  if (!clang::tooling::runToolOnCodeWithArgs(
+          std::make_unique<GeneratePrecompiledHeaderAction>(output_path), "",
+          file_system, args_as_strings, kVirtualPrecompiledHeaderInputPath,
+          "rs_bindings_from_cc",
+          std::make_shared<clang::PCHContainerOperations>())) {
+    return absl::Status(absl::StatusCode::kInvalidArgument,
+                        "Could not precompile header contents");
+  }
+  return absl::OkStatus();
 }
 
 }  // namespace crubit
@@ -10,11 +10,15 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "rs_bindings_from_cc/bazel_types.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/stats.h"
+#include "llvm/ADT/IntrusiveRefCntPtr.h"
+#include "llvm/Support/VirtualFileSystem.h"
 
 namespace crubit {
 
@@ -40,6 +44,12 @@ struct IrFromCcOptions final {
   absl::Span<const std::string> extra_instantiations = {};
   absl::flat_hash_map<BazelLabel, absl::flat_hash_set<std::string>>
       crubit_features = {};
+  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> file_system = nullptr;
+  absl::string_view precompiled_header = "";
+  bool skip_dependency_function_bodies = false;
+  // Where to record the time spent parsing and importing the headers, if
+  // anywhere.
+  Stats* stats = nullptr;
 
   // Not an argument, just here to prevent the options struct from being
   // copied/moved with nontrivial lifetime implications.
@@ -72,9 +82,33 @@ static_assert(std::is_aggregate_v<IrFromCcOptions>);
 // * `extra_instantiations`: names of full C++ class template specializations
 //   to instantiate and generate bindings from.
 // * `crubit_features`: The set of Crubit features to enable for each target.
+// * `file_system`: The file system from which headers are read. If not
+//   specified, the real file system is used.
+// * `precompiled_header`: Path to a precompiled header written by
+//   `PrecompileHeaders`, typically for the headers of the dependencies. Its
+//   headers are loaded from the precompiled header instead of being parsed.
+//   The precompiled header must have been built with the same macro, language
+//   and target arguments in `clang_args` (include paths may differ), or the
+//   import fails.
+//   An empty file is ignored (this is what `--do_nothing` writes).
+// * `skip_dependency_function_bodies`: If true, the bodies of functions from
+//   headers that aren't owned by `current_target` are not parsed, which makes
+//   parsing headers with a lot of inline code faster. Clang still parses the
+//   bodies of constexpr functions and of functions with a deduced return type.
+// * `stats`: If not null, records the time spent in Clang's frontend, which
+//   includes the nested `Importer::Import` phase.
 //
 absl::StatusOr<IR> IrFromCc(IrFromCcOptions options);
 
+// Parses the `public_headers` in `options` and writes them to `output_path` as
+// a precompiled header, which can then be passed to `IrFromCc` as
+// `precompiled_header`.
+//
+// Only `public_headers`, `virtual_headers_contents_for_testing`, `clang_args`,
+// and `file_system` are used.
+absl::Status PrecompileHeaders(const IrFromCcOptions& options,
+                               absl::string_view output_path);
+
 }  // namespace crubit
 
 #endif  // CRUBIT_RS_BINDINGS_FROM_CC_IR_FROM_CC_H_
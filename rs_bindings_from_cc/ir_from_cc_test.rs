@@ -91,6 +91,23 @@ fn test_function() {
                 id: ItemId(...),
                 enclosing_namespace_id: None,
                 adl_enclosing_record: None,
+                trivial_field_accessor: None,
+                has_batch_thunk: false,
+            }
+        }
+    );
+}
+
+#[test]
+fn test_function_with_batch_thunk() {
+    let ir =
+        ir_from_cc(r#"[[clang::annotate("crubit_internal_batch_thunk")]] int f(int x);"#).unwrap();
+    assert_ir_matches!(
+        ir,
+        quote! {
+            Func {
+                name: "f", ...
+                has_batch_thunk: true, ...
             }
         }
     );
@@ -609,6 +626,61 @@ fn test_record_private_static_member_functions_not_present() {
     assert_ir_not_matches!(ir, quote! { Func { name: "private_method" ... } });
 }
 
+#[test]
+fn test_trivial_field_accessors() {
+    let ir = ir_from_cc(
+        "
+        struct SomeStruct {
+            int get_field() const { return field; }
+            void set_field(int value) { field = value; }
+            int get_field_plus_one() const { return field + 1; }
+            void set_field_twice(int value) { field = value; field = value; }
+            const int& get_field_ref() const { return field; }
+            int get_bitfield() const { return bitfield; }
+            int get_out_of_line() const;
+            int field;
+            int bitfield : 3;
+        };
+        inline int SomeStruct::get_out_of_line() const { return field; }
+    ",
+    )
+    .unwrap();
+
+    assert_ir_matches!(
+        ir,
+        quote! {
+            Func {
+                name: "get_field", ...
+                trivial_field_accessor: Some(TrivialFieldAccessor { kind: Getter, field: "field" }), ...
+            }
+        }
+    );
+    assert_ir_matches!(
+        ir,
+        quote! {
+            Func {
+                name: "set_field", ...
+                trivial_field_accessor: Some(TrivialFieldAccessor { kind: Setter, field: "field" }), ...
+            }
+        }
+    );
+    assert_ir_matches!(
+        ir,
+        quote! {
+            Func {
+                name: "get_out_of_line", ...
+                trivial_field_accessor: Some(TrivialFieldAccessor { kind: Getter, field: "field" }), ...
+            }
+        }
+    );
+    for name in ["get_field_plus_one", "set_field_twice", "get_field_ref", "get_bitfield"] {
+        assert_ir_matches!(
+            ir,
+            quote! { Func { name: #name, ... trivial_field_accessor: None, ... } }
+        );
+    }
+}
+
 #[test]
 fn test_record_special_member_access_specifiers() {
     let ir = ir_from_cc(
@@ -973,6 +1045,257 @@ fn test_type_conversion() -> Result<()> {
     Ok(())
 }
 
+#[test]
+fn test_span_type() -> Result<()> {
+    let ir = ir_from_cc(
+        r#"
+            namespace absl {
+            template <typename T>
+            class Span {
+              T* ptr_;
+              decltype(sizeof(0)) len_;
+            };
+            }  // namespace absl
+            int Sum(absl::Span<const int> values);
+        "#,
+    )?;
+    assert_ir_matches!(
+        ir,
+        quote! {
+          Func {
+            name: "Sum", ...
+            params: [FuncParam {
+              type_: MappedType {
+                rs_type: RsType {
+                  name: Some("::cc_std::Span"),
+                  lifetime_args: [],
+                  type_args: [RsType { name: Some("::core::ffi::c_int"), ... }],
+                  decl_id: None,
+                },
+                cc_type: CcType {
+                  name: Some("absl::Span<const int>"),
+                  is_const: false,
+                  type_args: [],
+                  decl_id: None,
+                },
+              },
+              identifier: "values",
+            }], ...
+          }
+        }
+    );
+    Ok(())
+}
+
+#[test]
+fn test_span_type_with_static_extent() -> Result<()> {
+    let ir = ir_from_cc(
+        r#"
+            namespace std {
+            template <typename T, decltype(sizeof(0)) Extent>
+            class span {
+              T* data_;
+            };
+            }  // namespace std
+            int Sum(std::span<const int, 4> values);
+        "#,
+    )?;
+    assert_ir_not_matches!(ir, quote! { "::cc_std::Span" });
+    Ok(())
+}
+
+#[test]
+fn test_span_type_with_other_layout() -> Result<()> {
+    let ir = ir_from_cc(
+        r#"
+            namespace absl {
+            template <typename T>
+            class Span {
+              decltype(sizeof(0)) len_;
+              T* ptr_;
+            };
+            }  // namespace absl
+            int Sum(absl::Span<const int> values);
+        "#,
+    )?;
+    assert_ir_not_matches!(ir, quote! { "::cc_std::Span" });
+    Ok(())
+}
+
+#[test]
+fn test_vector_type() -> Result<()> {
+    let ir = ir_from_cc(
+        r#"
+            namespace std {
+            template <typename T>
+            class allocator {};
+            template <typename T, typename Alloc = allocator<T>>
+            class vector {
+              T* __begin_;
+              T* __end_;
+              T* __end_cap_;
+            };
+            }  // namespace std
+            int Sum(const std::vector<int>& values);
+            int SumCopy(std::vector<int> values);
+        "#,
+    )?;
+    assert_ir_matches!(
+        ir,
+        quote! {
+          Func {
+            name: "Sum", ...
+            params: [FuncParam {
+              type_: MappedType {
+                rs_type: RsType {
+                  name: Some("*const"), ...
+                  type_args: [RsType {
+                    name: Some("::cc_std::Vector"),
+                    lifetime_args: [],
+                    type_args: [RsType { name: Some("::core::ffi::c_int"), ... }],
+                    decl_id: None,
+                  }], ...
+                },
+                cc_type: CcType {
+                  name: Some("&"), ...
+                  type_args: [CcType {
+                    name: Some("std::vector<int, std::allocator<int>>"),
+                    is_const: true,
+                    type_args: [],
+                    decl_id: None,
+                  }], ...
+                },
+              },
+              identifier: "values",
+            }], ...
+          }
+        }
+    );
+    // Vectors passed by value are imported like other class template
+    // specializations, because Rust can't destroy them.
+    assert_ir_not_matches!(ir, quote! { Func { name: "SumCopy", ... "::cc_std::Vector" ... } });
+    Ok(())
+}
+
+#[test]
+fn test_vector_type_with_other_layout() -> Result<()> {
+    // Vectors which don't have the member order of libc++, e.g. those of
+    // libstdc++ or a vector that stores its size, aren't mapped to
+    // `cc_std::Vector`.
+    let ir = ir_from_cc(
+        r#"
+            namespace std {
+            template <typename T>
+            class allocator {};
+            template <typename T, typename Alloc = allocator<T>>
+            class vector {
+              T* __begin_;
+              decltype(sizeof(0)) __size_;
+              decltype(sizeof(0)) __capacity_;
+            };
+            }  // namespace std
+            int Sum(const std::vector<int>& values);
+        "#,
+    )?;
+    assert_ir_not_matches!(ir, quote! { "::cc_std::Vector" });
+    Ok(())
+}
+
+/// A `std::string` with the declarations of libc++ (with ABI version 1) that
+/// the importer checks for the layout of `cc_std::StdString`.
+const LIBCPP_STRING: &str = r#"
+    #define _LIBCPP_VERSION 170000
+    namespace std {
+    inline namespace __1 {
+    template <typename T>
+    class allocator {};
+    template <typename T>
+    struct char_traits {};
+    template <typename T, typename Traits = char_traits<T>,
+              typename Alloc = allocator<T>>
+    class basic_string {
+      void* words_[3];
+    };
+    using string = basic_string<char>;
+    using wstring = basic_string<wchar_t>;
+    }  // namespace __1
+    }  // namespace std
+"#;
+
+#[test]
+fn test_string_type() -> Result<()> {
+    let ir = ir_from_cc(&format!(
+        r#"
+            {LIBCPP_STRING}
+            void Append(std::string& s);
+            void AppendWide(std::wstring& s);
+        "#,
+    ))?;
+    assert_ir_matches!(
+        ir,
+        quote! {
+          Func {
+            name: "Append", ...
+            params: [FuncParam {
+              type_: MappedType {
+                rs_type: RsType {
+                  name: Some("*mut"), ...
+                  type_args: [RsType {
+                    name: Some("::cc_std::StdString"),
+                    lifetime_args: [],
+                    type_args: [],
+                    decl_id: None,
+                  }], ...
+                },
+                cc_type: CcType {
+                  name: Some("&"), ...
+                  type_args: [CcType {
+                    name: Some("std::basic_string<char, std::char_traits<char>, std::allocator<char>>"),
+                    is_const: false,
+                    type_args: [],
+                    decl_id: None,
+                  }], ...
+                },
+              },
+              identifier: "s",
+            }], ...
+          }
+        }
+    );
+    // Only `char` strings have the layout of `cc_std::StdString`.
+    assert_ir_not_matches!(
+        ir,
+        quote! { Func { name: "AppendWide", ... "::cc_std::StdString" ... } }
+    );
+    Ok(())
+}
+
+#[test]
+fn test_string_type_with_other_layout() -> Result<()> {
+    // Strings of other standard libraries, e.g. libstdc++, don't have the layout
+    // of `cc_std::StdString`.
+    let ir = ir_from_cc(&LIBCPP_STRING.replace("#define _LIBCPP_VERSION", "#define VERSION"))?;
+    assert_ir_not_matches!(ir, quote! { "::cc_std::StdString" });
+
+    // Neither do the strings of libc++ with the alternate layout ...
+    let ir = ir_from_cc(&format!(
+        r#"
+            #define _LIBCPP_ABI_ALTERNATE_STRING_LAYOUT
+            {LIBCPP_STRING}
+            void Append(std::string& s);
+        "#,
+    ))?;
+    assert_ir_not_matches!(ir, quote! { "::cc_std::StdString" });
+
+    // ... including the strings of later ABI versions.
+    let ir = ir_from_cc(&format!(
+        "{}\nvoid Append(std::string& s);",
+        LIBCPP_STRING.replace("__1", "__2")
+    ))?;
+    assert_ir_not_matches!(ir, quote! { "::cc_std::StdString" });
+    Ok(())
+}
+
 #[test]
 fn test_typedef() -> Result<()> {
     let ir = ir_from_cc(
@@ -1742,6 +2065,34 @@ fn test_fully_instantiated_template_in_private_field() -> Result<()> {
     Ok(())
 }
 
+#[test]
+fn test_private_field_type_with_import_private_fields() -> Result<()> {
+    let ir = ir_from_cc(
+        r#" #pragma clang lifetime_elision
+            class [[clang::annotate("crubit_internal_import_private_fields")]] MyStruct {
+             private:
+              int private_field_;
+            }; "#,
+    )?;
+    assert_ir_matches!(
+        ir,
+        quote! {
+               Record {
+                   rs_name: "MyStruct", ...
+                   fields: [Field {
+                       identifier: Some("private_field_"), ...
+                       type_: Ok(MappedType {
+                           rs_type: RsType { name: Some("::core::ffi::c_int"), ... },
+                           cc_type: CcType { name: Some("int"), ... },
+                       }), ...
+                       access: Private, ...
+                   }], ...
+               }
+        }
+    );
+    Ok(())
+}
+
 #[test]
 fn test_template_with_decltype_and_with_auto() -> Result<()> {
     let ir = ir_from_cc(
@@ -2763,6 +3114,7 @@ fn test_member_function() {
             reference: ir::ReferenceQualification::Unqualified,
             is_const: false,
             is_virtual: false,
+            is_final: false,
         }),
     );
 }
@@ -2776,6 +3128,7 @@ fn test_member_function_const() {
             reference: ir::ReferenceQualification::Unqualified,
             is_const: true,
             is_virtual: false,
+            is_final: false,
         }),
     );
 }
@@ -2789,6 +3142,37 @@ fn test_member_function_virtual() {
             reference: ir::ReferenceQualification::Unqualified,
             is_const: false,
             is_virtual: true,
+            is_final: false,
+        }),
+    );
+}
+
+#[test]
+fn test_member_function_virtual_final() {
+    assert_member_function_has_instance_method_metadata(
+        "Function",
+        "virtual void Function() final;",
+        &Some(ir::InstanceMethodMetadata {
+            reference: ir::ReferenceQualification::Unqualified,
+            is_const: false,
+            is_virtual: true,
+            is_final: true,
+        }),
+    );
+}
+
+#[test]
+fn test_member_function_of_final_class() {
+    let ir = ir_from_cc("struct Struct final { virtual void Function(); };").unwrap();
+    assert_member_function_with_predicate_has_instance_method_metadata(
+        &ir,
+        "Struct",
+        |f| f.name == UnqualifiedIdentifier::Identifier(ir_id("Function")),
+        &Some(ir::InstanceMethodMetadata {
+            reference: ir::ReferenceQualification::Unqualified,
+            is_const: false,
+            is_virtual: true,
+            is_final: true,
         }),
     );
 }
@@ -2802,6 +3186,7 @@ fn test_member_function_lvalue() {
             reference: ir::ReferenceQualification::LValue,
             is_const: false,
             is_virtual: false,
+            is_final: false,
         }),
     );
 }
@@ -2815,6 +3200,7 @@ fn test_member_function_rvalue() {
             reference: ir::ReferenceQualification::RValue,
             is_const: false,
             is_virtual: false,
+            is_final: false,
         }),
     );
 }
@@ -2870,6 +3256,7 @@ fn test_member_function_explicit_constructor() {
             reference: ir::ReferenceQualification::Unqualified,
             is_const: false,
             is_virtual: false,
+            is_final: false,
         }),
     );
 }
@@ -2892,6 +3279,7 @@ fn test_member_function_constructor() {
                 reference: ir::ReferenceQualification::Unqualified,
                 is_const: false,
                 is_virtual: false,
+                is_final: false,
             }),
         );
     }
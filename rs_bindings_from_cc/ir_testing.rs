@@ -61,6 +61,22 @@ pub fn make_ir_from_items(items: impl IntoIterator<Item = Item>) -> IR {
     ir
 }
 
+/// Like `ir_from_cc`, but the current target, which owns the items of
+/// `header_source`, is `target` instead of `TESTING_TARGET`.
+pub fn ir_from_cc_in_target(
+    platform: multiplatform_testing::Platform,
+    header_source: &str,
+    target: &str,
+) -> Result<IR> {
+    let json =
+        ir_bytes_from_cc_dependency(IrEncoding::Json, platform, header_source, "// empty header");
+    let json = String::from_utf8(json.into_vec())?
+        .replace(&format!("\"{TESTING_TARGET}\""), &format!("\"{target}\""));
+    let mut ir = ir::deserialize_ir(json.as_bytes())?;
+    update_test_ir(&mut ir);
+    Ok(ir)
+}
+
 /// Target of the dependency used by `ir_from_cc_dependency`.
 /// Needs to be kept in sync with `kDependencyTarget` in `json_from_cc.cc`.
 pub const DEPENDENCY_TARGET: &str = "//test:dependency";
@@ -75,6 +91,31 @@ pub fn ir_from_cc_dependency(
     header_source: &str,
     dependency_header_source: &str,
 ) -> Result<IR> {
+    let mut ir = ir::deserialize_ir_binary(&ir_bytes_from_cc_dependency(
+        IrEncoding::Binary,
+        platform,
+        header_source,
+        dependency_header_source,
+    ))?;
+    update_test_ir(&mut ir);
+    Ok(ir)
+}
+
+/// How `ir_bytes_from_cc_dependency` should serialize the IR.
+#[derive(Clone, Copy, Debug)]
+enum IrEncoding {
+    Json,
+    Binary,
+}
+
+/// Runs the importer over `header_source` (see `ir_from_cc_dependency`) and
+/// returns the serialized IR.
+fn ir_bytes_from_cc_dependency(
+    encoding: IrEncoding,
+    platform: multiplatform_testing::Platform,
+    header_source: &str,
+    dependency_header_source: &str,
+) -> Box<[u8]> {
     const DEPENDENCY_HEADER_NAME: &str = "test/dependency_header.h";
 
     extern "C" {
@@ -83,23 +124,29 @@ pub fn ir_from_cc_dependency(
             header_source: FfiU8Slice,
             dependency_header_source: FfiU8Slice,
         ) -> FfiU8SliceBox;
+        fn binary_ir_from_cc_dependency(
+            target_triple: FfiU8Slice,
+            header_source: FfiU8Slice,
+            dependency_header_source: FfiU8Slice,
+        ) -> FfiU8SliceBox;
     }
 
     let header_source_with_include =
         format!("#include \"{}\"\n\n{}", DEPENDENCY_HEADER_NAME, header_source);
     let header_source_with_include_u8 = header_source_with_include.as_bytes();
     let dependency_header_source_u8 = dependency_header_source.as_bytes();
-    let json_utf8 = unsafe {
-        json_from_cc_dependency(
+    let ir_from_cc_fn = match encoding {
+        IrEncoding::Json => json_from_cc_dependency,
+        IrEncoding::Binary => binary_ir_from_cc_dependency,
+    };
+    unsafe {
+        ir_from_cc_fn(
             FfiU8Slice::from_slice(platform.target_triple().as_ref()),
             FfiU8Slice::from_slice(header_source_with_include_u8),
             FfiU8Slice::from_slice(dependency_header_source_u8),
         )
         .into_boxed_slice()
-    };
-    let mut ir = ir::deserialize_ir(&*json_utf8)?;
-    update_test_ir(&mut ir);
-    Ok(ir)
+    }
 }
 
 /// Creates an identifier
@@ -189,4 +236,56 @@ mod tests {
         r2.id = ItemId::new_for_testing(42);
         let _ = make_ir_from_items([r1.into(), r2.into()]);
     }
+
+    /// The binary IR handed to the code generator must decode to exactly the
+    /// same `IR` as the JSON used for `--ir_out`.
+    #[test]
+    fn test_binary_ir_matches_json_ir() -> Result<()> {
+        let header = with_lifetime_macros(
+            r#"
+            // Free comment.
+
+            struct Incomplete;
+            namespace ns {
+            inline namespace inner {
+            /// Doc comment.
+            struct Base {
+              virtual ~Base();
+              virtual int Method() const &;
+              int* field;
+            };
+            }  // namespace inner
+            }  // namespace ns
+
+            class Derived final : public ns::Base {
+             public:
+              Derived(int);
+              Derived& operator=(Derived&&);
+              int Method() const & override;
+              using Alias = int;
+             private:
+              [[no_unique_address]] struct {} empty;
+              unsigned bits : 3;
+              long long value;
+            };
+
+            enum class Color : unsigned char { kRed = 1, kBlue = 255 };
+            enum Signed { kNegative = -42 };
+            template <typename T> struct Template { T t; };
+            using Instantiation = Template<int>;
+            void Unsupported(int (&array)[3]);
+            int& $a Identity(int& $a x);
+            void (*fn_ptr)(int);
+            "#,
+        );
+        let platform = multiplatform_testing::Platform::X86Linux;
+        let json = ir_bytes_from_cc_dependency(IrEncoding::Json, platform, &header, "");
+        let binary = ir_bytes_from_cc_dependency(IrEncoding::Binary, platform, &header, "");
+        assert!(binary.len() < json.len());
+        let json_ir = ir::deserialize_ir(&*json)?;
+        let binary_ir = ir::deserialize_ir_binary(&binary)?;
+        assert_eq!(json_ir.flat_ir_debug_print(), binary_ir.flat_ir_debug_print());
+        assert_eq!(json_ir, binary_ir);
+        Ok(())
+    }
 }
@@ -3,11 +3,13 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include <string>
+#include <utility>
 
 #include "absl/status/statusor.h"
 #include "common/ffi_types.h"
 #include "rs_bindings_from_cc/bazel_types.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/ir_binary.h"
 #include "rs_bindings_from_cc/ir_from_cc.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FormatVariadic.h"
@@ -22,10 +24,9 @@ static constexpr absl::string_view kDependencyHeaderName =
     "test/dependency_header.h";
 // LINT.ThenChange(//depot/rs_bindings_from_cc/ir_testing.rs)
 
-// This is intended to be called from Rust tests.
-extern "C" FfiU8SliceBox json_from_cc_dependency(
-    FfiU8Slice target_triple, FfiU8Slice header_source,
-    FfiU8Slice dependency_header_source) {
+static IR IrFromCcDependency(FfiU8Slice target_triple,
+                             FfiU8Slice header_source,
+                             FfiU8Slice dependency_header_source) {
   absl::StatusOr<IR> ir = IrFromCc(
       {.extra_source_code_for_testing = StringViewFromFfiU8Slice(header_source),
        .current_target = BazelLabel{"//test:testing_target"},
@@ -44,8 +45,28 @@ extern "C" FfiU8SliceBox json_from_cc_dependency(
     llvm::report_fatal_error(llvm::formatv("IrFromCc reported an error: {0}",
                                            ir.status().message()));
   }
-  std::string json = llvm::formatv("{0}", ir->ToJson());
+  return *std::move(ir);
+}
+
+// This is intended to be called from Rust tests.
+extern "C" FfiU8SliceBox json_from_cc_dependency(
+    FfiU8Slice target_triple, FfiU8Slice header_source,
+    FfiU8Slice dependency_header_source) {
+  IR ir = IrFromCcDependency(target_triple, header_source,
+                             dependency_header_source);
+  std::string json = llvm::formatv("{0}", ir.ToJson());
   return AllocFfiU8SliceBox(MakeFfiU8Slice(json));
 }
 
+// Same as `json_from_cc_dependency`, but returns the binary encoding of the IR
+// (see `ir_binary.h`). This is intended to be called from Rust tests.
+extern "C" FfiU8SliceBox binary_ir_from_cc_dependency(
+    FfiU8Slice target_triple, FfiU8Slice header_source,
+    FfiU8Slice dependency_header_source) {
+  IR ir = IrFromCcDependency(target_triple, header_source,
+                             dependency_header_source);
+  std::string binary_ir = IrToBinary(ir);
+  return AllocFfiU8SliceBox(MakeFfiU8Slice(binary_ir));
+}
+
 }  // namespace crubit
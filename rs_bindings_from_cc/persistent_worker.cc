@@ -0,0 +1,211 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/persistent_worker.h"
+
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/commandlineflag.h"
+#include "absl/flags/reflection.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace crubit {
+
+absl::StatusOr<WorkRequest> ParseWorkRequest(absl::string_view json) {
+  llvm::Expected<llvm::json::Value> value =
+      llvm::json::parse(llvm::StringRef(json.data(), json.size()));
+  if (!value) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Malformed work request: ", llvm::toString(value.takeError())));
+  }
+  const llvm::json::Object* object = value->getAsObject();
+  if (object == nullptr) {
+    return absl::InvalidArgumentError("Work request is not a JSON object");
+  }
+
+  WorkRequest request;
+  if (const llvm::json::Array* arguments = object->getArray("arguments")) {
+    for (const llvm::json::Value& argument : *arguments) {
+      auto str = argument.getAsString();
+      if (!str) {
+        return absl::InvalidArgumentError(
+            "Work request arguments must be strings");
+      }
+      request.arguments.push_back(str->str());
+    }
+  }
+  if (const llvm::json::Array* inputs = object->getArray("inputs")) {
+    for (const llvm::json::Value& input : *inputs) {
+      const llvm::json::Object* input_object = input.getAsObject();
+      if (input_object == nullptr || !input_object->getString("path")) {
+        return absl::InvalidArgumentError(
+            "Work request inputs must have a path");
+      }
+      auto digest = input_object->getString("digest");
+      request.input_digests.insert_or_assign(
+          input_object->getString("path")->str(),
+          digest ? digest->str() : "");
+    }
+  }
+  if (auto request_id = object->getInteger("requestId")) {
+    request.request_id = *request_id;
+  }
+  return request;
+}
+
+absl::StatusOr<std::vector<std::string>> ParseFlags(
+    absl::Span<const std::string> arguments) {
+  std::vector<std::string> positional_arguments;
+  for (size_t i = 0; i < arguments.size(); ++i) {
+    absl::string_view argument = arguments[i];
+    if (argument == "--") {
+      positional_arguments.insert(positional_arguments.end(),
+                                  arguments.begin() + i + 1, arguments.end());
+      break;
+    }
+    if (argument.size() < 2 || argument[0] != '-') {
+      positional_arguments.push_back(std::string(argument));
+      continue;
+    }
+    argument.remove_prefix(absl::StartsWith(argument, "--") ? 2 : 1);
+
+    absl::string_view name = argument;
+    std::optional<absl::string_view> value;
+    if (size_t equals = argument.find('='); equals != argument.npos) {
+      name = argument.substr(0, equals);
+      value = argument.substr(equals + 1);
+    }
+    absl::CommandLineFlag* flag = absl::FindCommandLineFlag(name);
+    if (flag == nullptr && !value.has_value() &&
+        absl::StartsWith(name, "no")) {
+      flag = absl::FindCommandLineFlag(name.substr(2));
+      if (flag != nullptr && flag->IsOfType<bool>()) {
+        value = "false";
+      } else {
+        flag = nullptr;
+      }
+    }
+    if (flag == nullptr) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unknown command line flag '", name, "'"));
+    }
+    if (name == "flagfile" || name == "fromenv" || name == "tryfromenv") {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Flag '", name, "' is not supported in work requests"));
+    }
+    if (!value.has_value()) {
+      if (flag->IsOfType<bool>()) {
+        value = "true";
+      } else if (i + 1 < arguments.size()) {
+        value = arguments[++i];
+      } else {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Missing the value for flag '", name, "'"));
+      }
+    }
+    std::string error;
+    if (!flag->ParseFrom(*value, &error)) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Illegal value '", *value, "' specified for flag '", name, "'; ",
+          error));
+    }
+  }
+  return positional_arguments;
+}
+
+std::string SerializeWorkResponse(int64_t request_id, int exit_code,
+                                  absl::string_view output) {
+  llvm::json::Object response;
+  response["exitCode"] = exit_code;
+  response["output"] = std::string(output);
+  response["requestId"] = request_id;
+  std::string result;
+  llvm::raw_string_ostream os(result);
+  os << llvm::json::Value(std::move(response));
+  os.flush();
+  return result;
+}
+
+namespace {
+
+// Runs `function` with stderr redirected to a temporary file, and returns
+// what it wrote to stderr in `captured`. If stderr can't be redirected,
+// `function` is run anyway and `captured` is left empty.
+absl::Status RunCapturingStderr(absl::FunctionRef<absl::Status()> function,
+                                std::string& captured) {
+  auto flush_stderr = [] {
+    llvm::errs().flush();
+    std::cerr.flush();
+    std::fflush(stderr);
+  };
+  std::FILE* file = std::tmpfile();
+  if (file == nullptr) return function();
+  flush_stderr();
+  int saved_stderr = dup(STDERR_FILENO);
+  if (saved_stderr < 0 || dup2(fileno(file), STDERR_FILENO) < 0) {
+    if (saved_stderr >= 0) close(saved_stderr);
+    std::fclose(file);
+    return function();
+  }
+
+  absl::Status status = function();
+
+  flush_stderr();
+  dup2(saved_stderr, STDERR_FILENO);
+  close(saved_stderr);
+  std::rewind(file);
+  char buffer[4096];
+  while (size_t size = std::fread(buffer, 1, sizeof(buffer), file)) {
+    captured.append(buffer, size);
+  }
+  std::fclose(file);
+  return status;
+}
+
+}  // namespace
+
+void RunPersistentWorker(
+    std::istream& in, std::ostream& out,
+    absl::FunctionRef<absl::Status(const WorkRequest&)> handler) {
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty()) continue;
+    absl::StatusOr<WorkRequest> request = ParseWorkRequest(line);
+    std::string output;
+    absl::Status status =
+        request.ok()
+            ? RunCapturingStderr([&] { return handler(*request); }, output)
+            : std::move(request).status();
+    if (!status.ok()) {
+      if (!output.empty() && output.back() != '\n') output += '\n';
+      absl::StrAppend(&output, status.message());
+    }
+    out << SerializeWorkResponse(request.ok() ? request->request_id : 0,
+                                 status.ok() ? 0 : 1, output)
+        << std::endl;
+  }
+}
+
+}  // namespace crubit
@@ -0,0 +1,68 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CRUBIT_RS_BINDINGS_FROM_CC_PERSISTENT_WORKER_H_
+#define CRUBIT_RS_BINDINGS_FROM_CC_PERSISTENT_WORKER_H_
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
+namespace crubit {
+
+// A single request sent by Bazel to a persistent worker, using the JSON worker
+// protocol (https://bazel.build/remote/creating).
+struct WorkRequest {
+  // Command line arguments for this request, as if the tool had been run
+  // directly (minus `argv[0]`).
+  std::vector<std::string> arguments;
+  // Maps the paths of the inputs of the action to their digests.
+  absl::flat_hash_map<std::string, std::string> input_digests;
+  // Zero for singleplex workers.
+  int64_t request_id = 0;
+};
+
+// Parses one line of the JSON worker protocol into a `WorkRequest`.
+absl::StatusOr<WorkRequest> ParseWorkRequest(absl::string_view json);
+
+// Sets the Abseil flags in `arguments` (`--name=value`, `--name value`,
+// `--name` and `--noname` for booleans), and returns the positional arguments.
+//
+// Unlike `absl::ParseCommandLine`, which exits the process on a malformed or
+// unknown flag, this returns an error, so that a bad request doesn't take the
+// worker down with it. `--flagfile` and friends aren't supported.
+absl::StatusOr<std::vector<std::string>> ParseFlags(
+    absl::Span<const std::string> arguments);
+
+// Returns the JSON worker protocol line (without the trailing newline) that
+// reports the result of the request `request_id`.
+std::string SerializeWorkResponse(int64_t request_id, int exit_code,
+                                  absl::string_view output);
+
+// Reads newline-delimited work requests from `in` until it is closed, runs
+// `handler` on each of them, and writes one response per request to `out`.
+//
+// Everything that `handler` writes to stderr (e.g. Clang's diagnostics) is
+// captured and sent back as the output of the request, since Bazel only shows
+// the output of the response to the user.
+//
+// A request that fails, or can't be parsed, is reported to Bazel with a
+// non-zero exit code and the error message as its output; the worker keeps
+// serving subsequent requests.
+void RunPersistentWorker(
+    std::istream& in, std::ostream& out,
+    absl::FunctionRef<absl::Status(const WorkRequest&)> handler);
+
+}  // namespace crubit
+
+#endif  // CRUBIT_RS_BINDINGS_FROM_CC_PERSISTENT_WORKER_H_
@@ -0,0 +1,162 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/persistent_worker.h"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/flags/flag.h"
+#include "absl/flags/reflection.h"
+#include "absl/status/status.h"
+#include "common/status_test_matchers.h"
+
+ABSL_FLAG(std::string, persistent_worker_test_string, "",
+          "A string flag for ParseFlags tests.");
+ABSL_FLAG(bool, persistent_worker_test_bool, false,
+          "A bool flag for ParseFlags tests.");
+
+namespace crubit {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+TEST(PersistentWorkerTest, ParseWorkRequest) {
+  ASSERT_OK_AND_ASSIGN(
+      WorkRequest request,
+      ParseWorkRequest(
+          R"({"arguments": ["--rs_out=a.rs", "--cc_out=a.cc"],
+              "inputs": [{"path": "a.h", "digest": "abc"}, {"path": "b.h"}],
+              "requestId": 12})"));
+  EXPECT_THAT(request.arguments, ElementsAre("--rs_out=a.rs", "--cc_out=a.cc"));
+  EXPECT_THAT(request.input_digests,
+              UnorderedElementsAre(Pair("a.h", "abc"), Pair("b.h", "")));
+  EXPECT_EQ(request.request_id, 12);
+}
+
+TEST(PersistentWorkerTest, ParseWorkRequestDefaults) {
+  ASSERT_OK_AND_ASSIGN(WorkRequest request, ParseWorkRequest("{}"));
+  EXPECT_THAT(request.arguments, ElementsAre());
+  EXPECT_THAT(request.input_digests, UnorderedElementsAre());
+  EXPECT_EQ(request.request_id, 0);
+}
+
+TEST(PersistentWorkerTest, ParseWorkRequestErrors) {
+  EXPECT_THAT(ParseWorkRequest("{"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Malformed work request")));
+  EXPECT_THAT(ParseWorkRequest("[]"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("not a JSON object")));
+  EXPECT_THAT(ParseWorkRequest(R"({"arguments": [1]})"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("must be strings")));
+  EXPECT_THAT(ParseWorkRequest(R"({"inputs": [{"digest": "abc"}]})"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("must have a path")));
+}
+
+TEST(PersistentWorkerTest, ParseFlags) {
+  absl::FlagSaver flag_saver;
+  ASSERT_OK_AND_ASSIGN(
+      std::vector<std::string> positional_arguments,
+      ParseFlags({"a.h", "--persistent_worker_test_string=a", "--",
+                  "--persistent_worker_test_bool"}));
+  EXPECT_THAT(positional_arguments,
+              ElementsAre("a.h", "--persistent_worker_test_bool"));
+  EXPECT_EQ(absl::GetFlag(FLAGS_persistent_worker_test_string), "a");
+  EXPECT_FALSE(absl::GetFlag(FLAGS_persistent_worker_test_bool));
+
+  ASSERT_OK_AND_ASSIGN(positional_arguments,
+                       ParseFlags({"--persistent_worker_test_string", "b",
+                                   "-persistent_worker_test_bool", "x"}));
+  EXPECT_THAT(positional_arguments, ElementsAre("x"));
+  EXPECT_EQ(absl::GetFlag(FLAGS_persistent_worker_test_string), "b");
+  EXPECT_TRUE(absl::GetFlag(FLAGS_persistent_worker_test_bool));
+
+  ASSERT_OK(ParseFlags({"--nopersistent_worker_test_bool"}));
+  EXPECT_FALSE(absl::GetFlag(FLAGS_persistent_worker_test_bool));
+}
+
+TEST(PersistentWorkerTest, ParseFlagsErrors) {
+  absl::FlagSaver flag_saver;
+  EXPECT_THAT(ParseFlags({"--no_such_flag=1"}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Unknown command line flag 'no_such_flag'")));
+  EXPECT_THAT(ParseFlags({"--nopersistent_worker_test_string"}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Unknown command line flag")));
+  EXPECT_THAT(ParseFlags({"--persistent_worker_test_bool=maybe"}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Illegal value 'maybe'")));
+  EXPECT_THAT(ParseFlags({"--persistent_worker_test_string"}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Missing the value")));
+}
+
+TEST(PersistentWorkerTest, SerializeWorkResponse) {
+  EXPECT_EQ(SerializeWorkResponse(3, 1, "oops\n"),
+            R"({"exitCode":1,"output":"oops\n","requestId":3})");
+}
+
+TEST(PersistentWorkerTest, RunPersistentWorker) {
+  std::istringstream in(
+      R"({"arguments": ["ok"], "requestId": 1})"
+      "\n"
+      R"({"arguments": ["fail"], "requestId": 2})"
+      "\n"
+      "not json\n");
+  std::ostringstream out;
+  std::vector<std::string> seen;
+  RunPersistentWorker(in, out, [&](const WorkRequest& request) {
+    seen.push_back(request.arguments[0]);
+    if (request.arguments[0] == "fail") {
+      return absl::InvalidArgumentError("failed");
+    }
+    return absl::OkStatus();
+  });
+
+  EXPECT_THAT(seen, ElementsAre("ok", "fail"));
+  std::vector<std::string> lines;
+  std::istringstream out_lines(out.str());
+  for (std::string line; std::getline(out_lines, line);) {
+    lines.push_back(line);
+  }
+  ASSERT_EQ(lines.size(), 3);
+  EXPECT_EQ(lines[0], R"({"exitCode":0,"output":"","requestId":1})");
+  EXPECT_EQ(lines[1], R"({"exitCode":1,"output":"failed","requestId":2})");
+  EXPECT_THAT(lines[2], HasSubstr(R"("exitCode":1)"));
+}
+
+TEST(PersistentWorkerTest, RunPersistentWorkerCapturesStderr) {
+  std::istringstream in(
+      R"({"arguments": ["warn"], "requestId": 1})"
+      "\n"
+      R"({"arguments": ["fail"], "requestId": 2})"
+      "\n");
+  std::ostringstream out;
+  RunPersistentWorker(in, out, [&](const WorkRequest& request) {
+    std::fprintf(stderr, "warning: %s\n", request.arguments[0].c_str());
+    if (request.arguments[0] == "fail") {
+      return absl::InvalidArgumentError("failed");
+    }
+    return absl::OkStatus();
+  });
+
+  EXPECT_EQ(out.str(),
+            R"({"exitCode":0,"output":"warning: warn\n","requestId":1})"
+            "\n"
+            R"({"exitCode":1,"output":"warning: fail\nfailed","requestId":2})"
+            "\n");
+}
+
+}  // namespace
+}  // namespace crubit
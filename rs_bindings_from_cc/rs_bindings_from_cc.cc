@@ -6,22 +6,36 @@
 // * a Rust source file with bindings for the C++ API
 // * a C++ source file with the implementation of the bindings
 
+#include <iostream>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
+#include "absl/flags/reflection.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "common/file_io.h"
 #include "common/status_macros.h"
+#include "rs_bindings_from_cc/cached_file_system.h"
 #include "rs_bindings_from_cc/cmdline.h"
 #include "rs_bindings_from_cc/collect_namespaces.h"
 #include "rs_bindings_from_cc/generate_bindings_and_metadata.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/persistent_worker.h"
+#include "rs_bindings_from_cc/stats.h"
+#include "llvm/ADT/IntrusiveRefCntPtr.h"
+#include "llvm/Support/VirtualFileSystem.h"
 #include "llvm/Support/raw_ostream.h"
 
+ABSL_FLAG(bool, persistent_worker, false,
+          "If set, runs as a Bazel persistent worker: reads JSON work requests "
+          "from stdin and writes JSON work responses to stdout. The files "
+          "read by the bindings generator are cached across requests.");
+
 namespace crubit {
 
 std::string InstantiationsAsJson(
@@ -33,7 +47,46 @@ std::string InstantiationsAsJson(
   return std::string(llvm::formatv("{0:2}", llvm::json::Value(std::move(obj))));
 }
 
-absl::Status Main(absl::Span<char* const> args) {
+// Writes the outputs requested on the command line.
+absl::Status WriteOutputs(
+    const Cmdline& cmdline, const BindingsAndMetadata& bindings_and_metadata,
+    Stats* stats) {
+  if (!cmdline.ir_out().empty()) {
+    std::string ir_json;
+    {
+      Stats::Phase phase(stats, "IrToJson");
+      ir_json = IrToJson(bindings_and_metadata.ir);
+    }
+    CRUBIT_RETURN_IF_ERROR(SetFileContents(cmdline.ir_out(), ir_json));
+  }
+
+  CRUBIT_RETURN_IF_ERROR(
+      SetFileContents(cmdline.rs_out(), bindings_and_metadata.rs_api));
+  CRUBIT_RETURN_IF_ERROR(
+      SetFileContents(cmdline.cc_out(), bindings_and_metadata.rs_api_impl));
+
+  if (!cmdline.instantiations_out().empty()) {
+    CRUBIT_RETURN_IF_ERROR(
+        SetFileContents(cmdline.instantiations_out(),
+                        InstantiationsAsJson(bindings_and_metadata)));
+  }
+
+  if (!cmdline.namespaces_out().empty()) {
+    CRUBIT_RETURN_IF_ERROR(SetFileContents(
+        cmdline.namespaces_out(),
+        crubit::NamespacesAsJson(bindings_and_metadata.namespaces)));
+  }
+
+  if (!cmdline.error_report_out().empty()) {
+    CRUBIT_RETURN_IF_ERROR(SetFileContents(cmdline.error_report_out(),
+                                           bindings_and_metadata.error_report));
+  }
+
+  return absl::OkStatus();
+}
+
+absl::Status Main(absl::Span<char* const> args,
+                  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> file_system) {
   CRUBIT_ASSIGN_OR_RETURN(Cmdline cmdline, Cmdline::Create());
 
   if (cmdline.do_nothing()) {
@@ -50,51 +103,79 @@ absl::Status Main(absl::Span<char* const> args) {
     if (!cmdline.namespaces_out().empty()) {
       CRUBIT_RETURN_IF_ERROR(SetFileContents(cmdline.namespaces_out(), "[]"));
     }
+    if (!cmdline.precompiled_header_out().empty()) {
+      // Bazel requires the output to exist; `IrFromCc` ignores an empty
+      // precompiled header and parses the headers from source instead.
+      CRUBIT_RETURN_IF_ERROR(
+          SetFileContents(cmdline.precompiled_header_out(), ""));
+    }
+    if (!cmdline.stats_out().empty()) {
+      CRUBIT_RETURN_IF_ERROR(
+          SetFileContents(cmdline.stats_out(), Stats().ToChromeTraceJson()));
+    }
     return absl::OkStatus();
   }
 
   std::vector<std::string> clang_args;
   clang_args.insert(clang_args.end(), args.begin(), args.end());
 
+  // Only constructed when requested, because `Stats` resets the peak RSS of
+  // the process.
+  std::optional<Stats> stats;
+  if (!cmdline.stats_out().empty()) stats.emplace();
+  Stats* stats_or_null = stats.has_value() ? &*stats : nullptr;
   CRUBIT_ASSIGN_OR_RETURN(
       BindingsAndMetadata bindings_and_metadata,
-      GenerateBindingsAndMetadata(cmdline, std::move(clang_args)));
+      GenerateBindingsAndMetadata(cmdline, std::move(clang_args),
+                                  /*virtual_headers_contents_for_testing=*/{},
+                                  std::move(file_system), stats_or_null));
 
-  if (!cmdline.ir_out().empty()) {
+  {
+    Stats::Phase phase(stats_or_null, "WriteOutputs");
     CRUBIT_RETURN_IF_ERROR(
-        SetFileContents(cmdline.ir_out(), IrToJson(bindings_and_metadata.ir)));
+        WriteOutputs(cmdline, bindings_and_metadata, stats_or_null));
   }
 
-  CRUBIT_RETURN_IF_ERROR(
-      SetFileContents(cmdline.rs_out(), bindings_and_metadata.rs_api));
-  CRUBIT_RETURN_IF_ERROR(
-      SetFileContents(cmdline.cc_out(), bindings_and_metadata.rs_api_impl));
-
-  if (!cmdline.instantiations_out().empty()) {
+  if (stats_or_null != nullptr) {
     CRUBIT_RETURN_IF_ERROR(
-        SetFileContents(cmdline.instantiations_out(),
-                        InstantiationsAsJson(bindings_and_metadata)));
+        SetFileContents(cmdline.stats_out(), stats->ToChromeTraceJson()));
   }
 
-  if (!cmdline.namespaces_out().empty()) {
-    CRUBIT_RETURN_IF_ERROR(SetFileContents(
-        cmdline.namespaces_out(),
-        crubit::NamespacesAsJson(bindings_and_metadata.namespaces)));
-  }
+  return absl::OkStatus();
+}
 
-  if (!cmdline.error_report_out().empty()) {
-    CRUBIT_RETURN_IF_ERROR(SetFileContents(cmdline.error_report_out(),
-                                           bindings_and_metadata.error_report));
+// Runs `Main` for a single work request, as if the binary had been started
+// with `request.arguments`. Flags are restored once the request is done, so
+// that one request's flags don't leak into the next.
+absl::Status RunWorkRequest(char* argv0, const WorkRequest& request,
+                            CachedFileSystem& file_system) {
+  absl::FlagSaver flag_saver;
+  CRUBIT_ASSIGN_OR_RETURN(std::vector<std::string> positional_arguments,
+                          ParseFlags(request.arguments));
+  std::vector<char*> args = {argv0};
+  for (std::string& argument : positional_arguments) {
+    args.push_back(argument.data());
   }
-
-  return absl::OkStatus();
+  file_system.SetInputDigests(request.input_digests);
+  return Main(args, &file_system);
 }
 
 }  // namespace crubit
 
 int main(int argc, char* argv[]) {
   auto args = absl::ParseCommandLine(argc, argv);
-  absl::Status status = crubit::Main(args);
+  if (absl::GetFlag(FLAGS_persistent_worker)) {
+    // Bazel passes `--persistent_worker` in addition to the startup arguments
+    // of the worker; the arguments of each action come in the work requests.
+    auto file_system = llvm::makeIntrusiveRefCnt<crubit::CachedFileSystem>(
+        llvm::vfs::getRealFileSystem());
+    crubit::RunPersistentWorker(
+        std::cin, std::cout, [&](const crubit::WorkRequest& request) {
+          return crubit::RunWorkRequest(argv[0], request, *file_system);
+        });
+    return 0;
+  }
+  absl::Status status = crubit::Main(args, /*file_system=*/nullptr);
   if (!status.ok()) {
     llvm::errs() << status.message() << "\n";
     return -1;
@@ -6,10 +6,18 @@
 
 #include <string>
 
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "common/ffi_types.h"
 #include "common/status_macros.h"
 #include "rs_bindings_from_cc/ir.h"
-#include "llvm/Support/FormatVariadic.h"
+#include "rs_bindings_from_cc/ir_binary.h"
+#include "rs_bindings_from_cc/stats.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
 #include "llvm/Support/JSON.h"
 
 namespace crubit {
@@ -19,14 +27,16 @@ struct FfiBindings {
   FfiU8SliceBox rs_api;
   FfiU8SliceBox rs_api_impl;
   FfiU8SliceBox error_report;
+  FfiU8SliceBox stats;
 };
 
 // This function is implemented in Rust.
 extern "C" FfiBindings GenerateBindingsImpl(
-    FfiU8Slice json, FfiU8Slice crubit_support_path,
+    FfiU8Slice binary_ir, FfiU8Slice crubit_support_path,
     FfiU8Slice clang_format_exe_path, FfiU8Slice rustfmt_exe_path,
     FfiU8Slice rustfmt_config_path, bool generate_error_report,
-    SourceLocationDocComment generate_source_location_in_doc_comment);
+    SourceLocationDocComment generate_source_location_in_doc_comment,
+    FfiU8Slice generated_item_cache_dir, bool collect_stats);
 
 // Creates `Bindings` instance from copied data from `ffi_bindings`.
 static absl::StatusOr<Bindings> MakeBindingsFromFfiBindings(
@@ -48,22 +58,77 @@ static void FreeFfiBindings(FfiBindings ffi_bindings) {
   FreeFfiU8SliceBox(ffi_bindings.rs_api);
   FreeFfiU8SliceBox(ffi_bindings.rs_api_impl);
   FreeFfiU8SliceBox(ffi_bindings.error_report);
+  FreeFfiU8SliceBox(ffi_bindings.stats);
+}
+
+// Records the statistics reported by `GenerateBindingsImpl` in `stats`.
+//
+// `stats_json` is `{"phases": [{"name": ..., "start_us": ...,
+// "duration_us": ...}, ...], "thunks": ...}`, where `start_us` is relative to
+// `start`, the time at which `GenerateBindingsImpl` was called.
+static absl::Status RecordGenerationStats(absl::string_view stats_json,
+                                          absl::Time start, Stats& stats) {
+  llvm::Expected<llvm::json::Value> value = llvm::json::parse(
+      llvm::StringRef(stats_json.data(), stats_json.size()));
+  if (!value) {
+    return absl::InternalError(
+        absl::StrCat("Failed to parse the generation stats: ",
+                     llvm::toString(value.takeError())));
+  }
+  const llvm::json::Object* object = value->getAsObject();
+  if (object == nullptr) {
+    return absl::InternalError("The generation stats are not a JSON object");
+  }
+  if (const llvm::json::Array* phases = object->getArray("phases")) {
+    for (const llvm::json::Value& phase_value : *phases) {
+      const llvm::json::Object* phase = phase_value.getAsObject();
+      if (phase == nullptr) continue;
+      auto name = phase->getString("name");
+      auto start_us = phase->getInteger("start_us");
+      auto duration_us = phase->getInteger("duration_us");
+      if (!name || !start_us || !duration_us) {
+        return absl::InternalError("Malformed phase in the generation stats");
+      }
+      stats.RecordPhase(absl::string_view(name->data(), name->size()),
+                        start + absl::Microseconds(*start_us),
+                        absl::Microseconds(*duration_us));
+    }
+  }
+  if (auto thunks = object->getInteger("thunks")) {
+    stats.SetCounter("thunks", *thunks);
+  }
+  return absl::OkStatus();
 }
 
 absl::StatusOr<Bindings> GenerateBindings(
     const IR& ir, absl::string_view crubit_support_path,
     absl::string_view clang_format_exe_path, absl::string_view rustfmt_exe_path,
     absl::string_view rustfmt_config_path, bool generate_error_report,
-    SourceLocationDocComment generate_source_location_in_doc_comment) {
-  std::string json = llvm::formatv("{0}", ir.ToJson());
+    SourceLocationDocComment generate_source_location_in_doc_comment,
+    absl::string_view generated_item_cache_dir, Stats* stats) {
+  std::string binary_ir;
+  {
+    Stats::Phase phase(stats, "IrToBinary");
+    binary_ir = IrToBinary(ir);
+  }
+  absl::Time start = absl::Now();
   FfiBindings ffi_bindings = GenerateBindingsImpl(
-      MakeFfiU8Slice(json), MakeFfiU8Slice(crubit_support_path),
+      MakeFfiU8Slice(binary_ir), MakeFfiU8Slice(crubit_support_path),
       MakeFfiU8Slice(clang_format_exe_path), MakeFfiU8Slice(rustfmt_exe_path),
       MakeFfiU8Slice(rustfmt_config_path), generate_error_report,
-      generate_source_location_in_doc_comment);
+      generate_source_location_in_doc_comment,
+      MakeFfiU8Slice(generated_item_cache_dir),
+      /*collect_stats=*/stats != nullptr);
   CRUBIT_ASSIGN_OR_RETURN(Bindings bindings,
                           MakeBindingsFromFfiBindings(ffi_bindings));
+  absl::Status stats_status = absl::OkStatus();
+  if (stats != nullptr) {
+    stats_status = RecordGenerationStats(
+        absl::string_view(ffi_bindings.stats.ptr, ffi_bindings.stats.size),
+        start, *stats);
+  }
   FreeFfiBindings(ffi_bindings);
+  CRUBIT_RETURN_IF_ERROR(stats_status);
   return bindings;
 }
 
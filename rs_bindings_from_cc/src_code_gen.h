@@ -11,6 +11,7 @@
 #include "absl/strings/string_view.h"
 #include "common/ffi_types.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/stats.h"
 
 namespace crubit {
 
@@ -25,11 +26,24 @@ struct Bindings {
 };
 
 // Generates bindings from the given `IR`.
+//
+// If `clang_format_exe_path` or `rustfmt_exe_path` is empty, the corresponding
+// source code is formatted by a built-in pretty printer instead of running the
+// external formatter.
+//
+// If `generated_item_cache_dir` is not empty, the bindings of the items are
+// cached in that directory, and reused by later calls for items that didn't
+// change.
+//
+// If `stats` is not null, the time spent in the phases of the generation
+// (including serializing `ir` for it) and the number of generated thunks are
+// recorded in it.
 absl::StatusOr<Bindings> GenerateBindings(
     const IR& ir, absl::string_view crubit_support_path,
     absl::string_view clang_format_exe_path, absl::string_view rustfmt_exe_path,
     absl::string_view rustfmt_config_path, bool generate_error_report,
-    SourceLocationDocComment generate_source_location_in_doc_comment);
+    SourceLocationDocComment generate_source_location_in_doc_comment,
+    absl::string_view generated_item_cache_dir = "", Stats* stats = nullptr);
 
 }  // namespace crubit
 
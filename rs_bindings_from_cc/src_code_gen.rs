@@ -10,20 +10,28 @@ use ffi_types::*;
 use ir::*;
 use itertools::Itertools;
 use once_cell::sync::Lazy;
-use proc_macro2::{Ident, Literal, TokenStream};
+use proc_macro2::{Ident, Literal, TokenStream, TokenTree};
 use quote::{format_ident, quote, ToTokens};
+use std::cell::{Cell, RefCell};
+use std::collections::hash_map::DefaultHasher;
 use std::collections::{BTreeSet, HashMap, HashSet};
+use std::env;
 use std::ffi::{OsStr, OsString};
 use std::fmt::Write as _;
+use std::fs;
+use std::hash::{Hash, Hasher};
 use std::iter::{self, Iterator};
 use std::panic::catch_unwind;
-use std::path::Path;
+use std::path::{Path, PathBuf};
 use std::process;
 use std::ptr;
 use std::rc::Rc;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::thread;
+use std::time::{Duration, Instant};
 use token_stream_printer::{
-    cc_tokens_to_formatted_string, rs_tokens_to_formatted_string, write_unformatted_tokens,
-    RustfmtConfig,
+    cc_tokens_to_formatted_string, cc_tokens_to_pretty_string, rs_tokens_to_formatted_string,
+    rs_tokens_to_pretty_string, write_unformatted_tokens, RustfmtConfig,
 };
 
 /// FFI equivalent of `Bindings`.
@@ -32,42 +40,56 @@ pub struct FfiBindings {
     rs_api: FfiU8SliceBox,
     rs_api_impl: FfiU8SliceBox,
     error_report: FfiU8SliceBox,
+    stats: FfiU8SliceBox,
 }
 
-/// Deserializes IR from `json` and generates bindings source code.
+/// Deserializes IR from `binary_ir` (see `ir_binary.h`) and generates bindings
+/// source code.
 ///
 /// This function panics on error.
 ///
 /// # Safety
 ///
 /// Expectations:
-///    * `json` should be a FfiU8Slice for a valid array of bytes with the given
-///      size.
+///    * `binary_ir` should be a FfiU8Slice for a valid array of bytes with the
+///      given size.
 ///    * `crubit_support_path` should be a FfiU8Slice for a valid array of bytes
 ///      representing an UTF8-encoded string
 ///    * `rustfmt_exe_path` and `rustfmt_config_path` should both be a
 ///      FfiU8Slice for a valid array of bytes representing an UTF8-encoded
 ///      string (without the UTF-8 requirement, it seems that Rust doesn't offer
 ///      a way to convert to OsString on Windows)
-///    * `json`, `crubit_support_path`, `rustfmt_exe_path`, and
+///    * `binary_ir`, `crubit_support_path`, `rustfmt_exe_path`, and
 ///      `rustfmt_config_path` shouldn't change during the call.
+///    * If `clang_format_exe_path` or `rustfmt_exe_path` is empty, the
+///      corresponding source code is formatted by the built-in pretty printer
+///      of `token_stream_printer` instead.
+///    * `generated_item_cache_dir` should be a FfiU8Slice for a valid array of
+///      bytes representing an UTF8-encoded string. If it is not empty, items
+///      are cached in (and reused from) that directory.
+///    * The returned `stats` are a JSON object with the wall time of the
+///      phases of the generation (see `GenerationStats`). Statistics that are
+///      expensive to collect, such as the number of thunks, are only collected
+///      if `collect_stats` is true.
 ///
 /// Ownership:
 ///    * function doesn't take ownership of (in other words it borrows) the
-///      input params: `json`, `crubit_support_path`, `rustfmt_exe_path`, and
-///      `rustfmt_config_path`
+///      input params: `binary_ir`, `crubit_support_path`, `rustfmt_exe_path`,
+///      `rustfmt_config_path`, and `generated_item_cache_dir`
 ///    * function passes ownership of the returned value to the caller
 #[no_mangle]
 pub unsafe extern "C" fn GenerateBindingsImpl(
-    json: FfiU8Slice,
+    binary_ir: FfiU8Slice,
     crubit_support_path: FfiU8Slice,
     clang_format_exe_path: FfiU8Slice,
     rustfmt_exe_path: FfiU8Slice,
     rustfmt_config_path: FfiU8Slice,
     generate_error_report: bool,
     generate_source_loc_doc_comment: SourceLocationDocComment,
+    generated_item_cache_dir: FfiU8Slice,
+    collect_stats: bool,
 ) -> FfiBindings {
-    let json: &[u8] = json.as_slice();
+    let binary_ir: &[u8] = binary_ir.as_slice();
     let crubit_support_path: &str = std::str::from_utf8(crubit_support_path.as_slice()).unwrap();
     let clang_format_exe_path: OsString =
         std::str::from_utf8(clang_format_exe_path.as_slice()).unwrap().into();
@@ -75,18 +97,22 @@ pub unsafe extern "C" fn GenerateBindingsImpl(
         std::str::from_utf8(rustfmt_exe_path.as_slice()).unwrap().into();
     let rustfmt_config_path: OsString =
         std::str::from_utf8(rustfmt_config_path.as_slice()).unwrap().into();
+    let generated_item_cache_dir: OsString =
+        std::str::from_utf8(generated_item_cache_dir.as_slice()).unwrap().into();
     catch_unwind(|| {
         // It is ok to abort here.
         let errors: Rc<dyn ErrorReporting> =
             if generate_error_report { Rc::new(ErrorReport::new()) } else { Rc::new(IgnoreErrors) };
-        let Bindings { rs_api, rs_api_impl } = generate_bindings(
-            json,
+        let Bindings { rs_api, rs_api_impl, stats } = generate_bindings(
+            binary_ir,
             crubit_support_path,
             &clang_format_exe_path,
             &rustfmt_exe_path,
             &rustfmt_config_path,
             errors.clone(),
             generate_source_loc_doc_comment,
+            &generated_item_cache_dir,
+            collect_stats,
         )
         .unwrap();
         FfiBindings {
@@ -97,6 +123,7 @@ pub unsafe extern "C" fn GenerateBindingsImpl(
             error_report: FfiU8SliceBox::from_boxed_slice(
                 errors.serialize_to_vec().unwrap().into_boxed_slice(),
             ),
+            stats: FfiU8SliceBox::from_boxed_slice(stats.to_json().into_boxed_slice()),
         }
     })
     .unwrap_or_else(|_| process::abort())
@@ -130,16 +157,104 @@ trait BindingsGenerator {
 #[derive(Default)]
 struct Database {
     storage: salsa::Storage<Self>,
+    /// Items generated ahead of time by `pregenerate_items`. `generate_item`
+    /// takes them out of the map instead of generating them again.
+    pregenerated_items: RefCell<HashMap<ItemId, PregeneratedItem>>,
+    /// Items generated by previous runs (see `enable_generated_item_cache`).
+    generated_item_cache: Option<GeneratedItemCache>,
+    /// The number of errors reported so far, if `generated_item_cache` is set.
+    reported_errors: Rc<Cell<usize>>,
 }
 
 impl salsa::Database for Database {}
 
+impl Database {
+    /// Makes `generate_item` look up items in `cache`, and store the items it
+    /// generates there.
+    ///
+    /// Must be called after `set_errors`, so that it can count the reported
+    /// errors.
+    fn enable_generated_item_cache(&mut self, cache: GeneratedItemCache) {
+        let errors =
+            CountingErrorReporting { errors: self.errors(), count: self.reported_errors.clone() };
+        self.set_errors(Rc::new(errors));
+        self.generated_item_cache = Some(cache);
+    }
+}
+
 /// Source code for generated bindings.
 struct Bindings {
     // Rust source code.
     rs_api: String,
     // C++ source code.
     rs_api_impl: String,
+    // Statistics about the generation.
+    stats: GenerationStats,
+}
+
+/// The wall time spent in the phases of `generate_bindings`, and the number of
+/// thunks in the generated bindings.
+struct GenerationStats {
+    start: Instant,
+    /// The name, the start (relative to `start`) and the duration of each
+    /// phase, in the order in which they finished.
+    phases: Vec<(&'static str, Duration, Duration)>,
+    /// `None` unless statistics were requested: counting them walks all of
+    /// the generated C++ code.
+    thunks: Option<usize>,
+}
+
+impl GenerationStats {
+    fn new() -> Self {
+        GenerationStats { start: Instant::now(), phases: vec![], thunks: None }
+    }
+
+    /// Calls `f`, and records the time it took as the phase `name`.
+    fn time<T>(&mut self, name: &'static str, f: impl FnOnce() -> T) -> T {
+        let phase_start = Instant::now();
+        let result = f();
+        self.phases.push((name, phase_start - self.start, phase_start.elapsed()));
+        result
+    }
+
+    /// Returns the statistics as `{"phases": [{"name": ..., "start_us": ...,
+    /// "duration_us": ...}, ...], "thunks": ...}`, which `src_code_gen.cc`
+    /// parses. `thunks` is `null` if they weren't counted.
+    fn to_json(&self) -> Vec<u8> {
+        let phases = self
+            .phases
+            .iter()
+            .map(|(name, start, duration)| {
+                serde_json::json!({
+                    "name": name,
+                    "start_us": start.as_micros() as u64,
+                    "duration_us": duration.as_micros() as u64,
+                })
+            })
+            .collect_vec();
+        serde_json::to_vec(&serde_json::json!({ "phases": phases, "thunks": self.thunks })).unwrap()
+    }
+}
+
+/// Returns the number of distinct thunks defined in the C++ bindings `tokens`.
+fn count_thunks(tokens: &TokenStream) -> usize {
+    fn collect_thunk_names(tokens: &TokenStream, names: &mut HashSet<String>) {
+        for tt in tokens.clone() {
+            match tt {
+                TokenTree::Ident(ident) => {
+                    let name = ident.to_string();
+                    if name.starts_with("__rust_thunk__") {
+                        names.insert(name);
+                    }
+                }
+                TokenTree::Group(group) => collect_thunk_names(&group.stream(), names),
+                TokenTree::Punct(_) | TokenTree::Literal(_) => {}
+            }
+        }
+    }
+    let mut names = HashSet::new();
+    collect_thunk_names(tokens, &mut names);
+    names.len()
 }
 
 /// Source code for generated bindings, as tokens.
@@ -151,23 +266,59 @@ struct BindingsTokens {
 }
 
 fn generate_bindings(
-    json: &[u8],
+    binary_ir: &[u8],
     crubit_support_path: &str,
     clang_format_exe_path: &OsStr,
     rustfmt_exe_path: &OsStr,
     rustfmt_config_path: &OsStr,
     errors: Rc<dyn ErrorReporting>,
     generate_source_loc_doc_comment: SourceLocationDocComment,
+    generated_item_cache_dir: &OsStr,
+    collect_stats: bool,
 ) -> Result<Bindings> {
-    let ir = Rc::new(deserialize_ir(json)?);
+    let mut stats = GenerationStats::new();
+    let ir = Rc::new(stats.time("deserialize_ir_binary", || deserialize_ir_binary(binary_ir))?);
 
-    let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(
-        ir.clone(),
-        crubit_support_path,
-        errors,
-        generate_source_loc_doc_comment,
-    )?;
-    let rs_api = {
+    let generated_item_cache = if generated_item_cache_dir.is_empty() {
+        None
+    } else {
+        Some(GeneratedItemCache::new(
+            Path::new(generated_item_cache_dir),
+            &ir,
+            generate_source_loc_doc_comment,
+        )?)
+    };
+    let item_ids = items_to_pregenerate(&ir)?;
+    let num_threads = num_generator_threads(item_ids.len());
+    let pregenerated_items = if num_threads > 1 {
+        stats.time("pregenerate_items", || {
+            pregenerate_items(
+                &|| deserialize_ir_binary(binary_ir),
+                &item_ids,
+                num_threads,
+                generate_source_loc_doc_comment,
+                generated_item_cache.as_ref(),
+            )
+        })?
+    } else {
+        HashMap::new()
+    };
+    let BindingsTokens { rs_api, rs_api_impl } = stats.time("generate_bindings_tokens", || {
+        generate_bindings_tokens_impl(
+            ir.clone(),
+            crubit_support_path,
+            errors,
+            generate_source_loc_doc_comment,
+            pregenerated_items,
+            generated_item_cache.as_ref(),
+        )
+    })?;
+    if collect_stats {
+        stats.thunks = Some(count_thunks(&rs_api_impl));
+    }
+    let rs_api = if rustfmt_exe_path.is_empty() {
+        stats.time("rs_tokens_to_pretty_string", || rs_tokens_to_pretty_string(rs_api))?
+    } else {
         let rustfmt_exe_path = Path::new(rustfmt_exe_path);
         let rustfmt_config_path = if rustfmt_config_path.is_empty() {
             None
@@ -175,9 +326,15 @@ fn generate_bindings(
             Some(Path::new(rustfmt_config_path))
         };
         let rustfmt_config = RustfmtConfig::new(rustfmt_exe_path, rustfmt_config_path);
-        rs_tokens_to_formatted_string(rs_api, &rustfmt_config)?
+        stats.time("rustfmt", || rs_tokens_to_formatted_string(rs_api, &rustfmt_config))?
+    };
+    let rs_api_impl = if clang_format_exe_path.is_empty() {
+        stats.time("cc_tokens_to_pretty_string", || cc_tokens_to_pretty_string(rs_api_impl))?
+    } else {
+        stats.time("clang_format", || {
+            cc_tokens_to_formatted_string(rs_api_impl, Path::new(clang_format_exe_path))
+        })?
     };
-    let rs_api_impl = cc_tokens_to_formatted_string(rs_api_impl, Path::new(clang_format_exe_path))?;
 
     // Add top-level comments that help identify where the generated bindings came
     // from.
@@ -228,7 +385,7 @@ fn generate_bindings(
         {rs_api_impl}"
     );
 
-    Ok(Bindings { rs_api, rs_api_impl })
+    Ok(Bindings { rs_api, rs_api_impl, stats })
 }
 
 /// If we know the original C++ function is codegenned and already compatible
@@ -272,9 +429,14 @@ fn can_skip_cc_thunk(db: &dyn BindingsGenerator, func: &Func) -> bool {
     // In terms of runtime performance, since this only occurs for virtual function
     // calls, which are already slow, it may not be such a big deal. We can
     // benchmark it later. :)
+    //
+    // If the method is `final`, or is a member of a `final` class, then no other
+    // implementation can be dispatched to, and we can call the concrete `A::Method`
+    // symbol directly. (Out-of-line virtual methods are always emitted, since the
+    // vtable refers to them.)
     if let Some(meta) = &func.member_func_metadata {
         if let Some(inst_meta) = &meta.instance_method_metadata {
-            if inst_meta.is_virtual {
+            if inst_meta.is_virtual && !inst_meta.is_final {
                 return false;
             }
         }
@@ -706,7 +868,9 @@ fn api_func_shape(
         Some(Err(_)) => return Ok(None),
     };
 
-    let has_pointer_params = param_types.iter().any(|p| matches!(p, RsTypeKind::Pointer { .. }));
+    // Spans don't borrow their elements either, so they make functions unsafe like pointers do.
+    let has_pointer_params =
+        param_types.iter().any(|p| matches!(p, RsTypeKind::Pointer { .. }) || is_cc_std_span(p));
     let impl_kind: ImplKind;
     let func_name: syn::Ident;
 
@@ -1281,7 +1445,11 @@ fn generate_func(
                                 func,
                             );
                         }
-                        clone_prefixes.push(quote!{&mut});
+                        if param_type.is_c_abi_compatible_by_value() {
+                            clone_prefixes.push(quote!{});
+                        } else {
+                            clone_prefixes.push(quote!{&mut});
+                        }
                         clone_suffixes.push(quote!{.clone()});
                         Ok(RsTypeKind::Reference {
                             referent: Rc::new(param_type.clone()),
@@ -1317,9 +1485,22 @@ fn generate_func(
         &mut return_type,
     )?;
 
+    // Trivial field accessors are reimplemented in Rust, so that they can be
+    // inlined without LTO, and don't need a thunk.
+    let trivial_field_accessor_body = generate_trivial_field_accessor_body(
+        db,
+        &func,
+        &impl_kind,
+        &param_types,
+        &return_type,
+        &thunk_args,
+    );
+    let func_body_is_rust = trivial_field_accessor_body.is_some();
+
     let api_func_def = {
         let thunk_ident = thunk_ident(&func);
         let func_body = match &impl_kind {
+            _ if func_body_is_rust => trivial_field_accessor_body.unwrap(),
             ImplKind::Trait { trait_name: TraitName::UnpinConstructor { .. }, .. } => {
                 // SAFETY: A user-defined constructor is not guaranteed to
                 // initialize all the fields. To make the `assume_init()` call
@@ -1478,6 +1659,7 @@ fn generate_func(
         }
     };
 
+    let slice_helpers = generate_func_slice_helpers(db, &func, &impl_kind)?;
     let doc_comment = generate_doc_comment(
         func.doc_comment.as_deref(),
         Some(&func.source_loc),
@@ -1603,16 +1785,445 @@ fn generate_func(
         }
     }
 
-    let generated_item = GeneratedItem {
-        item: api_func,
-        thunks: thunk,
-        features,
-        thunk_impls: generate_func_thunk_impl(db, &func)?,
-        ..Default::default()
+    let (thunks, thunk_impls) = if func_body_is_rust {
+        (quote! {}, quote! {})
+    } else {
+        (thunk, generate_func_thunk_impl(db, &func)?)
     };
+    let mut generated_item =
+        GeneratedItem { item: api_func, thunks, features, thunk_impls, ..Default::default() };
+    match generate_func_batch(db, &func) {
+        Ok(None) => {}
+        Ok(Some((batch_func, batch_thunk, batch_thunk_impl))) => {
+            generated_item.item.extend(batch_func);
+            generated_item.thunks.extend(batch_thunk);
+            generated_item.thunk_impls.extend(batch_thunk_impl);
+        }
+        // The batch variant is only an addition to the bindings of `func`, so it is
+        // reported on its own rather than taking the bindings of `func` down with it.
+        Err(err) => {
+            db.errors().insert(&err);
+            let message =
+                format!("Error while generating the batch variant of {:?}:\n{err:#}", func.name);
+            generated_item.item.extend(quote! { __COMMENT__ #message });
+        }
+    }
+    if let Some((helper, thunk, thunk_impl)) = slice_helpers {
+        generated_item.item.extend(helper);
+        generated_item.thunks.extend(thunk);
+        generated_item.thunk_impls.extend(thunk_impl);
+    }
+    let mut layout_assertions = vec![];
+    for ty in func.params.iter().map(|p| &p.type_).chain(iter::once(&func.return_type)) {
+        cc_contiguous_storage_layout_assertions(
+            &ty.rs_type,
+            &ty.cc_type,
+            &ir,
+            &mut layout_assertions,
+        )?;
+    }
+    // Each type is only checked once per function.
+    generated_item
+        .thunk_impls
+        .extend(layout_assertions.into_iter().unique_by(|assertion| assertion.to_string()));
     Ok(Some((Rc::new(generated_item), Rc::new(function_id))))
 }
 
+/// Returns whether `ty` is one of the `cc_std` span types, which point to
+/// elements that they don't borrow.
+fn is_cc_std_span(ty: &RsTypeKind) -> bool {
+    match ty {
+        RsTypeKind::TypeAlias { underlying_type, .. } => is_cc_std_span(underlying_type),
+        RsTypeKind::Other { name, .. } => {
+            matches!(name.as_ref(), "::cc_std::Span" | "::cc_std::SpanMut")
+        }
+        _ => false,
+    }
+}
+
+/// Adds to `assertions` the C++ assertions that the layout of the spans,
+/// vectors and strings in the type `rs_type`/`cc_type` matches the layout of
+/// the `cc_std` Rust types which they are mapped to (see
+/// `ContiguousStorageType` in `type_map.h`).
+fn cc_contiguous_storage_layout_assertions(
+    rs_type: &RsType,
+    cc_type: &CcType,
+    ir: &IR,
+    assertions: &mut Vec<TokenStream>,
+) -> Result<()> {
+    let num_pointers: usize = match rs_type.name.as_deref() {
+        // A pointer to the first element, and the number of elements.
+        Some("::cc_std::Span" | "::cc_std::SpanMut") => 2,
+        // Pointers to the first element, past the last element, and past the
+        // end of the allocation.
+        Some("::cc_std::Vector") => 3,
+        // The capacity, size and data pointer of a heap-allocated buffer,
+        // which also hold short strings inline.
+        Some("::cc_std::StdString") => 3,
+        _ => {
+            if rs_type.type_args.len() == cc_type.type_args.len() {
+                for (rs_type_arg, cc_type_arg) in rs_type.type_args.iter().zip(&cc_type.type_args) {
+                    cc_contiguous_storage_layout_assertions(
+                        rs_type_arg,
+                        cc_type_arg,
+                        ir,
+                        assertions,
+                    )?;
+                }
+            }
+            return Ok(());
+        }
+    };
+    let mut cc_type = cc_type.clone();
+    cc_type.is_const = false;
+    let cc_type = format_cc_type(&cc_type, ir)?;
+    let num_pointers = Literal::usize_unsuffixed(num_pointers);
+    assertions.push(quote! {
+        static_assert(sizeof(#cc_type) == #num_pointers * sizeof(void*));
+        static_assert(alignof(#cc_type) == alignof(void*));
+    });
+    Ok(())
+}
+
+/// Returns whether values of `ty` can be read from and written to the slices of
+/// a batch function (see `generate_func_batch`).
+fn is_batch_element_type(ty: &RsTypeKind) -> bool {
+    match ty {
+        RsTypeKind::TypeAlias { underlying_type, .. } => is_batch_element_type(underlying_type),
+        // Pointers and references would make the safe batch function unsound.
+        RsTypeKind::Pointer { .. }
+        | RsTypeKind::Reference { .. }
+        | RsTypeKind::RvalueReference { .. }
+        | RsTypeKind::FuncPtr { .. }
+        | RsTypeKind::IncompleteRecord { .. }
+        | RsTypeKind::Unit => false,
+        // So would spans, vectors and strings, which don't borrow their elements
+        // either.
+        RsTypeKind::Other { name, .. } if name.starts_with("::cc_std::") => false,
+        _ => ty.is_c_abi_compatible_by_value() && ty.implements_copy(),
+    }
+}
+
+/// Generates the batch variant of `func`, if it was requested with
+/// `CRUBIT_INTERNAL_BATCH_THUNK`: a safe Rust function over slices of
+/// arguments, and a C++ thunk that calls `func` once per element. The Rust
+/// function and the thunk declaration and implementation are returned in this
+/// order.
+///
+/// Batch variants are only generated for free functions whose parameter and
+/// return types are `Copy` and passed by value, so that the thunk can read and
+/// write the elements of the slices in place.
+fn generate_func_batch(
+    db: &dyn BindingsGenerator,
+    func: &Func,
+) -> Result<Option<(TokenStream, TokenStream, TokenStream)>> {
+    if !func.has_batch_thunk {
+        return Ok(None);
+    }
+    let id = match &func.name {
+        UnqualifiedIdentifier::Identifier(id) if func.member_func_metadata.is_none() => id,
+        _ => bail!("Batch thunks are only supported for free functions"),
+    };
+    let ir = db.ir();
+    let batch_name = format!("{}_batch", id.identifier);
+    let batch_name_id =
+        UnqualifiedIdentifier::Identifier(Identifier { identifier: Rc::from(batch_name.as_str()) });
+    if ir
+        .get_functions_by_name(&batch_name_id)
+        .any(|other| other.enclosing_namespace_id == func.enclosing_namespace_id)
+    {
+        bail!(
+            "The batch variant of `{}` conflicts with the function `{batch_name}`",
+            id.identifier
+        );
+    }
+    if func.params.is_empty() {
+        bail!("Batch thunks require at least one parameter");
+    }
+    let param_types = func
+        .params
+        .iter()
+        .map(|p| db.rs_type_kind(p.type_.rs_type.clone()))
+        .collect::<Result<Vec<_>>>()?;
+    let return_type = db.rs_type_kind(func.return_type.rs_type.clone())?;
+    let returns_unit = matches!(return_type, RsTypeKind::Unit);
+    if !param_types.iter().all(is_batch_element_type)
+        || !(returns_unit || is_batch_element_type(&return_type))
+    {
+        bail!("Batch thunks require `Copy` parameter and return types that are passed by value");
+    }
+
+    let crate_root_path = crate_root_path_tokens(&ir);
+    let batch_ident = make_rs_ident(&batch_name);
+    let batch_thunk_ident = format_ident!("__rust_batch_thunk__{}", func.mangled_name.as_ref());
+    let param_idents =
+        func.params.iter().map(|p| make_rs_ident(&p.identifier.identifier)).collect_vec();
+    let first_param_ident = &param_idents[0];
+    let other_param_idents = &param_idents[1..];
+    let (return_param, return_thunk_param, return_arg) = if returns_unit {
+        (quote! {}, quote! {}, quote! {})
+    } else {
+        (
+            quote! { , __return: &mut [#return_type] },
+            quote! { , __return: *mut #return_type },
+            quote! { , __return.as_mut_ptr() },
+        )
+    };
+    let return_len_check = if returns_unit {
+        quote! {}
+    } else {
+        quote! { assert_eq!(__return.len(), __n); }
+    };
+    let doc_comment = format!(
+        " Calls `{}` once per element of the argument slices{}.\n\n \
+         Panics if the slices don't all have the same length.",
+        id.identifier,
+        if returns_unit { "" } else { ", and writes the results to `__return`" },
+    );
+    let batch_func = quote! {
+        #[doc = #doc_comment]
+        #[inline(always)]
+        pub fn #batch_ident(#( #param_idents: &[#param_types] ),* #return_param) {
+            let __n = #first_param_ident.len();
+            #( assert_eq!(#other_param_idents.len(), __n); )*
+            #return_len_check
+            unsafe {
+                #crate_root_path::detail::#batch_thunk_ident(
+                    __n #( , #param_idents.as_ptr() )* #return_arg
+                )
+            }
+        }
+    };
+    let batch_thunk = quote! {
+        pub(crate) fn #batch_thunk_ident(
+            __n: usize #( , #param_idents: *const #param_types )* #return_thunk_param
+        );
+    };
+
+    let fn_ident = format_cc_ident(&id.identifier);
+    let namespace_qualifier = namespace_qualifier_of_item(func.id, &ir)?.format_for_cc()?;
+    let cc_param_idents =
+        func.params.iter().map(|p| format_cc_ident(&p.identifier.identifier)).collect_vec();
+    // The elements are only read, but `const` would be repeated if the type is
+    // already `const`.
+    let format_element_type = |ty: &CcType| {
+        let mut ty = ty.clone();
+        ty.is_const = false;
+        format_cc_type(&ty, &ir)
+    };
+    let cc_param_types = func
+        .params
+        .iter()
+        .map(|p| format_element_type(&p.type_.cc_type))
+        .collect::<Result<Vec<_>>>()?;
+    let call = quote! { #namespace_qualifier #fn_ident( #( #cc_param_idents[__i] ),* ) };
+    let (cc_return_param, body) = if returns_unit {
+        (quote! {}, quote! { #call; })
+    } else {
+        let cc_return_type = format_element_type(&func.return_type.cc_type)?;
+        (quote! { , #cc_return_type* __return }, quote! { __return[__i] = #call; })
+    };
+    let batch_thunk_impl = quote! {
+        extern "C" void #batch_thunk_ident(
+            std::size_t __n #( , const #cc_param_types* #cc_param_idents )* #cc_return_param
+        ) {
+            for (std::size_t __i = 0; __i < __n; ++__i) {
+                #body
+            }
+        }
+    };
+    Ok(Some((batch_func, batch_thunk, batch_thunk_impl)))
+}
+
+/// Returns the Rust helpers, thunk declarations and C++ thunks which destroy or
+/// copy-construct a whole slice of records with a single call into C++, if
+/// `func` is the destructor or copy constructor that implements `Drop` or
+/// `Clone` for a record (see `impl_kind`).
+///
+/// These are only generated for `Unpin` records, because Rust code can't have
+/// slices of `!Unpin` C++ objects. For the same reason, there is no slice
+/// helper for move constructors: Rust moves `Unpin` records with `memcpy`.
+fn generate_func_slice_helpers(
+    db: &dyn BindingsGenerator,
+    func: &Func,
+    impl_kind: &ImplKind,
+) -> Result<Option<(TokenStream, TokenStream, TokenStream)>> {
+    let (record, trait_name) = match impl_kind {
+        ImplKind::Trait { record, trait_name, impl_for: ImplFor::T, .. } => (record, trait_name),
+        _ => return Ok(None),
+    };
+    let is_drop = match trait_name {
+        TraitName::Other { name, .. } if &**name == "Drop" => true,
+        TraitName::UnpinConstructor { name, .. } if &**name == "Clone" => false,
+        _ => return Ok(None),
+    };
+    let helper_name = if is_drop { "drop_slice_in_place" } else { "clone_slice_into_uninit" };
+    let ir = db.ir();
+    let helper_name_id =
+        UnqualifiedIdentifier::Identifier(Identifier { identifier: Rc::from(helper_name) });
+    if ir.get_functions_by_name(&helper_name_id).any(|other| {
+        other.member_func_metadata.as_ref().map(|meta| meta.record_id) == Some(record.id)
+    }) {
+        // The helper would conflict with a method of the record.
+        return Ok(None);
+    }
+
+    let crate_root_path = crate_root_path_tokens(&ir);
+    let helper_ident = make_rs_ident(helper_name);
+    let record_type = RsTypeKind::new_record(record.clone(), &ir)?;
+    let record_name = make_rs_ident(record.rs_name.as_ref());
+    // `__this` is a pointer to the record in both the destructor and the copy
+    // constructor.
+    let this_cc_type = format_cc_type(&func.params[0].type_.cc_type, &ir)?;
+    let mut const_record_cc_type = func.params[0]
+        .type_
+        .cc_type
+        .type_args
+        .first()
+        .ok_or_else(|| anyhow!("`__this` must be a pointer: {:?}", func.params[0]))?
+        .clone();
+    const_record_cc_type.is_const = true;
+    let const_record_cc_type = format_cc_type(&const_record_cc_type, &ir)?;
+
+    let (helper, thunk, thunk_impl);
+    if is_drop {
+        let thunk_ident = format_ident!("__rust_destroy_n_thunk__{}", func.mangled_name.as_ref());
+        let doc_comment =
+            " Drops the elements of `slice` in place, with a single call into C++.\n\n \
+                           # Safety\n\n \
+                           The same as for `core::ptr::drop_in_place(slice)`.";
+        helper = quote! {
+            impl #record_name {
+                #[doc = #doc_comment]
+                #[inline(always)]
+                pub unsafe fn #helper_ident(slice: *mut [Self]) {
+                    #crate_root_path::detail::#thunk_ident(slice as *mut Self, slice.len())
+                }
+            }
+        };
+        thunk = quote! {
+            pub(crate) fn #thunk_ident(__this: *mut #record_type, __n: usize);
+        };
+        thunk_impl = quote! {
+            extern "C" void #thunk_ident(#this_cc_type __this, std::size_t __n) {
+                std::destroy_n(__this, __n);
+            }
+        };
+    } else {
+        let thunk_ident =
+            format_ident!("__rust_copy_construct_n_thunk__{}", func.mangled_name.as_ref());
+        let doc_comment =
+            " Clones the elements of `src` into `dest`, with a single call into C++, \
+                           and returns the clones.\n\n \
+                           Panics if `src` and `dest` don't have the same length.";
+        helper = quote! {
+            impl #record_name {
+                #[doc = #doc_comment]
+                #[inline(always)]
+                pub fn #helper_ident<'a>(
+                    src: &[Self],
+                    dest: &'a mut [::core::mem::MaybeUninit<Self>],
+                ) -> &'a mut [Self] {
+                    assert_eq!(src.len(), dest.len());
+                    unsafe {
+                        #crate_root_path::detail::#thunk_ident(
+                            dest.as_mut_ptr() as *mut Self, src.as_ptr(), src.len());
+                        &mut *(dest as *mut [::core::mem::MaybeUninit<Self>] as *mut [Self])
+                    }
+                }
+            }
+        };
+        thunk = quote! {
+            pub(crate) fn #thunk_ident(
+                __this: *mut #record_type, __other: *const #record_type, __n: usize);
+        };
+        thunk_impl = quote! {
+            extern "C" void #thunk_ident(
+                #this_cc_type __this, #const_record_cc_type* __other, std::size_t __n) {
+                std::uninitialized_copy_n(__other, __n, __this);
+            }
+        };
+    }
+    Ok(Some((helper, thunk, thunk_impl)))
+}
+
+/// Returns the Rust body of `func` if it is a trivial field accessor (see
+/// `TrivialFieldAccessor`) of a scalar field that the bindings of the record
+/// represent with its own type, and `None` otherwise.
+fn generate_trivial_field_accessor_body(
+    db: &dyn BindingsGenerator,
+    func: &Func,
+    impl_kind: &ImplKind,
+    param_types: &[RsTypeKind],
+    return_type: &RsTypeKind,
+    thunk_args: &[TokenStream],
+) -> Option<TokenStream> {
+    let accessor = func.trivial_field_accessor.as_ref()?;
+    let record = match impl_kind {
+        ImplKind::Struct { record, .. } => record,
+        _ => return None,
+    };
+    if !record.is_unpin() || record.is_union() {
+        return None;
+    }
+    // Bit-fields and `[[no_unique_address]]` fields are represented as blobs of bytes.
+    let field = record.fields.iter().find(|f| f.identifier.as_ref() == Some(&accessor.field))?;
+    if field.is_bitfield || field.is_no_unique_address {
+        return None;
+    }
+    // The offsets of non-public fields (imported with
+    // `CRUBIT_INTERNAL_IMPORT_PRIVATE_FIELDS`) can't be asserted with `offsetof` in
+    // `cc_struct_layout_assertion`, so their accessors keep calling into C++.
+    if field.access != AccessSpecifier::Public {
+        return None;
+    }
+    let field_type = db.rs_type_kind(field.type_.as_ref().ok()?.rs_type.clone()).ok()?;
+    fn is_scalar(type_: &RsTypeKind) -> bool {
+        match type_ {
+            RsTypeKind::Other { type_args, is_same_abi, .. } => {
+                type_args.is_empty() && *is_same_abi
+            }
+            RsTypeKind::Pointer { .. } => true,
+            RsTypeKind::TypeAlias { underlying_type, .. } => is_scalar(underlying_type),
+            _ => false,
+        }
+    }
+    if !is_scalar(&field_type) {
+        return None;
+    }
+    // The `__this` parameter must refer to the record, and be mutable for setters.
+    let this_mutability = match param_types.first() {
+        Some(RsTypeKind::Reference { referent, mutability, .. }) => match &**referent {
+            RsTypeKind::Record { record: this_record, .. } if this_record.id == record.id => {
+                mutability
+            }
+            _ => return None,
+        },
+        _ => return None,
+    };
+    let this = &thunk_args[0];
+    let field_ident = make_rs_ident(&accessor.field.identifier);
+    match accessor.kind {
+        TrivialFieldAccessorKind::Getter => {
+            if param_types.len() != 1 || *return_type != field_type {
+                return None;
+            }
+            Some(quote! { (*#this).#field_ident })
+        }
+        TrivialFieldAccessorKind::Setter => {
+            if param_types.len() != 2
+                || *this_mutability != Mutability::Mut
+                || param_types[1] != field_type
+                || *return_type != RsTypeKind::Unit
+            {
+                return None;
+            }
+            let value = &thunk_args[1];
+            Some(quote! { (*#this).#field_ident = #value; })
+        }
+    }
+}
+
 /// The function signature for a function's bindings.
 struct BindingsSignature {
     /// The lifetime parameters for the Rust function.
@@ -2360,6 +2971,7 @@ fn generate_record(db: &Database, record: &Rc<Record>) -> Result<GeneratedItem>
     };
 
     let no_unique_address_accessors = cc_struct_no_unique_address_impl(db, record)?;
+    let bitfield_accessors = cc_struct_bitfield_accessors_impl(db, record)?;
     let mut record_generated_items = record
         .child_item_ids
         .iter()
@@ -2406,6 +3018,8 @@ fn generate_record(db: &Database, record: &Rc<Record>) -> Result<GeneratedItem>
 
         #no_unique_address_accessors
 
+        #bitfield_accessors
+
         __NEWLINE__ __NEWLINE__
         #( #items __NEWLINE__ __NEWLINE__)*
     };
@@ -2729,6 +3343,35 @@ impl PartialEq for GeneratedItem {
 /// Returns generated bindings for an item, or `Err` if bindings generation
 /// failed in such a way as to make the generated bindings as a whole invalid.
 fn generate_item(db: &Database, item: &Item) -> Result<GeneratedItem> {
+    let pregenerated = db.pregenerated_items.borrow_mut().remove(&item.id());
+    if let Some(PregeneratedItem { generated, errors }) = pregenerated {
+        for error in &errors {
+            db.errors().insert(error);
+        }
+        return generated?.into_generated_item();
+    }
+    // Namespaces aren't cached: they are cheap to generate from their children,
+    // and their names depend on the other blocks of the same namespace.
+    let cache = match &db.generated_item_cache {
+        Some(cache) if !matches!(item, Item::Namespace(_)) => cache,
+        _ => return generate_item_uncached(db, item),
+    };
+    let key = cache.key(&db.ir(), item);
+    if let Some(generated) = cache.load(&key) {
+        return Ok(generated);
+    }
+    let reported_errors = db.reported_errors.get();
+    let generated = generate_item_uncached(db, item)?;
+    // Errors aren't cached, so items that report errors have to be generated
+    // again to report them.
+    if db.reported_errors.get() == reported_errors {
+        cache.store(&key, &generated);
+    }
+    Ok(generated)
+}
+
+/// Like `generate_item`, but doesn't look up the item in the caches.
+fn generate_item_uncached(db: &Database, item: &Item) -> Result<GeneratedItem> {
     match generate_item_impl(db, item) {
         Ok(generated) => Ok(generated),
         Err(err) => {
@@ -2930,72 +3573,528 @@ fn overloaded_funcs(db: &dyn BindingsGenerator) -> Rc<HashSet<Rc<FunctionId>>> {
     Rc::new(overloaded_funcs)
 }
 
-// Returns the Rust code implementing bindings, plus any auxiliary C++ code
-// needed to support it.
-fn generate_bindings_tokens(
-    ir: Rc<IR>,
-    crubit_support_path: &str,
-    errors: Rc<dyn ErrorReporting>,
-    generate_source_loc_doc_comment: SourceLocationDocComment,
-) -> Result<BindingsTokens> {
-    let mut db = Database::default();
-    db.set_ir(ir.clone());
-    db.set_generate_source_loc_doc_comment(generate_source_loc_doc_comment);
-    db.set_errors(errors);
-    let mut items = vec![];
-    let mut thunks = vec![];
-    let mut thunk_impls = vec![
-        generate_rs_api_impl_includes(&mut db, crubit_support_path)?,
-        quote! {
-            __HASH_TOKEN__ pragma clang diagnostic push __NEWLINE__
-            // Disable Clang thread-safety-analysis warnings that would otherwise
-            // complain about thunks that call mutex locking functions in an unpaired way.
-            __HASH_TOKEN__ pragma clang diagnostic ignored "-Wthread-safety-analysis" __NEWLINE__
-        },
-    ];
-    let mut assertions = vec![];
+/// Minimum number of items for each thread generating bindings in parallel.
+/// Below that, spawning threads and deserializing the IR on each of them costs
+/// more than it saves.
+const MIN_ITEMS_PER_GENERATOR_THREAD: usize = 256;
 
-    // We import nullable pointers as an Option<&T> and assume that at the ABI
-    // level, None is represented as a zero pointer value whereas Some is
-    // represented as as non-zero pointer value. This seems like a pretty safe
-    // assumption to make, but to provide some safeguard, assert that
-    // `Option<&i32>` and `&i32` have the same size.
-    assertions.push(quote! {
-        const _: () = assert!(::core::mem::size_of::<Option<&i32>>() == ::core::mem::size_of::<&i32>());
-    });
+/// Maximum number of threads generating bindings in parallel.
+///
+/// Each thread deserializes its own copy of the whole IR, dependencies
+/// included (the IR is built on `Rc`s, so it can't be shared across threads),
+/// so the peak memory use grows with the number of threads.
+const MAX_GENERATOR_THREADS: usize = 8;
+
+/// Returns the number of threads to generate `num_items` items of the current
+/// target on (see `items_to_pregenerate`).
+fn num_generator_threads(num_items: usize) -> usize {
+    let available = thread::available_parallelism().map_or(1, |n| n.get());
+    (num_items / MIN_ITEMS_PER_GENERATOR_THREAD).clamp(1, available.min(MAX_GENERATOR_THREADS))
+}
 
-    let mut features = BTreeSet::new();
+/// Returns the items that `pregenerate_items` generates: the items of the
+/// current target, other than namespaces. Namespaces are cheap, and generating
+/// them splices in the bindings of their children.
+fn items_to_pregenerate(ir: &IR) -> Result<Vec<ItemId>> {
+    let mut item_ids = vec![];
+    let mut pending: Vec<ItemId> = ir.top_level_item_ids().rev().copied().collect();
+    while let Some(item_id) = pending.pop() {
+        match ir.find_decl::<Item>(item_id)? {
+            Item::Namespace(namespace) => {
+                pending.extend(namespace.child_item_ids.iter().rev().copied())
+            }
+            item => {
+                if item.owning_target().map_or(true, |target| ir.is_current_target(target)) {
+                    item_ids.push(item_id);
+                }
+            }
+        }
+    }
+    Ok(item_ids)
+}
 
-    // For #![rustfmt::skip].
-    features.insert(make_rs_ident("custom_inner_attributes"));
+/// Generated source code of an item, as text.
+///
+/// Unlike `TokenStream`s, which are tied to the thread that created them, text
+/// can be sent across threads.
+struct GeneratedItemSource {
+    item: String,
+    thunks: String,
+    thunk_impls: String,
+    assertions: String,
+    features: Vec<String>,
+}
 
-    for top_level_item_id in ir.top_level_item_ids() {
-        let item =
-            ir.find_decl(*top_level_item_id).context("Failed to look up ir.top_level_item_ids")?;
-        let generated = generate_item(&db, item)?;
-        items.push(generated.item);
-        if !generated.thunks.is_empty() {
-            thunks.push(generated.thunks);
+impl GeneratedItemSource {
+    fn new(generated: &GeneratedItem) -> Self {
+        GeneratedItemSource {
+            item: generated.item.to_string(),
+            thunks: generated.thunks.to_string(),
+            thunk_impls: generated.thunk_impls.to_string(),
+            assertions: generated.assertions.to_string(),
+            features: generated.features.iter().map(|feature| feature.to_string()).collect(),
         }
-        if !generated.assertions.is_empty() {
-            assertions.push(generated.assertions);
-        }
-        if !generated.thunk_impls.is_empty() {
-            thunk_impls.push(generated.thunk_impls);
+    }
+
+    fn into_generated_item(self) -> Result<GeneratedItem> {
+        fn parse(source: &str) -> Result<TokenStream> {
+            source.parse().map_err(|err| anyhow!("Failed to parse generated code: {}", err))
         }
-        features.extend(generated.features);
+        Ok(GeneratedItem {
+            item: parse(&self.item)?,
+            thunks: parse(&self.thunks)?,
+            thunk_impls: parse(&self.thunk_impls)?,
+            assertions: parse(&self.assertions)?,
+            features: self.features.iter().map(|feature| make_rs_ident(feature)).collect(),
+        })
     }
+}
 
-    thunk_impls.push(quote! {
-        __NEWLINE__
-        __HASH_TOKEN__ pragma clang diagnostic pop __NEWLINE__
-        // To satisfy http://cs/symbol:devtools.metadata.Presubmit.CheckTerminatingNewline check.
-        __NEWLINE__
-    });
+/// The outcome of `generate_item` on one of the threads of `pregenerate_items`.
+struct PregeneratedItem {
+    generated: Result<GeneratedItemSource>,
+    /// Errors reported while generating the item. They are reported again when
+    /// the item is used, so that the error report is the same as if the item
+    /// had been generated on the calling thread.
+    errors: Vec<Error>,
+}
 
-    let mod_detail = if thunks.is_empty() {
-        quote! {}
-    } else {
+/// Records reported errors until they are taken by `pregenerate_items`.
+#[derive(Debug, Default)]
+struct ErrorRecorder {
+    errors: RefCell<Vec<Error>>,
+}
+
+impl ErrorReporting for ErrorRecorder {
+    fn insert(&self, error: &Error) {
+        self.errors.borrow_mut().push(error.clone());
+    }
+
+    fn serialize_to_vec(&self) -> anyhow::Result<Vec<u8>> {
+        let report = ErrorReport::new();
+        for error in self.errors.borrow().iter() {
+            report.insert(error);
+        }
+        report.serialize_to_vec()
+    }
+}
+
+/// Generates `item_ids` (see `items_to_pregenerate`) on `num_threads` threads,
+/// ahead of `generate_bindings_tokens_impl`.
+///
+/// Neither `IR` nor the `Database` can be shared across threads, so each thread
+/// gets its own copy of the IR from `make_ir` and its own `Database`.
+fn pregenerate_items(
+    make_ir: &(dyn Fn() -> Result<IR> + Sync),
+    item_ids: &[ItemId],
+    num_threads: usize,
+    generate_source_loc_doc_comment: SourceLocationDocComment,
+    generated_item_cache: Option<&GeneratedItemCache>,
+) -> Result<HashMap<ItemId, PregeneratedItem>> {
+    let next_item = AtomicUsize::new(0);
+    let generate_items = || -> Result<Vec<(ItemId, PregeneratedItem)>> {
+        let ir = Rc::new(make_ir()?);
+        let errors = Rc::new(ErrorRecorder::default());
+        let mut db = Database::default();
+        db.set_ir(ir.clone());
+        db.set_generate_source_loc_doc_comment(generate_source_loc_doc_comment);
+        db.set_errors(errors.clone());
+        if let Some(cache) = generated_item_cache {
+            db.enable_generated_item_cache(cache.clone());
+        }
+
+        let mut generated_items = vec![];
+        while let Some(&item_id) = item_ids.get(next_item.fetch_add(1, Ordering::Relaxed)) {
+            let generated = generate_item(&db, ir.find_decl::<Item>(item_id)?);
+            let errors = errors.errors.take();
+            generated_items.push((
+                item_id,
+                PregeneratedItem {
+                    generated: generated.map(|g| GeneratedItemSource::new(&g)),
+                    errors,
+                },
+            ));
+        }
+        Ok(generated_items)
+    };
+
+    thread::scope(|scope| {
+        let threads = (0..num_threads).map(|_| scope.spawn(generate_items)).collect_vec();
+        let mut pregenerated_items = HashMap::with_capacity(item_ids.len());
+        for thread in threads {
+            pregenerated_items.extend(thread.join().expect("generator thread panicked")?);
+        }
+        Ok(pregenerated_items)
+    })
+}
+
+/// Forwards reported errors to `errors`, and counts them.
+struct CountingErrorReporting {
+    errors: Rc<dyn ErrorReporting>,
+    count: Rc<Cell<usize>>,
+}
+
+impl ErrorReporting for CountingErrorReporting {
+    fn insert(&self, error: &Error) {
+        self.count.set(self.count.get() + 1);
+        self.errors.insert(error);
+    }
+
+    fn serialize_to_vec(&self) -> anyhow::Result<Vec<u8>> {
+        self.errors.serialize_to_vec()
+    }
+}
+
+/// Version of the format of the `GeneratedItemCache` entries and of their keys.
+/// Bump it whenever either of them, or the generated code, changes in a way
+/// that isn't covered by the key.
+const GENERATED_ITEM_CACHE_VERSION: u32 = 2;
+
+/// On-disk cache of generated items, which lets a run reuse the items generated
+/// by previous runs (see `--generated_item_cache_dir`).
+///
+/// salsa only memoizes the items within a run. This cache outlives the run: each
+/// entry is keyed by everything the generated code of the item depends on (see
+/// `write_item_dependencies`), so after an edit of the headers, only the items
+/// that are affected by the edit are generated again.
+///
+/// The entries are named after a hash of their key, and store the key itself,
+/// so that a hash collision is a cache miss rather than the wrong item.
+#[derive(Clone, Debug)]
+struct GeneratedItemCache {
+    dir: PathBuf,
+    /// The inputs that all the items of the run depend on.
+    run_key: String,
+    generate_source_loc_doc_comment: SourceLocationDocComment,
+}
+
+impl GeneratedItemCache {
+    fn new(
+        dir: &Path,
+        ir: &IR,
+        generate_source_loc_doc_comment: SourceLocationDocComment,
+    ) -> Result<Self> {
+        fs::create_dir_all(dir)
+            .with_context(|| format!("Failed to create the cache directory {}", dir.display()))?;
+        let mut run_key = format!("{GENERATED_ITEM_CACHE_VERSION}");
+        // A new build of the generator may generate different code for the same
+        // item.
+        if let Ok(metadata) = env::current_exe().and_then(fs::metadata) {
+            write!(run_key, " {} {:?}", metadata.len(), metadata.modified().ok()).unwrap();
+        }
+        write!(
+            run_key,
+            " {:?} {:?} {:?}",
+            ir.current_target(),
+            ir.crate_root_path(),
+            generate_source_loc_doc_comment
+        )
+        .unwrap();
+        Ok(GeneratedItemCache { dir: dir.to_path_buf(), run_key, generate_source_loc_doc_comment })
+    }
+
+    fn key(&self, ir: &IR, item: &Item) -> String {
+        let mut key = self.run_key.clone();
+        write_item_dependencies(ir, item, self.generate_source_loc_doc_comment, &mut key);
+        key
+    }
+
+    fn path(&self, key: &str) -> PathBuf {
+        let mut hasher = DefaultHasher::new();
+        key.hash(&mut hasher);
+        self.dir.join(format!("{:016x}.json", hasher.finish()))
+    }
+
+    /// Returns the cached item for `key`, if any. Entries that can't be read,
+    /// or that were stored for a different key with the same hash, are treated
+    /// as missing.
+    fn load(&self, key: &str) -> Option<GeneratedItem> {
+        let contents = fs::read(self.path(key)).ok()?;
+        let json: serde_json::Value = serde_json::from_slice(&contents).ok()?;
+        let field = |name: &str| json.get(name)?.as_str().map(str::to_string);
+        if field("key")? != key {
+            return None;
+        }
+        let source = GeneratedItemSource {
+            item: field("item")?,
+            thunks: field("thunks")?,
+            thunk_impls: field("thunk_impls")?,
+            assertions: field("assertions")?,
+            features: json
+                .get("features")?
+                .as_array()?
+                .iter()
+                .map(|feature| feature.as_str().map(str::to_string))
+                .collect::<Option<_>>()?,
+        };
+        source.into_generated_item().ok()
+    }
+
+    /// Stores `generated` as the item for `key`.
+    ///
+    /// The cache is only an optimization, so failing to write it isn't an
+    /// error. Entries are written to a temporary file first, so that
+    /// concurrent runs never see a partially written entry.
+    fn store(&self, key: &str, generated: &GeneratedItem) {
+        static NEXT_TEMP_FILE: AtomicUsize = AtomicUsize::new(0);
+        let source = GeneratedItemSource::new(generated);
+        let json = serde_json::json!({
+            "key": key,
+            "item": source.item,
+            "thunks": source.thunks,
+            "thunk_impls": source.thunk_impls,
+            "assertions": source.assertions,
+            "features": source.features,
+        });
+        let path = self.path(key);
+        let temp_path = path.with_extension(format!(
+            "{}.{}.tmp",
+            process::id(),
+            NEXT_TEMP_FILE.fetch_add(1, Ordering::Relaxed)
+        ));
+        if fs::write(&temp_path, json.to_string()).is_err() || fs::rename(&temp_path, path).is_err()
+        {
+            let _ = fs::remove_file(&temp_path);
+        }
+    }
+}
+
+/// Appends everything that the generated code of `item` depends on to `out`:
+///
+/// * the item itself, and the items it splices into its generated code (the
+///   children of a record),
+/// * the items referenced by their types, recursively,
+/// * the names of their enclosing namespaces,
+/// * the functions that `overloaded_funcs`, `get_binding` and
+///   `is_record_clonable` look up for them,
+/// * the Crubit features of the targets of all of these items.
+///
+/// Items are described by their contents (see `write_item_contents`), not by
+/// their ids, which change whenever the code before them in the header does.
+fn write_item_dependencies(
+    ir: &IR,
+    item: &Item,
+    generate_source_loc_doc_comment: SourceLocationDocComment,
+    out: &mut String,
+) {
+    // `true` for the items whose generated code is part of the generated code
+    // of `item`, as opposed to items that are only referenced.
+    let mut visited = HashMap::<ItemId, bool>::new();
+    let mut pending = vec![(item, true)];
+    while let Some((item, is_generated)) = pending.pop() {
+        if visited.get(&item.id()).map_or(false, |&was_generated| was_generated || !is_generated) {
+            continue;
+        }
+        visited.insert(item.id(), is_generated);
+        let mut push_id = |id: ItemId, is_generated: bool| {
+            if let Ok(item) = ir.find_decl::<Item>(id) {
+                pending.push((item, is_generated));
+            }
+        };
+        if let Item::Namespace(namespace) = item {
+            // Only the name of a namespace is used to qualify the items in it.
+            write!(out, "\n{:?}", namespace.name).unwrap();
+            if let Some(id) = namespace.enclosing_namespace_id {
+                push_id(id, false);
+            }
+            continue;
+        }
+        out.push('\n');
+        write_item_contents(item, generate_source_loc_doc_comment, out);
+        if let Some(target) = item.owning_target() {
+            write!(out, " {:?}", ir.target_crubit_features(target).bits()).unwrap();
+        }
+        if let Some(id) = item.enclosing_namespace_id() {
+            push_id(id, false);
+        }
+        let mut mapped_types = vec![];
+        match item {
+            Item::Func(func) => {
+                mapped_types.push(&func.return_type);
+                mapped_types.extend(func.params.iter().map(|param| &param.type_));
+                let record_id = func.member_func_metadata.as_ref().map(|meta| meta.record_id);
+                if let Some(id) = record_id {
+                    push_id(id, false);
+                }
+                if let Some(id) = func.adl_enclosing_record {
+                    push_id(id, false);
+                }
+                let overloads = ir.get_functions_by_name(&func.name).filter(|overload| {
+                    overload.member_func_metadata.as_ref().map(|meta| meta.record_id) == record_id
+                });
+                for overload in overloads {
+                    push_id(overload.id, false);
+                }
+                if let UnqualifiedIdentifier::Operator(op) = &func.name {
+                    if op.name.as_ref() == "<" {
+                        let eq = UnqualifiedIdentifier::Operator(Operator { name: Rc::from("==") });
+                        for eq_func in ir.get_functions_by_name(&eq) {
+                            push_id(eq_func.id, false);
+                        }
+                    }
+                }
+            }
+            Item::Record(record) => {
+                mapped_types
+                    .extend(record.fields.iter().filter_map(|field| field.type_.as_ref().ok()));
+                for base in &record.unambiguous_public_bases {
+                    push_id(base.base_record_id, false);
+                }
+                for &child_id in &record.child_item_ids {
+                    if is_generated {
+                        push_id(child_id, true);
+                    } else if let Ok(Item::Func(func)) = ir.find_decl::<Item>(child_id) {
+                        // `is_record_clonable` looks for a copy constructor.
+                        if func.name == UnqualifiedIdentifier::Constructor {
+                            push_id(child_id, false);
+                        }
+                    }
+                }
+            }
+            Item::Enum(enum_) => mapped_types.push(&enum_.underlying_type),
+            Item::TypeAlias(type_alias) => {
+                mapped_types.push(&type_alias.underlying_type);
+                if let Some(id) = type_alias.enclosing_record_id {
+                    push_id(id, false);
+                }
+            }
+            _ => {}
+        }
+        let mut rs_types: Vec<&RsType> =
+            mapped_types.iter().map(|mapped_type| &mapped_type.rs_type).collect();
+        while let Some(rs_type) = rs_types.pop() {
+            if let Some(id) = rs_type.decl_id {
+                push_id(id, false);
+            }
+            rs_types.extend(rs_type.type_args.iter());
+        }
+    }
+}
+
+/// Appends the contents of `item` to `out`, without the ids of the items it
+/// refers to, and without its source location unless it ends up in the doc
+/// comments.
+fn write_item_contents(
+    item: &Item,
+    generate_source_loc_doc_comment: SourceLocationDocComment,
+    out: &mut String,
+) {
+    macro_rules! without_source_loc {
+        ($item:expr, $empty:expr) => {{
+            let mut item = (**$item).clone();
+            item.source_loc = $empty;
+            format!("{item:?}")
+        }};
+    }
+    let contents = match (item, generate_source_loc_doc_comment) {
+        (_, SourceLocationDocComment::Enabled) => format!("{item:?}"),
+        (Item::Func(func), _) => without_source_loc!(func, "".into()),
+        (Item::Record(record), _) => without_source_loc!(record, "".into()),
+        (Item::Enum(enum_), _) => without_source_loc!(enum_, "".into()),
+        (Item::TypeAlias(type_alias), _) => without_source_loc!(type_alias, "".into()),
+        (Item::UnsupportedItem(unsupported), _) => without_source_loc!(unsupported, None),
+        _ => format!("{item:?}"),
+    };
+    const ITEM_ID: &str = "ItemId(";
+    let mut rest = contents.as_str();
+    while let Some(pos) = rest.find(ITEM_ID) {
+        out.push_str(&rest[..pos + ITEM_ID.len()]);
+        rest = rest[pos + ITEM_ID.len()..].trim_start_matches(|c: char| c.is_ascii_digit());
+    }
+    out.push_str(rest);
+}
+
+// Returns the Rust code implementing bindings, plus any auxiliary C++ code
+// needed to support it.
+fn generate_bindings_tokens(
+    ir: Rc<IR>,
+    crubit_support_path: &str,
+    errors: Rc<dyn ErrorReporting>,
+    generate_source_loc_doc_comment: SourceLocationDocComment,
+) -> Result<BindingsTokens> {
+    generate_bindings_tokens_impl(
+        ir,
+        crubit_support_path,
+        errors,
+        generate_source_loc_doc_comment,
+        HashMap::new(),
+        None,
+    )
+}
+
+/// Like `generate_bindings_tokens`, but uses the `pregenerated_items` instead
+/// of generating those items again, and looks up the other items in the
+/// `generated_item_cache`.
+fn generate_bindings_tokens_impl(
+    ir: Rc<IR>,
+    crubit_support_path: &str,
+    errors: Rc<dyn ErrorReporting>,
+    generate_source_loc_doc_comment: SourceLocationDocComment,
+    pregenerated_items: HashMap<ItemId, PregeneratedItem>,
+    generated_item_cache: Option<&GeneratedItemCache>,
+) -> Result<BindingsTokens> {
+    let mut db =
+        Database { pregenerated_items: RefCell::new(pregenerated_items), ..Default::default() };
+    db.set_ir(ir.clone());
+    db.set_generate_source_loc_doc_comment(generate_source_loc_doc_comment);
+    db.set_errors(errors);
+    if let Some(cache) = generated_item_cache {
+        db.enable_generated_item_cache(cache.clone());
+    }
+    let mut items = vec![];
+    let mut thunks = vec![];
+    let mut thunk_impls = vec![
+        generate_rs_api_impl_includes(&mut db, crubit_support_path)?,
+        quote! {
+            __HASH_TOKEN__ pragma clang diagnostic push __NEWLINE__
+            // Disable Clang thread-safety-analysis warnings that would otherwise
+            // complain about thunks that call mutex locking functions in an unpaired way.
+            __HASH_TOKEN__ pragma clang diagnostic ignored "-Wthread-safety-analysis" __NEWLINE__
+        },
+    ];
+    let mut assertions = vec![];
+
+    // We import nullable pointers as an Option<&T> and assume that at the ABI
+    // level, None is represented as a zero pointer value whereas Some is
+    // represented as as non-zero pointer value. This seems like a pretty safe
+    // assumption to make, but to provide some safeguard, assert that
+    // `Option<&i32>` and `&i32` have the same size.
+    assertions.push(quote! {
+        const _: () = assert!(::core::mem::size_of::<Option<&i32>>() == ::core::mem::size_of::<&i32>());
+    });
+
+    let mut features = BTreeSet::new();
+
+    // For #![rustfmt::skip].
+    features.insert(make_rs_ident("custom_inner_attributes"));
+
+    for top_level_item_id in ir.top_level_item_ids() {
+        let item =
+            ir.find_decl(*top_level_item_id).context("Failed to look up ir.top_level_item_ids")?;
+        let generated = generate_item(&db, item)?;
+        items.push(generated.item);
+        if !generated.thunks.is_empty() {
+            thunks.push(generated.thunks);
+        }
+        if !generated.assertions.is_empty() {
+            assertions.push(generated.assertions);
+        }
+        if !generated.thunk_impls.is_empty() {
+            thunk_impls.push(generated.thunk_impls);
+        }
+        features.extend(generated.features);
+    }
+
+    thunk_impls.push(quote! {
+        __NEWLINE__
+        __HASH_TOKEN__ pragma clang diagnostic pop __NEWLINE__
+        // To satisfy http://cs/symbol:devtools.metadata.Presubmit.CheckTerminatingNewline check.
+        __NEWLINE__
+    });
+
+    let mod_detail = if thunks.is_empty() {
+        quote! {}
+    } else {
         quote! {
             mod detail {
                 #[allow(unused_imports)]
@@ -3016,6 +4115,16 @@ fn generate_bindings_tokens(
         }
     };
 
+    // The Rust types of spans, vectors and strings are named by their path in
+    // `cc_std` (see `ContiguousStorageType` in `type_map.h`), which also has to
+    // resolve in the bindings for the standard library headers, i.e. `cc_std`
+    // itself.
+    let cc_std_self_alias = if ir.current_target().target_name() == "cc_std" {
+        quote! { extern crate self as cc_std; __NEWLINE__ __NEWLINE__ }
+    } else {
+        quote! {}
+    };
+
     Ok(BindingsTokens {
         rs_api: quote! {
             #features __NEWLINE__
@@ -3033,6 +4142,8 @@ fn generate_bindings_tokens(
 
             #![deny(warnings)] __NEWLINE__ __NEWLINE__
 
+            #cc_std_self_alias
+
             #( #items __NEWLINE__ __NEWLINE__ )*
 
             #mod_detail __NEWLINE__ __NEWLINE__
@@ -3263,9 +4374,13 @@ impl RsTypeKind {
             // of fields may change the ABI, which means that we can no longer assume
             // that `extern "C"` ABI thunks can pass such types by value.
             //
-            // TODO(b/274177296): Return `true` for structs where bindings replicate the type of
-            // all the fields.
-            RsTypeKind::Record { .. } => false,
+            // Trivially relocatable structs whose fields all keep their type can be passed
+            // like the equivalent C struct (i.e. in registers where the C ABI allows), and
+            // moved with a `memcpy`.
+            //
+            // TODO(b/274177296): Return `true` for more structs where bindings replicate the
+            // type of all the fields (e.g. fields of record types).
+            RsTypeKind::Record { record, .. } => has_c_abi_compatible_fields(record),
             RsTypeKind::Other { is_same_abi, .. } => *is_same_abi,
             _ => true,
         }
@@ -3368,6 +4483,7 @@ impl RsTypeKind {
                 // to a trait impl that take the first argument by value.
                 Ok(RsSnippet::new(quote! { self }))
             }
+            RsTypeKind::TypeAlias { underlying_type, .. } => underlying_type.format_as_self_param(),
             _ => bail!("Unexpected type of `self` parameter: {:?}", self),
         }
     }
@@ -4017,6 +5133,149 @@ fn cc_struct_no_unique_address_impl(db: &Database, record: &Record) -> Result<To
     })
 }
 
+/// Returns the number of bits of `type_` if it is an integer type that a
+/// bit-field can have, and whether it is signed. For platform-dependent types,
+/// returns the smallest possible number of bits.
+fn bitfield_integer_type(type_: &RsTypeKind) -> Option<(usize, bool)> {
+    match type_ {
+        RsTypeKind::TypeAlias { underlying_type, .. } => bitfield_integer_type(underlying_type),
+        RsTypeKind::Other { name, type_args, .. } if type_args.is_empty() => {
+            Some(match name.as_ref() {
+                "i8" | "::core::ffi::c_schar" => (8, true),
+                "u8" | "::core::ffi::c_uchar" => (8, false),
+                "i16" | "::core::ffi::c_short" => (16, true),
+                "u16" | "::core::ffi::c_ushort" => (16, false),
+                "i32" | "::core::ffi::c_int" | "::core::ffi::c_long" => (32, true),
+                "u32" | "::core::ffi::c_uint" | "::core::ffi::c_ulong" => (32, false),
+                "i64" | "isize" | "::core::ffi::c_longlong" => (64, true),
+                "u64" | "usize" | "::core::ffi::c_ulonglong" => (64, false),
+                _ => return None,
+            })
+        }
+        _ => None,
+    }
+}
+
+/// Returns the accessor functions for public bit-fields, which are otherwise
+/// only represented as opaque blobs of bytes.
+///
+/// The accessors read and write the bytes that hold the bit-field, at the
+/// offset computed by Clang, so they compile to a load (and a store) instead
+/// of a thunk call. They assume the little-endian Itanium layout of
+/// bit-fields, and are therefore only available on little-endian targets.
+///
+/// Only the bytes that hold bits of the bit-field are read, into an otherwise
+/// zeroed `MaybeUninit<[u8; 8]>`; the bits of the neighboring fields that
+/// share those bytes are masked out. In particular, the accessors never read
+/// the padding after the bit-field, which may be uninitialized.
+fn cc_struct_bitfield_accessors_impl(db: &Database, record: &Record) -> Result<TokenStream> {
+    let ir = db.ir();
+    let mut accessors = vec![];
+    for field in &record.fields {
+        if field.access != AccessSpecifier::Public || !field.is_bitfield || field.size == 0 {
+            continue;
+        }
+        let (identifier, type_) = match (&field.identifier, &field.type_) {
+            (Some(identifier), Ok(mapped_type)) => {
+                match db.rs_type_kind(mapped_type.rs_type.clone()) {
+                    Ok(type_) => (identifier, type_),
+                    Err(_) => continue,
+                }
+            }
+            _ => continue,
+        };
+        let width = field.size;
+        let shift = field.offset % 8;
+        // The bit-field must fit in its type, and the bytes holding it in a `u64`.
+        let is_bool = matches!(&type_, RsTypeKind::Other { name, .. } if name.as_ref() == "bool");
+        let is_signed = match bitfield_integer_type(&type_) {
+            _ if is_bool && width == 1 => false,
+            Some((bits, is_signed)) if width <= bits && shift + width <= 64 => is_signed,
+            _ => continue,
+        };
+
+        let byte_offset = Literal::usize_unsuffixed(field.offset / 8);
+        let num_bytes = Literal::usize_unsuffixed((shift + width + 7) / 8);
+        let mask = Literal::u64_unsuffixed(u64::MAX >> (64 - width));
+        let shift = Literal::usize_unsuffixed(shift);
+        let getter = make_rs_ident(&identifier.identifier);
+        let value = if is_bool {
+            quote! { bits != 0 }
+        } else if is_signed {
+            let unused_bits = Literal::usize_unsuffixed(64 - width);
+            quote! { ((bits << #unused_bits) as i64 >> #unused_bits) as #type_ }
+        } else {
+            quote! { bits as #type_ }
+        };
+        accessors.push(quote! {
+            #[inline(always)]
+            pub fn #getter(&self) -> #type_ {
+                let bytes = unsafe {
+                    let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+                    ::core::ptr::copy_nonoverlapping(
+                        (self as *const Self as *const u8).add(#byte_offset),
+                        bytes.as_mut_ptr() as *mut u8,
+                        #num_bytes,
+                    );
+                    bytes.assume_init()
+                };
+                let bits = (u64::from_le_bytes(bytes) >> #shift) & #mask;
+                #value
+            }
+        });
+
+        // Skip the setter if its name is already taken, e.g. by a C++ method.
+        let setter_name = format!("set_{}", identifier.identifier);
+        let is_setter_name_taken =
+            record.fields.iter().any(|f| {
+                f.identifier.as_ref().map(|i| i.identifier.as_ref()) == Some(&*setter_name)
+            }) || record.child_item_ids.iter().any(|id| match ir.find_decl::<Rc<Func>>(*id) {
+                Ok(func) => matches!(
+                    &func.name,
+                    UnqualifiedIdentifier::Identifier(i) if *i.identifier == *setter_name
+                ),
+                Err(_) => false,
+            });
+        if is_setter_name_taken {
+            continue;
+        }
+        let setter = make_rs_ident(&setter_name);
+        let (self_param, this) = if record.is_unpin() {
+            (quote! { &mut self }, quote! { self as *mut Self })
+        } else {
+            (
+                quote! { self: ::core::pin::Pin<&mut Self> },
+                quote! { ::core::pin::Pin::into_inner_unchecked(self) as *mut Self },
+            )
+        };
+        accessors.push(quote! {
+            #[inline(always)]
+            pub fn #setter(#self_param, value: #type_) {
+                unsafe {
+                    let ptr = (#this as *mut u8).add(#byte_offset);
+                    let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+                    ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr() as *mut u8, #num_bytes);
+                    let bits = (u64::from_le_bytes(bytes.assume_init()) & !(#mask << #shift))
+                        | (((value as u64) & #mask) << #shift);
+                    ::core::ptr::copy_nonoverlapping(bits.to_le_bytes().as_ptr(), ptr, #num_bytes);
+                }
+            }
+        });
+    }
+
+    if accessors.is_empty() {
+        return Ok(quote! {});
+    }
+
+    let ident = make_rs_ident(record.rs_name.as_ref());
+    Ok(quote! {
+        #[cfg(target_endian = "little")]
+        impl #ident {
+            #( #accessors )*
+        }
+    })
+}
+
 fn crate_root_path_tokens(ir: &IR) -> TokenStream {
     match ir.crate_root_path().as_deref().map(make_rs_ident) {
         None => quote! { crate },
@@ -4024,6 +5283,69 @@ fn crate_root_path_tokens(ir: &IR) -> TokenStream {
     }
 }
 
+/// Returns true if `type_` is a type that is always represented by the same
+/// Rust type when it is the type of a field: a fundamental type, or a pointer
+/// to one.
+fn is_c_abi_compatible_field_type(type_: &RsType) -> bool {
+    if type_.decl_id.is_some() {
+        return false;
+    }
+    match (type_.name.as_deref(), &*type_.type_args) {
+        (Some("*mut" | "*const"), [pointee]) => {
+            pointee.is_unit_type() || is_c_abi_compatible_field_type(pointee)
+        }
+        (Some(name), []) => matches!(
+            name,
+            "bool"
+                | "f32"
+                | "f64"
+                | "i8"
+                | "u8"
+                | "i16"
+                | "u16"
+                | "i32"
+                | "u32"
+                | "i64"
+                | "u64"
+                | "isize"
+                | "usize"
+                | "::core::ffi::c_schar"
+                | "::core::ffi::c_uchar"
+                | "::core::ffi::c_short"
+                | "::core::ffi::c_ushort"
+                | "::core::ffi::c_int"
+                | "::core::ffi::c_uint"
+                | "::core::ffi::c_long"
+                | "::core::ffi::c_ulong"
+                | "::core::ffi::c_longlong"
+                | "::core::ffi::c_ulonglong"
+        ),
+        _ => false,
+    }
+}
+
+/// Returns true if the generated Rust struct for `record` has the same
+/// `extern "C"` ABI as the C++ struct, so that values of the struct can be
+/// passed and returned by value without a thunk.
+///
+/// This requires the record to be trivially relocatable (see
+/// `Record::is_unpin`), and all of its fields to keep their C++ type in Rust
+/// (rather than being replaced by opaque blobs of bytes, like bit-fields and
+/// `[[no_unique_address]]` fields are). The latter is conservatively limited
+/// to fields of fundamental types, and pointers to them.
+fn has_c_abi_compatible_fields(record: &Record) -> bool {
+    record.is_unpin()
+        && !record.is_union()
+        && !record.is_derived_class
+        && !record.override_alignment
+        && !record.fields.is_empty()
+        && record.fields.iter().all(|field| {
+            !field.is_bitfield
+                && !field.is_no_unique_address
+                && matches!(&field.type_, Ok(t) if is_c_abi_compatible_field_type(&t.rs_type))
+        })
+}
+
 /// Returns the implementation of base class conversions, for converting a type
 /// to its unambiguous public base classes.
 fn cc_struct_upcast_impl(record: &Rc<Record>, ir: &IR) -> Result<GeneratedItem> {
@@ -4040,6 +5362,21 @@ fn cc_struct_upcast_impl(record: &Rc<Record>, ir: &IR) -> Result<GeneratedItem>
         if let Some(offset) = base.offset {
             let offset = Literal::i64_unsuffixed(offset);
             body = quote! {(derived as *const _ as *const u8).offset(#offset) as *const #base_name};
+        } else if let Some(vbase) = &base.virtual_base_offset {
+            // Read the offset of the virtual base from the vtable, the same way compiled C++
+            // code does, instead of calling into C++.
+            let vbase_offset_offset = Literal::i64_unsuffixed(vbase.vbase_offset_offset);
+            let offset = if vbase.offset_in_vbase == 0 {
+                quote! { vbase_offset }
+            } else {
+                let offset_in_vbase = Literal::i64_unsuffixed(vbase.offset_in_vbase);
+                quote! { vbase_offset + #offset_in_vbase }
+            };
+            body = quote! {
+                let vptr = *(derived as *const *const u8);
+                let vbase_offset = *(vptr.offset(#vbase_offset_offset) as *const isize);
+                (derived as *const u8).offset(#offset) as *const #base_name
+            };
         } else {
             let cast_fn_name = make_rs_ident(&format!(
                 "__crubit_dynamic_upcast__{}__to__{}",
@@ -4151,9 +5488,13 @@ fn generate_func_thunk_impl(db: &dyn BindingsGenerator, func: &Func) -> Result<T
                 Some("&") => Ok(quote! { * #ident }),
                 Some("&&") => Ok(quote! { std::move(* #ident) }),
                 _ => {
+                    let type_ = db.rs_type_kind(p.type_.rs_type.clone())?;
                     // non-Unpin types are wrapped by a pointer in the thunk.
-                    if !db.rs_type_kind(p.type_.rs_type.clone())?.is_c_abi_compatible_by_value() {
+                    if !type_.is_c_abi_compatible_by_value() {
                         Ok(quote! { std::move(* #ident) })
+                    } else if let RsTypeKind::Record { .. } = type_ {
+                        // Records passed by value are moved rather than copied, as above.
+                        Ok(quote! { std::move(#ident) })
                     } else {
                         Ok(quote! { #ident })
                     }
@@ -4260,6 +5601,9 @@ fn generate_rs_api_impl_includes(
             format!("{crubit_support_path}/internal/sizeof.h").into(),
         ));
     };
+    if ir.functions().any(|func| func.has_batch_thunk) {
+        internal_includes.insert(CcInclude::cstddef()); // `std::size_t` in batch thunks.
+    }
     for crubit_header in ["internal/cxx20_backports.h", "internal/offsetof.h"] {
         internal_includes.insert(CcInclude::user_header(
             format!("{crubit_support_path}/{crubit_header}").into(),
@@ -4306,6 +5650,9 @@ mod tests {
     fn ir_record(name: &str) -> Record {
         ir_testing::ir_record(multiplatform_testing::test_platform(), name)
     }
+    fn ir_from_cc_in_target(header: &str, target: &str) -> Result<IR> {
+        ir_testing::ir_from_cc_in_target(multiplatform_testing::test_platform(), header, target)
+    }
 
     fn generate_bindings_tokens(ir: IR) -> Result<BindingsTokens> {
         super::generate_bindings_tokens(
@@ -4322,6 +5669,158 @@ mod tests {
         Ok(db)
     }
 
+    #[test]
+    fn test_pregenerated_items_match_serial_generation() -> Result<()> {
+        let header = r#"
+            inline int Add(int a, int b) { return a + b; }
+            struct S {
+                using Alias = int;
+                int field;
+            };
+            namespace ns {
+                struct T final { S s; };
+                inline void Take(T& t) {}
+                namespace inner { enum E { kA, kB }; }
+            }
+            namespace ns { inline int Get(const T& t) { return t.s.field; } }
+        "#;
+        let serial_errors = Rc::new(ErrorReport::new());
+        let serial = super::generate_bindings_tokens(
+            Rc::new(ir_from_cc(header)?),
+            "crubit/rs_bindings_support",
+            serial_errors.clone(),
+            SourceLocationDocComment::Enabled,
+        )?;
+
+        let ir = Rc::new(ir_from_cc(header)?);
+        let pregenerated_items = pregenerate_items(
+            &|| ir_from_cc(header),
+            &items_to_pregenerate(&ir)?,
+            /* num_threads= */ 4,
+            SourceLocationDocComment::Enabled,
+            /* generated_item_cache= */ None,
+        )?;
+        assert!(!pregenerated_items.is_empty());
+        let parallel_errors = Rc::new(ErrorReport::new());
+        let parallel = generate_bindings_tokens_impl(
+            ir,
+            "crubit/rs_bindings_support",
+            parallel_errors.clone(),
+            SourceLocationDocComment::Enabled,
+            pregenerated_items,
+            /* generated_item_cache= */ None,
+        )?;
+
+        assert_eq!(parallel.rs_api.to_string(), serial.rs_api.to_string());
+        assert_eq!(parallel.rs_api_impl.to_string(), serial.rs_api_impl.to_string());
+        assert_eq!(parallel_errors.serialize_to_vec()?, serial_errors.serialize_to_vec()?);
+        Ok(())
+    }
+
+    #[test]
+    fn test_items_to_pregenerate() -> Result<()> {
+        let ir = ir_from_cc_dependency(
+            "namespace ns { inline void Foo() {} }",
+            "inline void Dependency() {}",
+        )?;
+        let names = items_to_pregenerate(&ir)?
+            .into_iter()
+            .map(|id| ir.find_decl::<Item>(id).map(|item| item.debug_name(&ir).to_string()))
+            .collect::<Result<Vec<_>>>()?;
+        assert!(names.iter().any(|name| name.contains("Foo")));
+        assert!(!names.iter().any(|name| name.contains("Dependency")));
+        assert!(!names.iter().any(|name| name == "ns"));
+        Ok(())
+    }
+
+    #[test]
+    fn test_num_generator_threads() {
+        assert_eq!(num_generator_threads(0), 1);
+        assert_eq!(num_generator_threads(MIN_ITEMS_PER_GENERATOR_THREAD - 1), 1);
+        assert!(num_generator_threads(usize::MAX) <= MAX_GENERATOR_THREADS);
+    }
+
+    #[test]
+    fn test_generated_item_cache() -> Result<()> {
+        let cache_dir = tempfile::tempdir()?;
+        let generate_cached_with =
+            |header: &str, source_loc: SourceLocationDocComment| -> Result<String> {
+                let ir = Rc::new(ir_from_cc(header)?);
+                let cache = GeneratedItemCache::new(cache_dir.path(), &ir, source_loc)?;
+                let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens_impl(
+                    ir,
+                    "crubit/rs_bindings_support",
+                    Rc::new(IgnoreErrors),
+                    source_loc,
+                    HashMap::new(),
+                    Some(&cache),
+                )?;
+                Ok(format!("{rs_api}\n{rs_api_impl}"))
+            };
+        let generate_cached =
+            |header: &str| generate_cached_with(header, SourceLocationDocComment::Enabled);
+        let generate_uncached = |header: &str| -> Result<String> {
+            let BindingsTokens { rs_api, rs_api_impl } =
+                generate_bindings_tokens(ir_from_cc(header)?)?;
+            Ok(format!("{rs_api}\n{rs_api_impl}"))
+        };
+        let cache_entries = || -> Result<Vec<PathBuf>> {
+            Ok(fs::read_dir(cache_dir.path())?.map(|entry| entry.unwrap().path()).collect())
+        };
+
+        let header = r#"
+            struct S { int field; };
+            inline int Get(const S& s) { return s.field; }
+        "#;
+        let bindings = generate_cached(header)?;
+        assert_eq!(bindings, generate_uncached(header)?);
+        let num_entries = cache_entries()?.len();
+        assert_ne!(num_entries, 0);
+        assert_eq!(generate_cached(header)?, bindings);
+        assert_eq!(cache_entries()?.len(), num_entries);
+
+        // Items whose dependencies change are generated again.
+        let edited_header = r#"
+            struct S { int field; int other_field; };
+            inline int Get(const S& s) { return s.field; }
+        "#;
+        assert_eq!(generate_cached(edited_header)?, generate_uncached(edited_header)?);
+
+        // Items that didn't change are taken from the cache.
+        let replace_cached_items = || -> Result<()> {
+            for path in cache_entries()? {
+                let mut entry: serde_json::Value = serde_json::from_slice(&fs::read(&path)?)?;
+                entry["item"] = "struct CachedItem;".into();
+                entry["thunks"] = "".into();
+                entry["thunk_impls"] = "".into();
+                entry["assertions"] = "".into();
+                entry["features"] = serde_json::json!([]);
+                fs::write(path, entry.to_string())?;
+            }
+            Ok(())
+        };
+        replace_cached_items()?;
+        assert!(generate_cached(header)?.contains("struct CachedItem"));
+
+        // Entries stored for a different key with the same hash are ignored.
+        for path in cache_entries()? {
+            let mut entry: serde_json::Value = serde_json::from_slice(&fs::read(&path)?)?;
+            entry["key"] = "some other key".into();
+            fs::write(path, entry.to_string())?;
+        }
+        assert!(!generate_cached(header)?.contains("struct CachedItem"));
+
+        // Moving the items in the header changes their ids and source locations,
+        // which only matters if the source locations are in the doc comments.
+        let moved_header = format!("\n\n{header}");
+        generate_cached_with(header, SourceLocationDocComment::Disabled)?;
+        replace_cached_items()?;
+        assert!(generate_cached_with(&moved_header, SourceLocationDocComment::Disabled)?
+            .contains("struct CachedItem"));
+        assert!(!generate_cached(&moved_header)?.contains("struct CachedItem"));
+        Ok(())
+    }
+
     #[test]
     fn test_disable_thread_safety_warnings() -> Result<()> {
         let ir = ir_from_cc("inline void foo() {}")?;
@@ -4348,68 +5847,387 @@ mod tests {
         assert_rs_matches!(
             rs_api,
             quote! {
-                #[inline(always)]
-                pub fn Add(a: ::core::ffi::c_int, b: ::core::ffi::c_int) -> ::core::ffi::c_int {
-                    unsafe { crate::detail::__rust_thunk___Z3Addii(a, b) }
-                }
+                #[inline(always)]
+                pub fn Add(a: ::core::ffi::c_int, b: ::core::ffi::c_int) -> ::core::ffi::c_int {
+                    unsafe { crate::detail::__rust_thunk___Z3Addii(a, b) }
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                mod detail {
+                    #[allow(unused_imports)]
+                    use super::*;
+                    extern "C" {
+                        #[link_name = "_Z3Addii"]
+                        pub(crate) fn __rust_thunk___Z3Addii(a: ::core::ffi::c_int, b: ::core::ffi::c_int) -> ::core::ffi::c_int;
+                    }
+                }
+            }
+        );
+
+        assert_cc_not_matches!(rs_api_impl, quote! {__rust_thunk___Z3Addii});
+
+        Ok(())
+    }
+
+    #[test]
+    fn test_inline_function() -> Result<()> {
+        let ir = ir_from_cc("inline int Add(int a, int b);")?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                #[inline(always)]
+                pub fn Add(a: ::core::ffi::c_int, b: ::core::ffi::c_int) -> ::core::ffi::c_int {
+                    unsafe { crate::detail::__rust_thunk___Z3Addii(a, b) }
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                mod detail {
+                    #[allow(unused_imports)]
+                    use super::*;
+                    extern "C" {
+                        pub(crate) fn __rust_thunk___Z3Addii(a: ::core::ffi::c_int, b: ::core::ffi::c_int) -> ::core::ffi::c_int;
+                    }
+                }
+            }
+        );
+
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" int __rust_thunk___Z3Addii(int a, int b) {
+                    return Add(a, b);
+                }
+            }
+        );
+        Ok(())
+    }
+
+    #[test]
+    fn test_trivial_field_accessors_have_no_thunks() -> Result<()> {
+        let ir = ir_from_cc(
+            r#" #pragma clang lifetime_elision
+                struct SomeStruct final {
+                  int get_field() const { return field; }
+                  void set_field(int value) { field = value; }
+                  int field;
+                }; "#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                #[inline(always)]
+                pub fn get_field<'a>(&'a self) -> ::core::ffi::c_int {
+                    (*self).field
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                #[inline(always)]
+                pub fn set_field<'a>(&'a mut self, value: ::core::ffi::c_int) {
+                    (*self).field = value;
+                }
+            }
+        );
+        assert_rs_not_matches!(rs_api, quote! {__rust_thunk___ZNK10SomeStruct9get_fieldEv});
+        assert_rs_not_matches!(rs_api, quote! {__rust_thunk___ZN10SomeStruct9set_fieldEi});
+        assert_cc_not_matches!(rs_api_impl, quote! {__rust_thunk___ZNK10SomeStruct9get_fieldEv});
+        assert_cc_not_matches!(rs_api_impl, quote! {__rust_thunk___ZN10SomeStruct9set_fieldEi});
+        Ok(())
+    }
+
+    #[test]
+    fn test_private_field_accessor_has_thunk() -> Result<()> {
+        let ir = ir_from_cc(
+            r#" #pragma clang lifetime_elision
+                class [[clang::annotate("crubit_internal_import_private_fields")]]
+                SomeClass final {
+                 public:
+                  int get_field() const { return field_; }
+                 private:
+                  int field_;
+                }; "#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_not_matches!(rs_api, quote! { (*self).field_ });
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" int __rust_thunk___ZNK9SomeClass9get_fieldEv(
+                        const class SomeClass* __this) {
+                    return __this->get_field();
+                }
+            }
+        );
+        // Only the offsets of public fields can be asserted.
+        assert_cc_not_matches!(rs_api_impl, quote! { CRUBIT_OFFSET_OF(field_, ...) });
+        Ok(())
+    }
+
+    #[test]
+    fn test_nontrivial_field_accessor_has_thunk() -> Result<()> {
+        let ir = ir_from_cc(
+            r#" #pragma clang lifetime_elision
+                struct SomeStruct final {
+                  int get_field() const { return field + 1; }
+                  int field;
+                }; "#,
+        )?;
+        let BindingsTokens { rs_api_impl, .. } = generate_bindings_tokens(ir)?;
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" int __rust_thunk___ZNK10SomeStruct9get_fieldEv(
+                        const struct SomeStruct* __this) {
+                    return __this->get_field();
+                }
+            }
+        );
+        Ok(())
+    }
+
+    #[test]
+    fn test_batch_thunk() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+                namespace ns {
+                [[clang::annotate("crubit_internal_batch_thunk")]]
+                int Add(int a, int b);
+                }  // namespace ns
+            "#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub fn Add(a: ::core::ffi::c_int, b: ::core::ffi::c_int) -> ::core::ffi::c_int { ... }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                #[inline(always)]
+                pub fn Add_batch(
+                    a: &[::core::ffi::c_int],
+                    b: &[::core::ffi::c_int],
+                    __return: &mut [::core::ffi::c_int]
+                ) {
+                    let __n = a.len();
+                    assert_eq!(b.len(), __n);
+                    assert_eq!(__return.len(), __n);
+                    unsafe {
+                        crate::detail::__rust_batch_thunk___ZN2ns3AddEii(
+                            __n, a.as_ptr(), b.as_ptr(), __return.as_mut_ptr()
+                        )
+                    }
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub(crate) fn __rust_batch_thunk___ZN2ns3AddEii(
+                    __n: usize,
+                    a: *const ::core::ffi::c_int,
+                    b: *const ::core::ffi::c_int,
+                    __return: *mut ::core::ffi::c_int
+                );
+            }
+        );
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" void __rust_batch_thunk___ZN2ns3AddEii(
+                        std::size_t __n, const int* a, const int* b, int* __return) {
+                    for (std::size_t __i = 0; __i < __n; ++__i) {
+                        __return[__i] = ns::Add(a[__i], b[__i]);
+                    }
+                }
+            }
+        );
+        Ok(())
+    }
+
+    #[test]
+    fn test_batch_thunk_unsupported_param_type() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+                [[clang::annotate("crubit_internal_batch_thunk")]]
+                int Deref(const int* p);
+            "#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub unsafe fn Deref(p: *const ::core::ffi::c_int) -> ::core::ffi::c_int { ... }
             }
         );
         assert_rs_matches!(
             rs_api,
             quote! {
-                mod detail {
-                    #[allow(unused_imports)]
-                    use super::*;
-                    extern "C" {
-                        #[link_name = "_Z3Addii"]
-                        pub(crate) fn __rust_thunk___Z3Addii(a: ::core::ffi::c_int, b: ::core::ffi::c_int) -> ::core::ffi::c_int;
-                    }
-                }
+                __COMMENT__ "Error while generating the batch variant of \"Deref\":\nBatch thunks require `Copy` parameter and return types that are passed by value"
             }
         );
+        assert_rs_not_matches!(rs_api, quote! { Deref_batch });
+        assert_cc_not_matches!(rs_api_impl, quote! { __rust_batch_thunk___Z5DerefPKi });
+        Ok(())
+    }
 
-        assert_cc_not_matches!(rs_api_impl, quote! {__rust_thunk___Z3Addii});
-
+    #[test]
+    fn test_batch_thunk_unsupported_span_param() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+                namespace absl {
+                template <typename T>
+                class Span {
+                  T* ptr_;
+                  decltype(sizeof(0)) len_;
+                };
+                }  // namespace absl
+                [[clang::annotate("crubit_internal_batch_thunk")]]
+                int Sum(absl::Span<const int> values);
+            "#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub unsafe fn Sum(values: ::cc_std::Span<::core::ffi::c_int>) -> ::core::ffi::c_int { ... }
+            }
+        );
+        assert_rs_not_matches!(rs_api, quote! { Sum_batch });
+        assert_cc_not_matches!(rs_api_impl, quote! { __rust_batch_thunk___Z3SumN4absl4SpanIKiEE });
         Ok(())
     }
 
     #[test]
-    fn test_inline_function() -> Result<()> {
-        let ir = ir_from_cc("inline int Add(int a, int b);")?;
+    fn test_span_param() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+                namespace absl {
+                template <typename T>
+                class Span {
+                  T* ptr_;
+                  decltype(sizeof(0)) len_;
+                };
+                }  // namespace absl
+                int Sum(absl::Span<const int> values);
+                void Fill(absl::Span<int> values);
+            "#,
+        )?;
         let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
         assert_rs_matches!(
             rs_api,
             quote! {
-                #[inline(always)]
-                pub fn Add(a: ::core::ffi::c_int, b: ::core::ffi::c_int) -> ::core::ffi::c_int {
-                    unsafe { crate::detail::__rust_thunk___Z3Addii(a, b) }
-                }
+                pub unsafe fn Sum(values: ::cc_std::Span<::core::ffi::c_int>) -> ::core::ffi::c_int { ... }
             }
         );
         assert_rs_matches!(
             rs_api,
             quote! {
-                mod detail {
-                    #[allow(unused_imports)]
-                    use super::*;
-                    extern "C" {
-                        pub(crate) fn __rust_thunk___Z3Addii(a: ::core::ffi::c_int, b: ::core::ffi::c_int) -> ::core::ffi::c_int;
-                    }
-                }
+                pub unsafe fn Fill(values: ::cc_std::SpanMut<::core::ffi::c_int>) { ... }
             }
         );
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                static_assert(sizeof(absl::Span<const int>) == 2 * sizeof(void*));
+                static_assert(alignof(absl::Span<const int>) == alignof(void*));
+            }
+        );
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                static_assert(sizeof(absl::Span<int>) == 2 * sizeof(void*));
+                static_assert(alignof(absl::Span<int>) == alignof(void*));
+            }
+        );
+        Ok(())
+    }
 
+    #[test]
+    fn test_vector_reference_param() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+                #pragma clang lifetime_elision
+                namespace std {
+                template <typename T>
+                class allocator {};
+                template <typename T, typename Alloc = allocator<T>>
+                class vector {
+                  T* __begin_;
+                  T* __end_;
+                  T* __end_cap_;
+                };
+                }  // namespace std
+                int Sum(const std::vector<int>& values);
+            "#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub fn Sum<'a>(values: &'a ::cc_std::Vector<::core::ffi::c_int>)
+                    -> ::core::ffi::c_int { ... }
+            }
+        );
         assert_cc_matches!(
             rs_api_impl,
             quote! {
-                extern "C" int __rust_thunk___Z3Addii(int a, int b) {
-                    return Add(a, b);
-                }
+                static_assert(sizeof(std::vector<int, std::allocator<int> >) == 3 * sizeof(void*));
             }
         );
         Ok(())
     }
 
+    #[test]
+    fn test_string_reference_param_in_cc_std() -> Result<()> {
+        let header = r#"
+            #pragma clang lifetime_elision
+            #define _LIBCPP_VERSION 170000
+            namespace std {
+            inline namespace __1 {
+            template <typename T>
+            class allocator {};
+            template <typename T>
+            struct char_traits {};
+            template <typename T, typename Traits = char_traits<T>,
+                      typename Alloc = allocator<T>>
+            class basic_string {
+              void* words_[3];
+            };
+            using string = basic_string<char>;
+            int stoi(const string& str);
+            }  // namespace __1
+            }  // namespace std
+        "#;
+        let expected_stoi = quote! {
+            pub fn stoi<'a>(str: &'a ::cc_std::StdString) -> ::core::ffi::c_int { ... }
+        };
+
+        // `::cc_std` names the `cc_std` crate in its own bindings, ...
+        let ir = ir_from_cc_in_target(header, "//support/cc_std:cc_std")?;
+        let BindingsTokens { rs_api, .. } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(rs_api, quote! { extern crate self as cc_std; });
+        assert_rs_matches!(rs_api, expected_stoi);
+
+        // ... and is a dependency of other crates.
+        let BindingsTokens { rs_api, .. } = generate_bindings_tokens(ir_from_cc(header)?)?;
+        assert_rs_not_matches!(rs_api, quote! { extern crate self });
+        assert_rs_matches!(rs_api, expected_stoi);
+        Ok(())
+    }
+
     #[test]
     fn test_simple_function_with_types_from_other_target() -> Result<()> {
         let ir = ir_from_cc_dependency(
@@ -4956,6 +6774,52 @@ mod tests {
         Ok(())
     }
 
+    #[test]
+    fn test_struct_bitfield_accessors() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+            struct SomeStruct final {
+                int signed_field : 3;
+                unsigned unsigned_field : 5;
+                bool bool_field : 1;
+            }; "#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                #[cfg(target_endian = "little")]
+                impl SomeStruct {
+                    #[inline(always)]
+                    pub fn signed_field(&self) -> ::core::ffi::c_int { ... }
+                    #[inline(always)]
+                    pub fn set_signed_field(&mut self, value: ::core::ffi::c_int) { ... }
+                    ...
+                    pub fn unsigned_field(&self) -> ::core::ffi::c_uint { ... }
+                    ...
+                    pub fn set_bool_field(&mut self, value: bool) { ... }
+                }
+            }
+        );
+        // The bytes of the bit-field are never read as initialized `u8`s directly.
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub fn signed_field(&self) -> ::core::ffi::c_int {
+                    let bytes = unsafe {
+                        let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+                        ...
+                        bytes.assume_init()
+                    };
+                    ...
+                }
+            }
+        );
+        assert_rs_not_matches!(rs_api, quote! { [0u8; 8] });
+        assert_cc_not_matches!(rs_api_impl, quote! { signed_field });
+        Ok(())
+    }
+
     #[test]
     fn test_struct_with_inheritable_field() -> Result<()> {
         let ir = ir_from_cc(
@@ -6625,7 +8489,9 @@ mod tests {
             quote! {
                 unsafe impl oops::Inherits<crate::VirtualBase> for crate::Derived {
                     unsafe fn upcast_ptr(derived: *const Self) -> *const crate::VirtualBase {
-                        crate::detail::__crubit_dynamic_upcast__7Derived__to__11VirtualBase(derived)
+                        let vptr = *(derived as *const *const u8);
+                        let vbase_offset = *(vptr.offset(-24) as *const isize);
+                        (derived as *const u8).offset(vbase_offset) as *const crate::VirtualBase
                     }
                 }
             }
@@ -6653,6 +8519,33 @@ mod tests {
         Ok(())
     }
 
+    #[test]
+    fn test_upcast_through_virtual_base() -> Result<()> {
+        let ir = ir_from_cc(
+            "
+            struct A { int a; };
+            struct B { int b; };
+            struct V : A, B {};
+            struct Derived : virtual V {};
+        ",
+        )?;
+        let rs_api = generate_bindings_tokens(ir)?.rs_api;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                unsafe impl oops::Inherits<crate::B> for crate::Derived {
+                    unsafe fn upcast_ptr(derived: *const Self) -> *const crate::B {
+                        let vptr = *(derived as *const *const u8);
+                        let vbase_offset = *(vptr.offset(-24) as *const isize);
+                        (derived as *const u8).offset(vbase_offset + 4) as *const crate::B
+                    }
+                }
+            }
+        );
+        assert_rs_not_matches!(rs_api, quote! { __crubit_dynamic_upcast__7Derived__to__1B });
+        Ok(())
+    }
+
     /// Contrary to intuitions: a base class conversion is ambiguous even if the
     /// ambiguity is from a private base class cast that you can't even
     /// perform.
@@ -6696,6 +8589,24 @@ mod tests {
         Ok(())
     }
 
+    #[test]
+    fn test_final_virtual_method_has_no_thunk() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"
+            struct Base { virtual void Foo(); virtual void Bar(); };
+            struct FinalMethod : Base { void Foo() final; };
+            struct FinalClass final : Base { void Foo() override; void Bar() override; };
+            "#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_cc_matches!(rs_api_impl, quote! { __rust_thunk___ZN4Base3FooEv });
+        assert_cc_not_matches!(rs_api_impl, quote! { __rust_thunk___ZN11FinalMethod3FooEv });
+        assert_cc_not_matches!(rs_api_impl, quote! { __rust_thunk___ZN10FinalClass3FooEv });
+        assert_cc_not_matches!(rs_api_impl, quote! { __rust_thunk___ZN10FinalClass3BarEv });
+        assert_rs_matches!(rs_api, quote! { #[link_name = "_ZN10FinalClass3FooEv"] });
+        Ok(())
+    }
+
     /// A trivially relocatable final struct is safe to use in Rust as normal,
     /// and is Unpin.
     #[test]
@@ -6816,6 +8727,86 @@ mod tests {
         Ok(())
     }
 
+    #[test]
+    fn test_slice_helpers() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"#pragma clang lifetime_elision
+            struct [[clang::trivial_abi]] Relocatable final {
+                Relocatable(const Relocatable&);
+                ~Relocatable();
+            };"#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                impl Relocatable {
+                    ...
+                    pub unsafe fn drop_slice_in_place(slice: *mut [Self]) {
+                        crate::detail::__rust_destroy_n_thunk___ZN11RelocatableD1Ev(
+                            slice as *mut Self, slice.len())
+                    }
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                impl Relocatable {
+                    ...
+                    pub fn clone_slice_into_uninit<'a>(
+                        src: &[Self],
+                        dest: &'a mut [::core::mem::MaybeUninit<Self>],
+                    ) -> &'a mut [Self] {
+                        assert_eq!(src.len(), dest.len());
+                        unsafe {
+                            crate::detail::__rust_copy_construct_n_thunk___ZN11RelocatableC1ERKS_(
+                                dest.as_mut_ptr() as *mut Self, src.as_ptr(), src.len());
+                            ...
+                        }
+                    }
+                }
+            }
+        );
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" void __rust_destroy_n_thunk___ZN11RelocatableD1Ev(
+                        struct Relocatable* __this, std::size_t __n) {
+                    std::destroy_n(__this, __n);
+                }
+            }
+        );
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" void __rust_copy_construct_n_thunk___ZN11RelocatableC1ERKS_(
+                        struct Relocatable* __this, const struct Relocatable* __other, std::size_t __n) {
+                    std::uninitialized_copy_n(__other, __n, __this);
+                }
+            }
+        );
+        Ok(())
+    }
+
+    /// `!Unpin` records can't be in Rust slices, so they don't get slice
+    /// helpers.
+    #[test]
+    fn test_slice_helpers_not_unpin() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"#pragma clang lifetime_elision
+            struct NotUnpin final {
+                NotUnpin(const NotUnpin&);
+                ~NotUnpin();
+            };"#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_not_matches!(rs_api, quote! { drop_slice_in_place });
+        assert_rs_not_matches!(rs_api, quote! { clone_slice_into_uninit });
+        assert_cc_not_matches!(rs_api_impl, quote! { std::destroy_n });
+        Ok(())
+    }
+
     #[test]
     fn test_impl_default_explicitly_defaulted_constructor() -> Result<()> {
         let ir = ir_from_cc(
@@ -7100,7 +9091,7 @@ mod tests {
                     #[inline(always)]
                     fn eq(& self, rhs: & Self) -> bool {
                         unsafe { crate::detail::__rust_thunk___Zeq10SomeStructS_(
-                                &mut self.clone(), &mut rhs.clone()) }
+                                self.clone(), rhs.clone()) }
                     }
                 }
             }
@@ -7234,7 +9225,7 @@ mod tests {
                     #[inline(always)]
                     fn lt(& self, rhs: &Self) -> bool {
                         unsafe { crate::detail::__rust_thunk___Zlt10SomeStructS_(
-                                &mut self.clone(), &mut rhs.clone()) }
+                                self.clone(), rhs.clone()) }
                     }
                 }
             }
@@ -8326,11 +10317,93 @@ mod tests {
     }
 
     #[test]
-    fn test_unpin_by_value_param() -> Result<()> {
+    fn test_unpin_c_abi_compatible_by_value_param() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"#pragma clang lifetime_elision
+            struct Trivial final {
+              int trivial_field;
+            };
+
+            void foo(Trivial param);
+            inline void bar(Trivial param) {}
+            "#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                #[inline(always)]
+                pub fn foo(param: crate::Trivial) {
+                    unsafe { crate::detail::__rust_thunk___Z3foo7Trivial(param) }
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                #[link_name = "_Z3foo7Trivial"]
+                pub(crate) fn __rust_thunk___Z3foo7Trivial(param: crate::Trivial);
+            }
+        );
+        assert_cc_not_matches!(rs_api_impl, quote! { __rust_thunk___Z3foo7Trivial });
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                pub(crate) fn __rust_thunk___Z3bar7Trivial(param: crate::Trivial);
+            }
+        );
+        assert_cc_matches!(
+            rs_api_impl,
+            quote! {
+                extern "C" void __rust_thunk___Z3bar7Trivial(struct Trivial param) {
+                    bar(std::move(param));
+                }
+            }
+        );
+        Ok(())
+    }
+
+    #[test]
+    fn test_unpin_c_abi_compatible_by_value_return() -> Result<()> {
         let ir = ir_from_cc(
             r#"#pragma clang lifetime_elision
             struct Trivial final {
               int trivial_field;
+              const char* ptr;
+            };
+
+            Trivial foo();
+            "#,
+        )?;
+        let BindingsTokens { rs_api, rs_api_impl } = generate_bindings_tokens(ir)?;
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                #[inline(always)]
+                pub fn foo() -> crate::Trivial {
+                    unsafe { crate::detail::__rust_thunk___Z3foov() }
+                }
+            }
+        );
+        assert_rs_matches!(
+            rs_api,
+            quote! {
+                #[link_name = "_Z3foov"]
+                pub(crate) fn __rust_thunk___Z3foov() -> crate::Trivial;
+            }
+        );
+        assert_cc_not_matches!(rs_api_impl, quote! { __rust_thunk___Z3foov });
+        Ok(())
+    }
+
+    #[test]
+    fn test_unpin_by_value_param() -> Result<()> {
+        let ir = ir_from_cc(
+            r#"#pragma clang lifetime_elision
+            struct Inner final { int trivial_field; };
+            // Fields of record types are not (yet) known to keep the C ABI.
+            struct Trivial final {
+              Inner inner;
             };
 
             void foo(Trivial param);
@@ -8367,8 +10440,10 @@ mod tests {
     fn test_unpin_by_value_return() -> Result<()> {
         let ir = ir_from_cc(
             r#"#pragma clang lifetime_elision
+            struct Inner final { int trivial_field; };
+            // Fields of record types are not (yet) known to keep the C ABI.
             struct Trivial final {
-              int trivial_field;
+              Inner inner;
             };
 
             Trivial foo();
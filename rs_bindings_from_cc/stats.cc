@@ -0,0 +1,138 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/stats.h"
+
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace crubit {
+
+Stats::Stats() : start_(absl::Now()), start_cpu_time_(ProcessCpuTime()) {
+  ResetPeakRss();
+}
+
+Stats::Phase::Phase(Stats* stats, absl::string_view name) : stats_(stats) {
+  if (stats_ == nullptr) return;
+  name_ = std::string(name);
+  start_ = absl::Now();
+  start_cpu_time_ = ProcessCpuTime();
+}
+
+Stats::Phase::~Phase() {
+  if (stats_ == nullptr) return;
+  stats_->RecordPhase(name_, start_, absl::Now() - start_,
+                      ProcessCpuTime() - start_cpu_time_);
+}
+
+void Stats::RecordPhase(absl::string_view name, absl::Time start,
+                        absl::Duration wall_time,
+                        std::optional<absl::Duration> cpu_time) {
+  phases_.push_back({.name = std::string(name),
+                     .start = start,
+                     .wall_time = wall_time,
+                     .cpu_time = cpu_time});
+}
+
+void Stats::SetCounter(absl::string_view name, int64_t value) {
+  counters_[std::string(name)] = value;
+}
+
+std::string Stats::ToChromeTraceJson() const {
+  llvm::json::Array events;
+  for (const PhaseRecord& phase : phases_) {
+    llvm::json::Object args;
+    if (phase.cpu_time.has_value()) {
+      args["cpu_us"] = absl::ToInt64Microseconds(*phase.cpu_time);
+    }
+    events.push_back(llvm::json::Object{
+        {"name", phase.name},
+        {"cat", "rs_bindings_from_cc"},
+        {"ph", "X"},
+        {"pid", 1},
+        {"tid", 0},
+        {"ts", absl::ToInt64Microseconds(phase.start - start_)},
+        {"dur", absl::ToInt64Microseconds(phase.wall_time)},
+        {"args", std::move(args)},
+    });
+  }
+
+  llvm::json::Object other_data;
+  for (const auto& [name, value] : counters_) {
+    other_data[name] = value;
+  }
+  other_data["peak_rss_bytes"] = PeakRssBytes();
+  other_data["total_cpu_us"] =
+      absl::ToInt64Microseconds(ProcessCpuTime() - start_cpu_time_);
+
+  std::string result;
+  llvm::raw_string_ostream os(result);
+  os << llvm::json::Value(llvm::json::Object{
+      {"traceEvents", std::move(events)},
+      {"beginningOfTime", absl::ToUnixMicros(start_)},
+      {"otherData", std::move(other_data)},
+  });
+  os.flush();
+  return result;
+}
+
+absl::Duration Stats::ProcessCpuTime() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return absl::ZeroDuration();
+  return absl::DurationFromTimeval(usage.ru_utime) +
+         absl::DurationFromTimeval(usage.ru_stime);
+}
+
+int64_t Stats::PeakRssBytes() {
+#ifdef __linux__
+  // Unlike `ru_maxrss`, `VmHWM` is reset by `ResetPeakRss`.
+  std::ifstream status("/proc/self/status");
+  for (std::string line; std::getline(status, line);) {
+    absl::string_view value = line;
+    int64_t kilobytes;
+    if (absl::ConsumePrefix(&value, "VmHWM:") &&
+        absl::ConsumeSuffix(&value, "kB") &&
+        absl::SimpleAtoi(value, &kilobytes)) {
+      return kilobytes * 1024;
+    }
+  }
+#endif
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  // Linux reports `ru_maxrss` in kilobytes.
+  return int64_t{usage.ru_maxrss} * 1024;
+#endif
+}
+
+bool Stats::ResetPeakRss() {
+#ifdef __linux__
+  // See "/proc/[pid]/clear_refs" in proc(5).
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+  clear_refs.close();
+  return !clear_refs.fail();
+#else
+  return false;
+#endif
+}
+
+}  // namespace crubit
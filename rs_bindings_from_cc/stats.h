@@ -0,0 +1,101 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CRUBIT_RS_BINDINGS_FROM_CC_STATS_H_
+#define CRUBIT_RS_BINDINGS_FROM_CC_STATS_H_
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace crubit {
+
+// Statistics about a run of the bindings generator, for `--stats_out`: the
+// wall and CPU time spent in each phase, counters such as the number of
+// generated items, and the CPU time and peak resident set size of the run.
+//
+// A persistent worker serves many runs in the same process, so the totals only
+// cover the lifetime of the `Stats` object rather than that of the process.
+class Stats {
+ public:
+  // Records the time between its construction and its destruction as the
+  // phase `name` of `stats`. Does nothing if `stats` is null, so that callers
+  // don't have to check whether statistics were requested.
+  class Phase {
+   public:
+    Phase(Stats* stats, absl::string_view name);
+    ~Phase();
+
+    Phase(const Phase&) = delete;
+    Phase& operator=(const Phase&) = delete;
+
+   private:
+    Stats* stats_;
+    std::string name_;
+    absl::Time start_;
+    absl::Duration start_cpu_time_;
+  };
+
+  Stats();
+
+  Stats(const Stats&) = delete;
+  Stats& operator=(const Stats&) = delete;
+
+  // Records a phase that started at `start` and took `wall_time`. `cpu_time`
+  // is empty if it wasn't measured.
+  void RecordPhase(absl::string_view name, absl::Time start,
+                   absl::Duration wall_time,
+                   std::optional<absl::Duration> cpu_time = std::nullopt);
+
+  // Sets the counter `name` to `value`.
+  void SetCounter(absl::string_view name, int64_t value);
+
+  // Returns the statistics in the JSON trace event format of Chrome's
+  // about:tracing, which Clang's `-ftime-trace` also uses. Phases are complete
+  // ("X") events, with their CPU time in `args`; the counters and the peak
+  // resident set size are in `otherData`.
+  std::string ToChromeTraceJson() const;
+
+  // A phase recorded by `RecordPhase`.
+  struct PhaseRecord {
+    std::string name;
+    absl::Time start;
+    absl::Duration wall_time;
+    std::optional<absl::Duration> cpu_time;
+  };
+
+  // Returns the recorded phases, in the order in which they finished.
+  const std::vector<PhaseRecord>& phases() const { return phases_; }
+
+  // Returns the counters set by `SetCounter`.
+  const std::map<std::string, int64_t>& counters() const { return counters_; }
+
+  // Returns the CPU time used by the process so far, in all threads.
+  static absl::Duration ProcessCpuTime();
+
+  // Returns the peak resident set size of the process since the last call to
+  // `ResetPeakRss` (or since it started), in bytes.
+  static int64_t PeakRssBytes();
+
+  // Starts measuring the peak resident set size anew, if the platform allows
+  // it (Linux does). Returns false if it doesn't, in which case
+  // `PeakRssBytes` keeps covering the whole lifetime of the process.
+  static bool ResetPeakRss();
+
+ private:
+  absl::Time start_;
+  absl::Duration start_cpu_time_;
+  std::vector<PhaseRecord> phases_;
+  std::map<std::string, int64_t> counters_;
+};
+
+}  // namespace crubit
+
+#endif  // CRUBIT_RS_BINDINGS_FROM_CC_STATS_H_
@@ -0,0 +1,89 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/stats.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/JSON.h"
+
+namespace crubit {
+namespace {
+
+using ::testing::Optional;
+
+TEST(StatsTest, ChromeTraceJson) {
+  Stats stats;
+  { Stats::Phase phase(&stats, "Frontend"); }
+  stats.RecordPhase("generate_bindings_tokens", absl::Now(),
+                    absl::Milliseconds(3));
+  stats.SetCounter("items", 42);
+
+  llvm::Expected<llvm::json::Value> trace =
+      llvm::json::parse(stats.ToChromeTraceJson());
+  ASSERT_TRUE(static_cast<bool>(trace)) << llvm::toString(trace.takeError());
+  const llvm::json::Object* object = trace->getAsObject();
+  ASSERT_NE(object, nullptr);
+
+  const llvm::json::Array* events = object->getArray("traceEvents");
+  ASSERT_NE(events, nullptr);
+  ASSERT_EQ(events->size(), 2);
+  const llvm::json::Object* frontend = (*events)[0].getAsObject();
+  EXPECT_EQ(frontend->getString("name"), "Frontend");
+  EXPECT_EQ(frontend->getString("ph"), "X");
+  EXPECT_TRUE(frontend->getObject("args")->getInteger("cpu_us").has_value());
+  const llvm::json::Object* tokens = (*events)[1].getAsObject();
+  EXPECT_EQ(tokens->getString("name"), "generate_bindings_tokens");
+  EXPECT_THAT(tokens->getInteger("dur"), Optional(3000));
+  EXPECT_FALSE(tokens->getObject("args")->getInteger("cpu_us").has_value());
+
+  const llvm::json::Object* other_data = object->getObject("otherData");
+  ASSERT_NE(other_data, nullptr);
+  EXPECT_THAT(other_data->getInteger("items"), Optional(42));
+  EXPECT_GT(other_data->getInteger("peak_rss_bytes").value_or(0), 0);
+}
+
+TEST(StatsTest, TotalsOnlyCoverTheLifetimeOfStats) {
+  // Use some CPU time and memory before `stats` exists, as earlier requests of
+  // a persistent worker do.
+  constexpr int64_t kAllocationSize = int64_t{256} << 20;
+  {
+    auto allocation = std::make_unique<char[]>(kAllocationSize);
+    std::memset(allocation.get(), 1, kAllocationSize);
+  }
+  absl::Duration cpu_time_before = Stats::ProcessCpuTime();
+  while (Stats::ProcessCpuTime() - cpu_time_before < absl::Milliseconds(300)) {
+  }
+  int64_t peak_rss_before = Stats::PeakRssBytes();
+  ASSERT_GE(peak_rss_before, kAllocationSize);
+
+  Stats stats;
+  llvm::Expected<llvm::json::Value> trace =
+      llvm::json::parse(stats.ToChromeTraceJson());
+  ASSERT_TRUE(static_cast<bool>(trace)) << llvm::toString(trace.takeError());
+  const llvm::json::Object* other_data =
+      trace->getAsObject()->getObject("otherData");
+  ASSERT_NE(other_data, nullptr);
+  EXPECT_LT(other_data->getInteger("total_cpu_us").value_or(-1),
+            absl::ToInt64Microseconds(absl::Milliseconds(300)));
+  if (Stats::ResetPeakRss()) {
+    EXPECT_LT(other_data->getInteger("peak_rss_bytes").value_or(-1),
+              peak_rss_before);
+  }
+}
+
+TEST(StatsTest, PhaseWithoutStats) {
+  // Must not crash.
+  Stats::Phase phase(/*stats=*/nullptr, "Frontend");
+}
+
+}  // namespace
+}  // namespace crubit
@@ -0,0 +1,139 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/synthetic_header.h"
+
+#include <optional>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/substitute.h"
+
+namespace crubit {
+
+namespace {
+
+enum class DeclKind { kRecord, kTemplate, kFunction };
+
+DeclKind KindOfDecl(const SyntheticHeaderOptions& options, int index) {
+  // Repeats the mix in every block of 100 declarations, instead of declaring
+  // all records first, so that the namespaces have similar contents.
+  int bucket = index % 100;
+  if (bucket < options.record_percent) return DeclKind::kRecord;
+  if (bucket < options.record_percent + options.template_percent) {
+    return DeclKind::kTemplate;
+  }
+  return DeclKind::kFunction;
+}
+
+// Returns a parameter pointing to a `record`, or of type `int` if there is no
+// record yet.
+std::string RecordParam(const std::optional<std::string>& record) {
+  if (!record.has_value()) return "int other";
+  return absl::StrCat("const ", *record, "* other");
+}
+
+void AppendRecord(const SyntheticHeaderOptions& options, int index,
+                  const std::optional<std::string>& previous_record,
+                  std::string& header) {
+  if (options.comments) {
+    absl::StrAppend(&header, "/// Record number ", index, ".\n");
+  }
+  absl::StrAppend(&header, "struct Record", index, " {\n");
+  for (int i = 0; i < options.methods_per_record; ++i) {
+    if (options.comments) {
+      absl::StrAppend(&header, "  /// Method number ", i, ".\n");
+    }
+    // Inline methods need thunks, the others are called directly.
+    if (i % 2 == 0) {
+      absl::StrAppend(&header, "  int Method", i, "(int x) const { return x + ",
+                      i, "; }\n");
+    } else {
+      absl::StrAppend(&header, "  void Method", i, "(",
+                      RecordParam(previous_record), ");\n");
+    }
+  }
+  for (int i = 0; i < options.fields_per_record; ++i) {
+    absl::StrAppend(&header, "  int field", i, ";\n");
+  }
+  absl::StrAppend(&header, "};\n");
+}
+
+void AppendTemplate(const SyntheticHeaderOptions& options, int index,
+                    std::string& header) {
+  if (options.comments) {
+    absl::StrAppend(&header, "/// Class template number ", index, ".\n");
+  }
+  absl::SubstituteAndAppend(&header,
+                            "template <typename T>\n"
+                            "struct Template$0 {\n"
+                            "  T Get() const { return value; }\n"
+                            "  T value;\n"
+                            "};\n"
+                            "using Template$0Int = Template$0<int>;\n",
+                            index);
+}
+
+void AppendFunction(const SyntheticHeaderOptions& options, int index,
+                    const std::optional<std::string>& previous_record,
+                    std::string& header) {
+  if (options.comments) {
+    absl::StrAppend(&header, "/// Function number ", index, ".\n");
+  }
+  if (index % 2 == 0) {
+    absl::StrAppend(&header, "inline int Function", index,
+                    "(int x) { return x * ", index, "; }\n");
+  } else {
+    absl::StrAppend(&header, "void Function", index, "(",
+                    RecordParam(previous_record), ");\n");
+  }
+}
+
+}  // namespace
+
+std::string SyntheticHeader(const SyntheticHeaderOptions& options) {
+  std::string header =
+      "// Synthetic header generated for benchmarking the bindings "
+      "generator.\n\n"
+      "#pragma once\n\n";
+  // The fully qualified name of the last declared record.
+  std::optional<std::string> previous_record;
+  std::string current_namespace;
+  for (int i = 0; i < options.num_decls; ++i) {
+    if (options.decls_per_namespace > 0 &&
+        i % options.decls_per_namespace == 0) {
+      if (i > 0) {
+        absl::StrAppend(&header, "}  // namespace ", current_namespace,
+                        "\n\n");
+      }
+      current_namespace = absl::StrCat("ns", i / options.decls_per_namespace);
+      absl::StrAppend(&header, "namespace ", current_namespace, " {\n\n");
+    }
+    if (options.comments) {
+      absl::StrAppend(&header, "// Declaration number ", i, ".\n\n");
+    }
+    switch (KindOfDecl(options, i)) {
+      case DeclKind::kRecord:
+        AppendRecord(options, i, previous_record, header);
+        previous_record = current_namespace.empty()
+                              ? absl::StrCat("::Record", i)
+                              : absl::StrCat("::", current_namespace,
+                                             "::Record", i);
+        break;
+      case DeclKind::kTemplate:
+        AppendTemplate(options, i, header);
+        break;
+      case DeclKind::kFunction:
+        AppendFunction(options, i, previous_record, header);
+        break;
+    }
+    absl::StrAppend(&header, "\n");
+  }
+  if (!current_namespace.empty()) {
+    absl::StrAppend(&header, "}  // namespace ", current_namespace, "\n");
+  }
+  return header;
+}
+
+}  // namespace crubit
@@ -0,0 +1,43 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CRUBIT_RS_BINDINGS_FROM_CC_SYNTHETIC_HEADER_H_
+#define CRUBIT_RS_BINDINGS_FROM_CC_SYNTHETIC_HEADER_H_
+
+#include <string>
+
+namespace crubit {
+
+// The mix of declarations in a header generated by `SyntheticHeader`.
+struct SyntheticHeaderOptions {
+  // The number of top-level declarations: records, class template
+  // instantiations and functions.
+  int num_decls = 1000;
+  // The percentage of the declarations that are records.
+  int record_percent = 50;
+  // The percentage of the declarations that are class templates, each of them
+  // instantiated by a type alias. The remaining declarations are functions.
+  int template_percent = 10;
+  // The number of methods and fields of each record.
+  int methods_per_record = 4;
+  int fields_per_record = 2;
+  // The number of declarations in each namespace, or 0 to declare everything
+  // in the global namespace.
+  int decls_per_namespace = 100;
+  // Whether declarations have doc comments, and are separated by free-standing
+  // comments.
+  bool comments = true;
+};
+
+// Returns the contents of a header with the declarations described by
+// `options`, for benchmarking the bindings generator.
+//
+// Functions and methods take the previously declared record as a parameter,
+// so that the generated bindings refer to other items, like those of a real
+// library do. The header doesn't include any other header.
+std::string SyntheticHeader(const SyntheticHeaderOptions& options);
+
+}  // namespace crubit
+
+#endif  // CRUBIT_RS_BINDINGS_FROM_CC_SYNTHETIC_HEADER_H_
@@ -0,0 +1,64 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "rs_bindings_from_cc/synthetic_header.h"
+
+#include <string>
+#include <variant>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/match.h"
+#include "common/status_test_matchers.h"
+#include "rs_bindings_from_cc/ir.h"
+#include "rs_bindings_from_cc/ir_from_cc.h"
+
+namespace crubit {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+using ::testing::SizeIs;
+
+TEST(SyntheticHeaderTest, ImportsAllDeclarations) {
+  std::string header = SyntheticHeader({.num_decls = 20,
+                                        .record_percent = 50,
+                                        .template_percent = 10,
+                                        .methods_per_record = 2,
+                                        .decls_per_namespace = 5});
+  ASSERT_OK_AND_ASSIGN(IR ir, IrFromCc({header}));
+
+  EXPECT_THAT(ir.get_items_if<Namespace>(), SizeIs(4));
+  int records = 0;
+  int template_instantiations = 0;
+  for (const Record* record : ir.get_items_if<Record>()) {
+    if (absl::StartsWith(record->rs_name, "Record")) ++records;
+    if (absl::StartsWith(record->cc_name, "Template")) {
+      ++template_instantiations;
+    }
+  }
+  EXPECT_EQ(records, 10);
+  EXPECT_EQ(template_instantiations, 2);
+  int functions = 0;
+  for (const Func* func : ir.get_items_if<Func>()) {
+    const auto* name = std::get_if<Identifier>(&func->name);
+    if (name != nullptr && absl::StartsWith(name->Ident(), "Function")) {
+      ++functions;
+    }
+  }
+  EXPECT_EQ(functions, 8);
+}
+
+TEST(SyntheticHeaderTest, WithoutNamespacesOrComments) {
+  std::string header = SyntheticHeader(
+      {.num_decls = 10, .decls_per_namespace = 0, .comments = false});
+  EXPECT_THAT(header, Not(HasSubstr("namespace")));
+  EXPECT_THAT(header, Not(HasSubstr("number")));
+  ASSERT_OK_AND_ASSIGN(IR ir, IrFromCc({header}));
+  EXPECT_THAT(ir.get_items_if<Namespace>(), SizeIs(0));
+  EXPECT_THAT(ir.get_items_if<Comment>(), SizeIs(0));
+}
+
+}  // namespace
+}  // namespace crubit
@@ -0,0 +1,29 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef THIRD_PARTY_CRUBIT_RS_BINDINGS_FROM_CC_TEST_CC_STD_STRING_STRING_APIS_H_
+#define THIRD_PARTY_CRUBIT_RS_BINDINGS_FROM_CC_TEST_CC_STD_STRING_STRING_APIS_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+namespace crubit_string {
+
+inline std::string* NewString() { return new std::string(); }
+
+inline void DeleteString(std::string* s) { delete s; }
+
+inline std::size_t Size(const std::string* s) { return s->size(); }
+
+inline void Reserve(std::string* s, std::size_t capacity) {
+  s->reserve(capacity);
+}
+
+inline void Append(std::string* s, std::string_view suffix) {
+  s->append(suffix);
+}
+
+}  // namespace crubit_string
+
+#endif  // THIRD_PARTY_CRUBIT_RS_BINDINGS_FROM_CC_TEST_CC_STD_STRING_STRING_APIS_H_
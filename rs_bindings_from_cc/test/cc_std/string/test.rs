@@ -0,0 +1,63 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+use cc_std::*;
+use string_apis::crubit_string::{Append, DeleteString, NewString, Reserve, Size};
+
+/// Calls `f` with a new, empty C++ `std::string`.
+fn with_new_string(f: impl FnOnce(*mut StdString)) {
+    let s = NewString();
+    f(s);
+    // SAFETY: `s` was created by `NewString`.
+    unsafe { DeleteString(s) };
+}
+
+#[test]
+fn test_append_short_string() {
+    with_new_string(|s| {
+        // SAFETY: `s` is a valid string, which is only used through `string`.
+        let string = unsafe { &mut *s };
+        assert!(string.is_empty());
+        string.try_push_str("Hello").unwrap();
+        assert_eq!(string.to_str().unwrap(), "Hello");
+        assert_eq!(unsafe { Size(s) }, 5);
+    });
+}
+
+#[test]
+fn test_append_beyond_capacity() {
+    with_new_string(|s| {
+        // SAFETY: `s` is a valid string, which is only used through `string`.
+        let string = unsafe { &mut *s };
+        let too_long = vec![b'x'; string.capacity() + 1];
+        assert_eq!(string.try_extend_from_slice(&too_long), Err(CapacityError));
+        assert!(string.is_empty());
+    });
+}
+
+#[test]
+fn test_append_long_string() {
+    with_new_string(|s| {
+        unsafe { Reserve(s, 100) };
+        // SAFETY: `s` is a valid string, which is only used through `string`.
+        let string = unsafe { &mut *s };
+        assert!(string.capacity() >= 100);
+        let bytes = vec![b'x'; 100];
+        string.try_extend_from_slice(&bytes).unwrap();
+        assert_eq!(string.as_bytes(), &bytes[..]);
+        assert_eq!(unsafe { Size(s) }, 100);
+    });
+}
+
+#[test]
+fn test_read_string_appended_in_cc() {
+    with_new_string(|s| {
+        unsafe { Append(s, StringView::from("Hello, world!").into_raw()) };
+        // SAFETY: `s` is a valid string, which is only used through `string`.
+        let string = unsafe { &mut *s };
+        assert_eq!(string.as_bytes(), b"Hello, world!");
+        string.as_mut_bytes()[0] = b'J';
+        assert_eq!(StringView::from(&*string).to_str().unwrap(), "Jello, world!");
+    });
+}
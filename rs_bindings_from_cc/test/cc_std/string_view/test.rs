@@ -24,3 +24,34 @@ fn test_round_trip_empty_str() {
     let round_tripped: &[u8] = sv.into();
     assert_eq!(original, round_tripped);
 }
+
+#[test]
+fn test_string_view_borrows_bytes() {
+    let owned = String::from("Hello, world!");
+    let sv = StringView::from(owned.as_str());
+    assert_eq!(sv.to_str().unwrap(), "Hello, world!");
+    assert_eq!(sv.as_bytes().as_ptr(), owned.as_ptr());
+}
+
+#[test]
+fn test_string_view_from_raw() {
+    // SAFETY: the characters are a string literal.
+    let sv = unsafe { StringView::from_raw(GetHelloWorld()) };
+    let bytes: &[u8] = sv.into();
+    assert_eq!(bytes, b"Hello, world!");
+}
+
+#[test]
+fn test_string_view_invalid_utf8() {
+    // SAFETY: the characters are a string literal.
+    let sv = unsafe { StringView::from_raw(GetInvalidUtf8()) };
+    let _ = sv.to_str().unwrap_err();
+}
+
+#[test]
+fn test_string_view_round_trip_empty() {
+    let sv = StringView::from(&b""[..]);
+    // SAFETY: `sv` borrows an empty slice.
+    let round_tripped = unsafe { StringView::from_raw(sv.into_raw()) };
+    assert!(round_tripped.as_bytes().is_empty());
+}
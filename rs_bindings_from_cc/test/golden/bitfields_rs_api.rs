@@ -50,6 +50,137 @@ impl WithBitfields {
         unsafe { &*(&self.f7 as *const _ as *const u8) }
     }
 }
+#[cfg(target_endian = "little")]
+impl WithBitfields {
+    #[inline(always)]
+    pub fn f1(&self) -> ::core::ffi::c_int {
+        let bytes = unsafe {
+            let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+            ::core::ptr::copy_nonoverlapping(
+                (self as *const Self as *const u8).add(0),
+                bytes.as_mut_ptr() as *mut u8,
+                1,
+            );
+            bytes.assume_init()
+        };
+        let bits = (u64::from_le_bytes(bytes) >> 0) & 3;
+        ((bits << 62) as i64 >> 62) as ::core::ffi::c_int
+    }
+    #[inline(always)]
+    pub fn set_f1(self: ::core::pin::Pin<&mut Self>, value: ::core::ffi::c_int) {
+        unsafe {
+            let ptr = (::core::pin::Pin::into_inner_unchecked(self) as *mut Self as *mut u8).add(0);
+            let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+            ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr() as *mut u8, 1);
+            let bits =
+                (u64::from_le_bytes(bytes.assume_init()) & !(3 << 0)) | (((value as u64) & 3) << 0);
+            ::core::ptr::copy_nonoverlapping(bits.to_le_bytes().as_ptr(), ptr, 1);
+        }
+    }
+    #[inline(always)]
+    pub fn f3(&self) -> ::core::ffi::c_int {
+        let bytes = unsafe {
+            let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+            ::core::ptr::copy_nonoverlapping(
+                (self as *const Self as *const u8).add(8),
+                bytes.as_mut_ptr() as *mut u8,
+                1,
+            );
+            bytes.assume_init()
+        };
+        let bits = (u64::from_le_bytes(bytes) >> 0) & 15;
+        ((bits << 60) as i64 >> 60) as ::core::ffi::c_int
+    }
+    #[inline(always)]
+    pub fn set_f3(self: ::core::pin::Pin<&mut Self>, value: ::core::ffi::c_int) {
+        unsafe {
+            let ptr = (::core::pin::Pin::into_inner_unchecked(self) as *mut Self as *mut u8).add(8);
+            let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+            ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr() as *mut u8, 1);
+            let bits = (u64::from_le_bytes(bytes.assume_init()) & !(15 << 0))
+                | (((value as u64) & 15) << 0);
+            ::core::ptr::copy_nonoverlapping(bits.to_le_bytes().as_ptr(), ptr, 1);
+        }
+    }
+    #[inline(always)]
+    pub fn f4(&self) -> ::core::ffi::c_int {
+        let bytes = unsafe {
+            let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+            ::core::ptr::copy_nonoverlapping(
+                (self as *const Self as *const u8).add(8),
+                bytes.as_mut_ptr() as *mut u8,
+                2,
+            );
+            bytes.assume_init()
+        };
+        let bits = (u64::from_le_bytes(bytes) >> 4) & 255;
+        ((bits << 56) as i64 >> 56) as ::core::ffi::c_int
+    }
+    #[inline(always)]
+    pub fn set_f4(self: ::core::pin::Pin<&mut Self>, value: ::core::ffi::c_int) {
+        unsafe {
+            let ptr = (::core::pin::Pin::into_inner_unchecked(self) as *mut Self as *mut u8).add(8);
+            let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+            ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr() as *mut u8, 2);
+            let bits = (u64::from_le_bytes(bytes.assume_init()) & !(255 << 4))
+                | (((value as u64) & 255) << 4);
+            ::core::ptr::copy_nonoverlapping(bits.to_le_bytes().as_ptr(), ptr, 2);
+        }
+    }
+    #[inline(always)]
+    pub fn f6(&self) -> ::core::ffi::c_int {
+        let bytes = unsafe {
+            let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+            ::core::ptr::copy_nonoverlapping(
+                (self as *const Self as *const u8).add(24),
+                bytes.as_mut_ptr() as *mut u8,
+                3,
+            );
+            bytes.assume_init()
+        };
+        let bits = (u64::from_le_bytes(bytes) >> 0) & 8388607;
+        ((bits << 41) as i64 >> 41) as ::core::ffi::c_int
+    }
+    #[inline(always)]
+    pub fn set_f6(self: ::core::pin::Pin<&mut Self>, value: ::core::ffi::c_int) {
+        unsafe {
+            let ptr =
+                (::core::pin::Pin::into_inner_unchecked(self) as *mut Self as *mut u8).add(24);
+            let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+            ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr() as *mut u8, 3);
+            let bits =
+            (u64::from_le_bytes(bytes.assume_init()) & !(8388607 << 0))
+                | (((value as u64) & 8388607) << 0);
+            ::core::ptr::copy_nonoverlapping(bits.to_le_bytes().as_ptr(), ptr, 3);
+        }
+    }
+    #[inline(always)]
+    pub fn f8(&self) -> ::core::ffi::c_int {
+        let bytes = unsafe {
+            let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+            ::core::ptr::copy_nonoverlapping(
+                (self as *const Self as *const u8).add(28),
+                bytes.as_mut_ptr() as *mut u8,
+                1,
+            );
+            bytes.assume_init()
+        };
+        let bits = (u64::from_le_bytes(bytes) >> 0) & 3;
+        ((bits << 62) as i64 >> 62) as ::core::ffi::c_int
+    }
+    #[inline(always)]
+    pub fn set_f8(self: ::core::pin::Pin<&mut Self>, value: ::core::ffi::c_int) {
+        unsafe {
+            let ptr =
+                (::core::pin::Pin::into_inner_unchecked(self) as *mut Self as *mut u8).add(28);
+            let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+            ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr() as *mut u8, 1);
+            let bits =
+                (u64::from_le_bytes(bytes.assume_init()) & !(3 << 0)) | (((value as u64) & 3) << 0);
+            ::core::ptr::copy_nonoverlapping(bits.to_le_bytes().as_ptr(), ptr, 1);
+        }
+    }
+}
 
 impl ::ctor::CtorNew<()> for WithBitfields {
     type CtorType = impl ::ctor::Ctor<Output = Self>;
@@ -154,6 +285,34 @@ forward_declare::unsafe_define!(
     forward_declare::symbol!("AlignmentRegressionTest"),
     crate::AlignmentRegressionTest
 );
+#[cfg(target_endian = "little")]
+impl AlignmentRegressionTest {
+    #[inline(always)]
+    pub fn code_point(&self) -> u32 {
+        let bytes = unsafe {
+            let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+            ::core::ptr::copy_nonoverlapping(
+                (self as *const Self as *const u8).add(0),
+                bytes.as_mut_ptr() as *mut u8,
+                4,
+            );
+            bytes.assume_init()
+        };
+        let bits = (u64::from_le_bytes(bytes) >> 0) & 2147483647;
+        bits as u32
+    }
+    #[inline(always)]
+    pub fn set_code_point(self: ::core::pin::Pin<&mut Self>, value: u32) {
+        unsafe {
+            let ptr = (::core::pin::Pin::into_inner_unchecked(self) as *mut Self as *mut u8).add(0);
+            let mut bytes = ::core::mem::MaybeUninit::<[u8; 8]>::zeroed();
+            ::core::ptr::copy_nonoverlapping(ptr, bytes.as_mut_ptr() as *mut u8, 4);
+            let bits = (u64::from_le_bytes(bytes.assume_init()) & !(2147483647 << 0))
+                | (((value as u64) & 2147483647) << 0);
+            ::core::ptr::copy_nonoverlapping(bits.to_le_bytes().as_ptr(), ptr, 4);
+        }
+    }
+}
 
 impl ::ctor::CtorNew<()> for AlignmentRegressionTest {
     type CtorType = impl ::ctor::Ctor<Output = Self>;
@@ -491,7 +491,9 @@ impl<'b> ::ctor::Assign<::ctor::RvalueReference<'b, Self>> for VirtualBase1 {
 
 unsafe impl oops::Inherits<crate::Base1> for crate::VirtualBase1 {
     unsafe fn upcast_ptr(derived: *const Self) -> *const crate::Base1 {
-        crate::detail::__crubit_dynamic_upcast__12VirtualBase1__to__5Base1(derived)
+        let vptr = *(derived as *const *const u8);
+        let vbase_offset = *(vptr.offset(-24) as *const isize);
+        (derived as *const u8).offset(vbase_offset) as *const crate::Base1
     }
 }
 
@@ -594,7 +596,9 @@ impl<'b> ::ctor::Assign<::ctor::RvalueReference<'b, Self>> for VirtualBase2 {
 
 unsafe impl oops::Inherits<crate::Base1> for crate::VirtualBase2 {
     unsafe fn upcast_ptr(derived: *const Self) -> *const crate::Base1 {
-        crate::detail::__crubit_dynamic_upcast__12VirtualBase2__to__5Base1(derived)
+        let vptr = *(derived as *const *const u8);
+        let vbase_offset = *(vptr.offset(-24) as *const isize);
+        (derived as *const u8).offset(vbase_offset) as *const crate::Base1
     }
 }
 
@@ -697,17 +701,23 @@ impl<'b> ::ctor::Assign<::ctor::RvalueReference<'b, Self>> for VirtualDerived {
 
 unsafe impl oops::Inherits<crate::VirtualBase1> for crate::VirtualDerived {
     unsafe fn upcast_ptr(derived: *const Self) -> *const crate::VirtualBase1 {
-        crate::detail::__crubit_dynamic_upcast__14VirtualDerived__to__12VirtualBase1(derived)
+        let vptr = *(derived as *const *const u8);
+        let vbase_offset = *(vptr.offset(-32) as *const isize);
+        (derived as *const u8).offset(vbase_offset) as *const crate::VirtualBase1
     }
 }
 unsafe impl oops::Inherits<crate::Base1> for crate::VirtualDerived {
     unsafe fn upcast_ptr(derived: *const Self) -> *const crate::Base1 {
-        crate::detail::__crubit_dynamic_upcast__14VirtualDerived__to__5Base1(derived)
+        let vptr = *(derived as *const *const u8);
+        let vbase_offset = *(vptr.offset(-24) as *const isize);
+        (derived as *const u8).offset(vbase_offset) as *const crate::Base1
     }
 }
 unsafe impl oops::Inherits<crate::VirtualBase2> for crate::VirtualDerived {
     unsafe fn upcast_ptr(derived: *const Self) -> *const crate::VirtualBase2 {
-        crate::detail::__crubit_dynamic_upcast__14VirtualDerived__to__12VirtualBase2(derived)
+        let vptr = *(derived as *const *const u8);
+        let vbase_offset = *(vptr.offset(-40) as *const isize);
+        (derived as *const u8).offset(vbase_offset) as *const crate::VirtualBase2
     }
 }
 
@@ -1121,9 +1131,6 @@ mod detail {
             __this: ::core::pin::Pin<&'a mut crate::VirtualBase1>,
             __param_0: ::ctor::RvalueReference<'b, crate::VirtualBase1>,
         ) -> ::core::pin::Pin<&'a mut crate::VirtualBase1>;
-        pub fn __crubit_dynamic_upcast__12VirtualBase1__to__5Base1(
-            from: *const crate::VirtualBase1,
-        ) -> *const crate::Base1;
         pub(crate) fn __rust_thunk___ZN12VirtualBase2C1Ev<'a>(
             __this: &'a mut ::core::mem::MaybeUninit<crate::VirtualBase2>,
         );
@@ -1143,9 +1150,6 @@ mod detail {
             __this: ::core::pin::Pin<&'a mut crate::VirtualBase2>,
             __param_0: ::ctor::RvalueReference<'b, crate::VirtualBase2>,
         ) -> ::core::pin::Pin<&'a mut crate::VirtualBase2>;
-        pub fn __crubit_dynamic_upcast__12VirtualBase2__to__5Base1(
-            from: *const crate::VirtualBase2,
-        ) -> *const crate::Base1;
         pub(crate) fn __rust_thunk___ZN14VirtualDerivedC1Ev<'a>(
             __this: &'a mut ::core::mem::MaybeUninit<crate::VirtualDerived>,
         );
@@ -1165,15 +1169,6 @@ mod detail {
             __this: ::core::pin::Pin<&'a mut crate::VirtualDerived>,
             __param_0: ::ctor::RvalueReference<'b, crate::VirtualDerived>,
         ) -> ::core::pin::Pin<&'a mut crate::VirtualDerived>;
-        pub fn __crubit_dynamic_upcast__14VirtualDerived__to__12VirtualBase1(
-            from: *const crate::VirtualDerived,
-        ) -> *const crate::VirtualBase1;
-        pub fn __crubit_dynamic_upcast__14VirtualDerived__to__5Base1(
-            from: *const crate::VirtualDerived,
-        ) -> *const crate::Base1;
-        pub fn __crubit_dynamic_upcast__14VirtualDerived__to__12VirtualBase2(
-            from: *const crate::VirtualDerived,
-        ) -> *const crate::VirtualBase2;
         pub(crate) fn __rust_thunk___ZN15MyAbstractClassaSERKS_<'a, 'b>(
             __this: ::core::pin::Pin<&'a mut crate::MyAbstractClass>,
             __param_0: &'b crate::MyAbstractClass,
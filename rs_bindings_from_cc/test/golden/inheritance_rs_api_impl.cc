@@ -151,12 +151,6 @@ extern "C" class VirtualBase1* __rust_thunk___ZN12VirtualBase1aSEOS_(
   return &__this->operator=(std::move(*__param_0));
 }
 
-extern "C" const class Base1&
-__crubit_dynamic_upcast__12VirtualBase1__to__5Base1(
-    const class VirtualBase1& from) {
-  return from;
-}
-
 static_assert(CRUBIT_SIZEOF(class VirtualBase2) == 24);
 static_assert(alignof(class VirtualBase2) == 8);
 
@@ -185,12 +179,6 @@ extern "C" class VirtualBase2* __rust_thunk___ZN12VirtualBase2aSEOS_(
   return &__this->operator=(std::move(*__param_0));
 }
 
-extern "C" const class Base1&
-__crubit_dynamic_upcast__12VirtualBase2__to__5Base1(
-    const class VirtualBase2& from) {
-  return from;
-}
-
 static_assert(CRUBIT_SIZEOF(class VirtualDerived) == 32);
 static_assert(alignof(class VirtualDerived) == 8);
 
@@ -219,22 +207,6 @@ extern "C" class VirtualDerived* __rust_thunk___ZN14VirtualDerivedaSEOS_(
   return &__this->operator=(std::move(*__param_0));
 }
 
-extern "C" const class VirtualBase1&
-__crubit_dynamic_upcast__14VirtualDerived__to__12VirtualBase1(
-    const class VirtualDerived& from) {
-  return from;
-}
-extern "C" const class Base1&
-__crubit_dynamic_upcast__14VirtualDerived__to__5Base1(
-    const class VirtualDerived& from) {
-  return from;
-}
-extern "C" const class VirtualBase2&
-__crubit_dynamic_upcast__14VirtualDerived__to__12VirtualBase2(
-    const class VirtualDerived& from) {
-  return from;
-}
-
 static_assert(CRUBIT_SIZEOF(class MyAbstractClass) == 8);
 static_assert(alignof(class MyAbstractClass) == 8);
 
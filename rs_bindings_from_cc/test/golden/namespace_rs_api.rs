@@ -77,8 +77,8 @@ pub mod test_namespace_bindings {
 
     /// Free comment inside namespace
     #[inline(always)]
-    pub fn f(mut s: crate::test_namespace_bindings::S) -> ::core::ffi::c_int {
-        unsafe { crate::detail::__rust_thunk___ZN23test_namespace_bindings1fENS_1SE(&mut s) }
+    pub fn f(s: crate::test_namespace_bindings::S) -> ::core::ffi::c_int {
+        unsafe { crate::detail::__rust_thunk___ZN23test_namespace_bindings1fENS_1SE(s) }
     }
 
     #[inline(always)]
@@ -99,15 +99,8 @@ pub mod test_namespace_bindings {
 // namespace test_namespace_bindings
 
 #[inline(always)]
-pub fn identity(mut s: crate::test_namespace_bindings::S) -> crate::test_namespace_bindings::S {
-    unsafe {
-        let mut __return = ::core::mem::MaybeUninit::<crate::test_namespace_bindings::S>::uninit();
-        crate::detail::__rust_thunk___Z8identityN23test_namespace_bindings1SE(
-            &mut __return,
-            &mut s,
-        );
-        __return.assume_init()
-    }
+pub fn identity(s: crate::test_namespace_bindings::S) -> crate::test_namespace_bindings::S {
+    unsafe { crate::detail::__rust_thunk___Z8identityN23test_namespace_bindings1SE(s) }
 }
 
 pub mod test_namespace_bindings_reopened_0 {
@@ -310,16 +303,17 @@ mod detail {
             __this: &'a mut crate::test_namespace_bindings::S,
             __param_0: ::ctor::RvalueReference<'b, crate::test_namespace_bindings::S>,
         ) -> &'a mut crate::test_namespace_bindings::S;
+        #[link_name = "_ZN23test_namespace_bindings1fENS_1SE"]
         pub(crate) fn __rust_thunk___ZN23test_namespace_bindings1fENS_1SE(
-            s: &mut crate::test_namespace_bindings::S,
+            s: crate::test_namespace_bindings::S,
         ) -> ::core::ffi::c_int;
         pub(crate) fn __rust_thunk___ZN23test_namespace_bindings15inline_functionEv();
         #[link_name = "_ZN23test_namespace_bindings5inner1iEv"]
         pub(crate) fn __rust_thunk___ZN23test_namespace_bindings5inner1iEv();
+        #[link_name = "_Z8identityN23test_namespace_bindings1SE"]
         pub(crate) fn __rust_thunk___Z8identityN23test_namespace_bindings1SE(
-            __return: &mut ::core::mem::MaybeUninit<crate::test_namespace_bindings::S>,
-            s: &mut crate::test_namespace_bindings::S,
-        );
+            s: crate::test_namespace_bindings::S,
+        ) -> crate::test_namespace_bindings::S;
         #[link_name = "_ZN32test_namespace_bindings_reopened1xEv"]
         pub(crate) fn __rust_thunk___ZN32test_namespace_bindings_reopened1xEv();
         pub(crate) fn __rust_thunk___ZN32test_namespace_bindings_reopened5inner1SC1Ev<'a>(
@@ -633,6 +633,27 @@ impl Clone for NontrivialUnpin {
     }
 }
 
+impl NontrivialUnpin {
+    /// Clones the elements of `src` into `dest`, with a single call into C++, and returns the clones.
+    ///
+    /// Panics if `src` and `dest` don't have the same length.
+    #[inline(always)]
+    pub fn clone_slice_into_uninit<'a>(
+        src: &[Self],
+        dest: &'a mut [::core::mem::MaybeUninit<Self>],
+    ) -> &'a mut [Self] {
+        assert_eq!(src.len(), dest.len());
+        unsafe {
+            crate::detail::__rust_copy_construct_n_thunk___ZN15NontrivialUnpinC1ERKS_(
+                dest.as_mut_ptr() as *mut Self,
+                src.as_ptr(),
+                src.len(),
+            );
+            &mut *(dest as *mut [::core::mem::MaybeUninit<Self>] as *mut [Self])
+        }
+    }
+}
+
 impl<'b> From<::ctor::RvalueReference<'b, Self>> for NontrivialUnpin {
     #[inline(always)]
     fn from(__param_0: ::ctor::RvalueReference<'b, Self>) -> Self {
@@ -689,6 +710,21 @@ impl Drop for NontrivialUnpin {
     }
 }
 
+impl NontrivialUnpin {
+    /// Drops the elements of `slice` in place, with a single call into C++.
+    ///
+    /// # Safety
+    ///
+    /// The same as for `core::ptr::drop_in_place(slice)`.
+    #[inline(always)]
+    pub unsafe fn drop_slice_in_place(slice: *mut [Self]) {
+        crate::detail::__rust_destroy_n_thunk___ZN15NontrivialUnpinD1Ev(
+            slice as *mut Self,
+            slice.len(),
+        )
+    }
+}
+
 impl NontrivialUnpin {
     #[inline(always)]
     pub fn MemberFunction<'a>(&'a mut self) {
@@ -731,15 +767,8 @@ pub fn TakesByValueInline(
 }
 
 #[inline(always)]
-pub fn TakesByValueUnpin(mut nontrivial: crate::NontrivialUnpin) -> crate::NontrivialUnpin {
-    unsafe {
-        let mut __return = ::core::mem::MaybeUninit::<crate::NontrivialUnpin>::uninit();
-        crate::detail::__rust_thunk___Z17TakesByValueUnpin15NontrivialUnpin(
-            &mut __return,
-            &mut nontrivial,
-        );
-        __return.assume_init()
-    }
+pub fn TakesByValueUnpin(nontrivial: crate::NontrivialUnpin) -> crate::NontrivialUnpin {
+    unsafe { crate::detail::__rust_thunk___Z17TakesByValueUnpin15NontrivialUnpin(nontrivial) }
 }
 
 #[inline(always)]
@@ -1134,6 +1163,11 @@ mod detail {
             __this: &'a mut ::core::mem::MaybeUninit<crate::NontrivialUnpin>,
             __param_0: &'b crate::NontrivialUnpin,
         );
+        pub(crate) fn __rust_copy_construct_n_thunk___ZN15NontrivialUnpinC1ERKS_(
+            __this: *mut crate::NontrivialUnpin,
+            __other: *const crate::NontrivialUnpin,
+            __n: usize,
+        );
         #[link_name = "_ZN15NontrivialUnpinC1EOS_"]
         pub(crate) fn __rust_thunk___ZN15NontrivialUnpinC1EOS_<'a, 'b>(
             __this: &'a mut ::core::mem::MaybeUninit<crate::NontrivialUnpin>,
@@ -1163,6 +1197,10 @@ mod detail {
         pub(crate) fn __rust_thunk___ZN15NontrivialUnpinD1Ev<'a>(
             __this: &'a mut crate::NontrivialUnpin,
         );
+        pub(crate) fn __rust_destroy_n_thunk___ZN15NontrivialUnpinD1Ev(
+            __this: *mut crate::NontrivialUnpin,
+            __n: usize,
+        );
         #[link_name = "_ZN15NontrivialUnpin14MemberFunctionEv"]
         pub(crate) fn __rust_thunk___ZN15NontrivialUnpin14MemberFunctionEv<'a>(
             __this: &'a mut crate::NontrivialUnpin,
@@ -1175,10 +1213,10 @@ mod detail {
             __return: &mut ::core::mem::MaybeUninit<crate::NontrivialInline>,
             nontrivial: &mut crate::NontrivialInline,
         );
+        #[link_name = "_Z17TakesByValueUnpin15NontrivialUnpin"]
         pub(crate) fn __rust_thunk___Z17TakesByValueUnpin15NontrivialUnpin(
-            __return: &mut ::core::mem::MaybeUninit<crate::NontrivialUnpin>,
-            nontrivial: &mut crate::NontrivialUnpin,
-        );
+            nontrivial: crate::NontrivialUnpin,
+        ) -> crate::NontrivialUnpin;
         #[link_name = "_Z16TakesByReferenceR10Nontrivial"]
         pub(crate) fn __rust_thunk___Z16TakesByReferenceR10Nontrivial<'a>(
             nontrivial: ::core::pin::Pin<&'a mut crate::Nontrivial>,
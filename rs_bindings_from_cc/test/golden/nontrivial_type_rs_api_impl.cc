@@ -131,6 +131,17 @@ static_assert(CRUBIT_SIZEOF(struct NontrivialUnpin) == 4);
 static_assert(alignof(struct NontrivialUnpin) == 4);
 static_assert(CRUBIT_OFFSET_OF(field, struct NontrivialUnpin) == 0);
 
+extern "C" void __rust_copy_construct_n_thunk___ZN15NontrivialUnpinC1ERKS_(
+    struct NontrivialUnpin* __this, const struct NontrivialUnpin* __other,
+    std::size_t __n) {
+  std::uninitialized_copy_n(__other, __n, __this);
+}
+
+extern "C" void __rust_destroy_n_thunk___ZN15NontrivialUnpinD1Ev(
+    struct NontrivialUnpin* __this, std::size_t __n) {
+  std::destroy_n(__this, __n);
+}
+
 extern "C" void __rust_thunk___Z12TakesByValue10Nontrivial(
     struct Nontrivial* __return, struct Nontrivial* nontrivial) {
   new (__return) auto(TakesByValue(std::move(*nontrivial)));
@@ -141,11 +152,6 @@ extern "C" void __rust_thunk___Z18TakesByValueInline16NontrivialInline(
   new (__return) auto(TakesByValueInline(std::move(*nontrivial)));
 }
 
-extern "C" void __rust_thunk___Z17TakesByValueUnpin15NontrivialUnpin(
-    struct NontrivialUnpin* __return, struct NontrivialUnpin* nontrivial) {
-  new (__return) auto(TakesByValueUnpin(std::move(*nontrivial)));
-}
-
 static_assert(sizeof(struct NontrivialByValue) == 1);
 static_assert(alignof(struct NontrivialByValue) == 1);
 
@@ -130,7 +130,9 @@ impl<'b> ::ctor::Assign<::ctor::RvalueReference<'b, Self>> for Derived2 {
 
 unsafe impl oops::Inherits<inheritance_cc::Base0> for crate::Derived2 {
     unsafe fn upcast_ptr(derived: *const Self) -> *const inheritance_cc::Base0 {
-        crate::detail::__crubit_dynamic_upcast__8Derived2__to__5Base0(derived)
+        let vptr = *(derived as *const *const u8);
+        let vbase_offset = *(vptr.offset(-24) as *const isize);
+        (derived as *const u8).offset(vbase_offset) as *const inheritance_cc::Base0
     }
 }
 unsafe impl oops::Inherits<inheritance_cc::Base1> for crate::Derived2 {
@@ -246,17 +248,23 @@ impl<'b> ::ctor::Assign<::ctor::RvalueReference<'b, Self>> for VirtualDerived2 {
 
 unsafe impl oops::Inherits<inheritance_cc::VirtualBase1> for crate::VirtualDerived2 {
     unsafe fn upcast_ptr(derived: *const Self) -> *const inheritance_cc::VirtualBase1 {
-        crate::detail::__crubit_dynamic_upcast__15VirtualDerived2__to__12VirtualBase1(derived)
+        let vptr = *(derived as *const *const u8);
+        let vbase_offset = *(vptr.offset(-32) as *const isize);
+        (derived as *const u8).offset(vbase_offset) as *const inheritance_cc::VirtualBase1
     }
 }
 unsafe impl oops::Inherits<inheritance_cc::Base1> for crate::VirtualDerived2 {
     unsafe fn upcast_ptr(derived: *const Self) -> *const inheritance_cc::Base1 {
-        crate::detail::__crubit_dynamic_upcast__15VirtualDerived2__to__5Base1(derived)
+        let vptr = *(derived as *const *const u8);
+        let vbase_offset = *(vptr.offset(-24) as *const isize);
+        (derived as *const u8).offset(vbase_offset) as *const inheritance_cc::Base1
     }
 }
 unsafe impl oops::Inherits<inheritance_cc::VirtualBase2> for crate::VirtualDerived2 {
     unsafe fn upcast_ptr(derived: *const Self) -> *const inheritance_cc::VirtualBase2 {
-        crate::detail::__crubit_dynamic_upcast__15VirtualDerived2__to__12VirtualBase2(derived)
+        let vptr = *(derived as *const *const u8);
+        let vbase_offset = *(vptr.offset(-40) as *const isize);
+        (derived as *const u8).offset(vbase_offset) as *const inheritance_cc::VirtualBase2
     }
 }
 
@@ -285,9 +293,6 @@ mod detail {
             __this: ::core::pin::Pin<&'a mut crate::Derived2>,
             __param_0: ::ctor::RvalueReference<'b, crate::Derived2>,
         ) -> ::core::pin::Pin<&'a mut crate::Derived2>;
-        pub fn __crubit_dynamic_upcast__8Derived2__to__5Base0(
-            from: *const crate::Derived2,
-        ) -> *const inheritance_cc::Base0;
         pub(crate) fn __rust_thunk___ZN15VirtualDerived2C1Ev<'a>(
             __this: &'a mut ::core::mem::MaybeUninit<crate::VirtualDerived2>,
         );
@@ -307,15 +312,6 @@ mod detail {
             __this: ::core::pin::Pin<&'a mut crate::VirtualDerived2>,
             __param_0: ::ctor::RvalueReference<'b, crate::VirtualDerived2>,
         ) -> ::core::pin::Pin<&'a mut crate::VirtualDerived2>;
-        pub fn __crubit_dynamic_upcast__15VirtualDerived2__to__12VirtualBase1(
-            from: *const crate::VirtualDerived2,
-        ) -> *const inheritance_cc::VirtualBase1;
-        pub fn __crubit_dynamic_upcast__15VirtualDerived2__to__5Base1(
-            from: *const crate::VirtualDerived2,
-        ) -> *const inheritance_cc::Base1;
-        pub fn __crubit_dynamic_upcast__15VirtualDerived2__to__12VirtualBase2(
-            from: *const crate::VirtualDerived2,
-        ) -> *const inheritance_cc::VirtualBase2;
     }
 }
 
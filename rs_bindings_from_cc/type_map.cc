@@ -11,7 +11,14 @@
 #include "absl/status/statusor.h"
 #include "common/status_macros.h"
 #include "rs_bindings_from_cc/ir.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/DeclTemplate.h"
+#include "clang/AST/PrettyPrinter.h"
+#include "clang/AST/TemplateBase.h"
 #include "clang/AST/Type.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Casting.h"
 
 namespace crubit {
 
@@ -64,6 +71,37 @@ std::optional<absl::string_view> MapKnownCcTypeToRsType(
   return it->second;
 }
 
+// Returns whether `decl` is declared in the top-level namespace `name`, or in
+// inline namespaces nested in it (e.g. `absl::lts_20230125`).
+bool IsInTopLevelNamespace(const clang::Decl* decl, absl::string_view name) {
+  const clang::DeclContext* context = decl->getDeclContext();
+  while (const auto* ns = llvm::dyn_cast<clang::NamespaceDecl>(context)) {
+    if (!ns->isInline()) {
+      return ns->getName() == llvm::StringRef(name.data(), name.size()) &&
+             ns->getDeclContext()->getRedeclContext()->isTranslationUnit();
+    }
+    context = ns->getDeclContext();
+  }
+  return false;
+}
+
+// Returns whether `type` is `std::name<element_type>`, e.g. the default
+// allocator `std::allocator<element_type>`.
+bool IsStdSpecializationOf(clang::QualType type, llvm::StringRef name,
+                           clang::QualType element_type) {
+  const auto* decl =
+      llvm::dyn_cast_or_null<clang::ClassTemplateSpecializationDecl>(
+          type->getAsCXXRecordDecl());
+  if (decl == nullptr || decl->getName() != name ||
+      !decl->isInStdNamespace()) {
+    return false;
+  }
+  const clang::TemplateArgumentList& args = decl->getTemplateArgs();
+  return args.size() == 1 &&
+         args[0].getKind() == clang::TemplateArgument::Type &&
+         decl->getASTContext().hasSameType(args[0].getAsType(), element_type);
+}
+
 }  // namespace
 
 std::optional<MappedType> GetTypeMapOverride(const clang::Type& cc_type) {
@@ -76,4 +114,69 @@ std::optional<MappedType> GetTypeMapOverride(const clang::Type& cc_type) {
   return std::nullopt;
 }
 
+std::optional<ContiguousStorageType> GetContiguousStorageType(
+    const clang::Type& cc_type) {
+  const auto* decl =
+      llvm::dyn_cast_or_null<clang::ClassTemplateSpecializationDecl>(
+          cc_type.getAsCXXRecordDecl());
+  if (decl == nullptr) return std::nullopt;
+  const clang::TemplateArgumentList& args = decl->getTemplateArgs();
+  if (args.size() == 0 || args[0].getKind() != clang::TemplateArgument::Type) {
+    return std::nullopt;
+  }
+  clang::QualType element_type = args[0].getAsType();
+  const clang::ASTContext& ast_context = decl->getASTContext();
+
+  ContiguousStorageType::Kind kind;
+  if (decl->getName() == "span" && decl->isInStdNamespace() &&
+      args.size() == 2 &&
+      args[1].getKind() == clang::TemplateArgument::Integral &&
+      args[1].getAsIntegral().isMaxValue()) {
+    // `std::dynamic_extent` is the maximum `size_t`. Spans with a static
+    // extent don't store their size.
+    kind = ContiguousStorageType::kSpan;
+  } else if (decl->getName() == "Span" && IsInTopLevelNamespace(decl, "absl") &&
+             args.size() == 1) {
+    kind = ContiguousStorageType::kSpan;
+  } else if (decl->getName() == "vector" && decl->isInStdNamespace() &&
+             args.size() == 2 &&
+             args[1].getKind() == clang::TemplateArgument::Type &&
+             IsStdSpecializationOf(args[1].getAsType(), "allocator",
+                                   element_type) &&
+             // `std::vector<bool>` packs its elements into bits.
+             !element_type->isBooleanType()) {
+    kind = ContiguousStorageType::kVector;
+  } else if (decl->getName() == "basic_string" && decl->isInStdNamespace() &&
+             args.size() == 3 &&
+             ast_context.hasSameType(element_type, ast_context.CharTy) &&
+             args[1].getKind() == clang::TemplateArgument::Type &&
+             IsStdSpecializationOf(args[1].getAsType(), "char_traits",
+                                   element_type) &&
+             args[2].getKind() == clang::TemplateArgument::Type &&
+             IsStdSpecializationOf(args[2].getAsType(), "allocator",
+                                   element_type)) {
+    kind = ContiguousStorageType::kString;
+  } else {
+    return std::nullopt;
+  }
+
+  if (element_type->isDependentType() || element_type->isIncompleteType() ||
+      element_type.isVolatileQualified() ||
+      !element_type.isTriviallyCopyableType(ast_context)) {
+    return std::nullopt;
+  }
+
+  // Same as the names of class template specializations in `cxx_record.cc`.
+  clang::PrintingPolicy policy(ast_context.getLangOpts());
+  policy.IncludeTagDefinition = false;
+  policy.PrintCanonicalTypes = true;
+  policy.AlwaysIncludeTypeForTemplateArgument = true;
+  return ContiguousStorageType{
+      .kind = kind,
+      .element_type = element_type,
+      .cc_name =
+          clang::QualType(decl->getTypeForDecl(), 0).getAsString(policy),
+  };
+}
+
 }  // namespace crubit
@@ -6,6 +6,7 @@
 #define THIRD_PARTY_CRUBIT_RS_BINDINGS_FROM_CC_KNOWN_TYPES_MAP_H_
 
 #include <optional>
+#include <string>
 
 #include "absl/strings/string_view.h"
 #include "rs_bindings_from_cc/ir.h"
@@ -25,6 +26,39 @@ namespace crubit {
 // of types.
 std::optional<MappedType> GetTypeMapOverride(const clang::Type& cc_type);
 
+// A C++ view or container which stores its elements contiguously, and whose
+// layout is mirrored by a generic Rust type in `cc_std`. This lets the bindings
+// expose the elements as a Rust slice, without copying them.
+struct ContiguousStorageType {
+  enum Kind {
+    // `std::span<T>` with a dynamic extent, or `absl::Span<T>`: a pointer to
+    // the first element, and the number of elements.
+    kSpan,
+    // `std::vector<T>` with the default allocator: pointers to the first
+    // element, past the last element, and past the end of the allocation.
+    // Only vectors with these members of libc++ are mapped to
+    // `cc_std::Vector`.
+    kVector,
+    // `std::string`, i.e. `std::basic_string<char>` with the default traits
+    // and allocator: a short string stored inline, or the capacity, size and
+    // data pointer of a heap-allocated buffer. Only the default layout of
+    // libc++ on little-endian targets is mapped to `cc_std::StdString`.
+    kString,
+  };
+  Kind kind;
+  // The type of the elements, which is trivially copyable. For spans, it may
+  // be `const`-qualified.
+  clang::QualType element_type;
+  // The fully qualified C++ name of `cc_type`.
+  std::string cc_name;
+};
+
+// Returns the kind and element type of `cc_type`, if it is one of the
+// contiguous storage types described above, with a trivially copyable element
+// type.
+std::optional<ContiguousStorageType> GetContiguousStorageType(
+    const clang::Type& cc_type);
+
 }  // namespace crubit
 
 #endif  // THIRD_PARTY_CRUBIT_RS_BINDINGS_FROM_CC_KNOWN_TYPES_MAP_H_
@@ -0,0 +1,147 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+use core::mem::size_of;
+use core::slice;
+
+/// A view of contiguous `T`s which can't be modified through the view.
+///
+/// This is the Rust type of C++ `std::span<const T>` (with a dynamic extent)
+/// and `absl::Span<const T>` in the bindings, which have the same layout: a
+/// pointer to the first element, and the number of elements. The bindings
+/// statically assert that the layout of the C++ type matches.
+///
+/// Like C++ pointers without lifetime annotations, spans don't borrow the
+/// elements, so reading them is unsafe, and so are the bindings of C++
+/// functions which take spans.
+#[repr(C)]
+pub struct Span<T> {
+    data: *const T,
+    size: usize,
+}
+
+/// A view of contiguous `T`s which can be modified through the view.
+///
+/// This is the Rust type of C++ `std::span<T>` (with a dynamic extent) and
+/// `absl::Span<T>` in the bindings. See `Span`.
+#[repr(C)]
+pub struct SpanMut<T> {
+    data: *mut T,
+    size: usize,
+}
+
+const _: () = assert!(size_of::<Span<u8>>() == 2 * size_of::<usize>());
+const _: () = assert!(size_of::<SpanMut<u8>>() == 2 * size_of::<usize>());
+
+// Not derived, because the spans are `Copy` even if `T` isn't.
+impl<T> Clone for Span<T> {
+    fn clone(&self) -> Self {
+        *self
+    }
+}
+impl<T> Copy for Span<T> {}
+
+impl<T> Clone for SpanMut<T> {
+    fn clone(&self) -> Self {
+        *self
+    }
+}
+impl<T> Copy for SpanMut<T> {}
+
+/// Returns the elements of a span, which may have a null `data` pointer if it
+/// is empty (unlike Rust slices).
+///
+/// SAFETY: `data` must point to `size` elements which stay valid, and aren't
+/// mutated, for `'a`.
+unsafe fn slice_from_span<'a, T>(data: *const T, size: usize) -> &'a [T] {
+    if size == 0 {
+        return &[];
+    }
+    slice::from_raw_parts(data, size)
+}
+
+impl<T> Span<T> {
+    /// Returns the number of elements.
+    pub fn len(self) -> usize {
+        self.size
+    }
+
+    /// Returns whether the span has no elements.
+    pub fn is_empty(self) -> bool {
+        self.size == 0
+    }
+
+    /// Returns a pointer to the first element, which may be null if the span
+    /// is empty.
+    pub fn as_ptr(self) -> *const T {
+        self.data
+    }
+
+    /// Returns the elements as a slice, without copying them.
+    ///
+    /// SAFETY: the elements must stay valid, and must not be mutated, for
+    /// `'a`.
+    pub unsafe fn as_slice<'a>(self) -> &'a [T] {
+        slice_from_span(self.data, self.size)
+    }
+}
+
+impl<T> SpanMut<T> {
+    /// Returns the number of elements.
+    pub fn len(self) -> usize {
+        self.size
+    }
+
+    /// Returns whether the span has no elements.
+    pub fn is_empty(self) -> bool {
+        self.size == 0
+    }
+
+    /// Returns a pointer to the first element, which may be null if the span
+    /// is empty.
+    pub fn as_mut_ptr(self) -> *mut T {
+        self.data
+    }
+
+    /// Returns the elements as a slice, without copying them.
+    ///
+    /// SAFETY: the elements must stay valid, and must not be mutated, for
+    /// `'a`.
+    pub unsafe fn as_slice<'a>(self) -> &'a [T] {
+        slice_from_span(self.data, self.size)
+    }
+
+    /// Returns the elements as a mutable slice, without copying them.
+    ///
+    /// SAFETY: the elements must stay valid, and must not be accessed other
+    /// than through the returned slice, for `'a`.
+    pub unsafe fn as_mut_slice<'a>(self) -> &'a mut [T] {
+        if self.size == 0 {
+            return &mut [];
+        }
+        slice::from_raw_parts_mut(self.data, self.size)
+    }
+}
+
+/// Borrows the elements of `s`. The span must not be used after `s` is
+/// dropped or modified.
+impl<T> From<&[T]> for Span<T> {
+    fn from(s: &[T]) -> Self {
+        Span { data: s.as_ptr(), size: s.len() }
+    }
+}
+
+/// Borrows the elements of `s`. The span must not be used after `s` is
+/// dropped, or while `s` is used.
+impl<T> From<&mut [T]> for SpanMut<T> {
+    fn from(s: &mut [T]) -> Self {
+        SpanMut { data: s.as_mut_ptr(), size: s.len() }
+    }
+}
+
+impl<T> From<SpanMut<T>> for Span<T> {
+    fn from(span: SpanMut<T>) -> Self {
+        Span { data: span.data, size: span.size }
+    }
+}
@@ -0,0 +1,169 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// The layout below is the default (little-endian) layout of libc++.
+#![cfg(target_endian = "little")]
+
+use crate::StringView;
+use core::fmt;
+use core::mem::size_of;
+use core::ptr;
+use core::slice;
+use core::str::{self, Utf8Error};
+
+/// The characters of a C++ `std::string`.
+///
+/// This is the Rust type of `std::string` behind C++ pointers and references in
+/// the bindings. It mirrors the layout of the libc++ `std::string`, so that the
+/// characters can be accessed as a slice, and appended to within the capacity
+/// of the string, without copying them or calling into C++. The bindings only
+/// use it for the default layout of libc++ (not the alternate layout, nor
+/// other standard libraries), and statically assert that the size and
+/// alignment of the C++ type match.
+///
+/// Strings can't be created, reallocated or destroyed in Rust.
+#[repr(C)]
+pub struct StdString {
+    // libc++ stores a string either inline (a "short" string), or in a heap
+    // allocation (a "long" string). The lowest bit of the first byte tells
+    // them apart:
+    // - short strings store their size shifted left by one in the first byte,
+    //   followed by the characters and a null terminator;
+    // - long strings store the size of the allocation (which is even) with the
+    //   lowest bit set, the size of the string, and a pointer to the
+    //   characters and a null terminator.
+    words: [usize; 3],
+}
+
+const _: () = assert!(size_of::<StdString>() == 3 * size_of::<usize>());
+
+/// The capacity of short strings: all bytes but the size and the null
+/// terminator.
+const SHORT_CAPACITY: usize = size_of::<StdString>() - 2;
+
+/// The error returned when appending to a `StdString` would require
+/// reallocating it.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub struct CapacityError;
+
+impl fmt::Display for CapacityError {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.write_str("the string would have to be reallocated")
+    }
+}
+
+impl StdString {
+    fn is_long(&self) -> bool {
+        self.words[0] & 1 != 0
+    }
+
+    /// Returns the number of bytes.
+    pub fn len(&self) -> usize {
+        if self.is_long() {
+            self.words[1]
+        } else {
+            (self.words[0] as u8 >> 1) as usize
+        }
+    }
+
+    /// Returns whether the string is empty.
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Returns the number of bytes the string can hold without reallocating.
+    pub fn capacity(&self) -> usize {
+        // The allocation also holds the null terminator.
+        if self.is_long() {
+            (self.words[0] & !1) - 1
+        } else {
+            SHORT_CAPACITY
+        }
+    }
+
+    fn data_ptr(&self) -> *const u8 {
+        if self.is_long() {
+            self.words[2] as *const u8
+        } else {
+            (self as *const Self as *const u8).wrapping_add(1)
+        }
+    }
+
+    fn data_mut_ptr(&mut self) -> *mut u8 {
+        if self.is_long() {
+            self.words[2] as *mut u8
+        } else {
+            (self as *mut Self as *mut u8).wrapping_add(1)
+        }
+    }
+
+    /// Returns the characters as a byte slice, without copying them.
+    pub fn as_bytes(&self) -> &[u8] {
+        // SAFETY: the string owns `len()` initialized bytes, which can't be
+        // modified while `self` is borrowed.
+        unsafe { slice::from_raw_parts(self.data_ptr(), self.len()) }
+    }
+
+    /// Returns the characters as a mutable byte slice, without copying them.
+    pub fn as_mut_bytes(&mut self) -> &mut [u8] {
+        let len = self.len();
+        // SAFETY: the string owns `len()` initialized bytes, which can only be
+        // accessed through `self` while it is mutably borrowed.
+        unsafe { slice::from_raw_parts_mut(self.data_mut_ptr(), len) }
+    }
+
+    /// Returns the characters as a string slice, without copying them, or an
+    /// error if they are not valid UTF-8.
+    pub fn to_str(&self) -> Result<&str, Utf8Error> {
+        str::from_utf8(self.as_bytes())
+    }
+
+    /// Returns the characters as a string slice, without copying or checking
+    /// them.
+    ///
+    /// SAFETY: the characters must be valid UTF-8.
+    pub unsafe fn to_str_unchecked(&self) -> &str {
+        str::from_utf8_unchecked(self.as_bytes())
+    }
+
+    /// Appends `bytes` in place, or returns an error and leaves the string
+    /// unchanged if that would exceed its capacity.
+    ///
+    /// Reallocating the string requires calling into C++ (e.g. `reserve()`
+    /// before passing it to Rust).
+    pub fn try_extend_from_slice(&mut self, bytes: &[u8]) -> Result<(), CapacityError> {
+        let len = self.len();
+        let new_len = match len.checked_add(bytes.len()) {
+            Some(new_len) if new_len <= self.capacity() => new_len,
+            _ => return Err(CapacityError),
+        };
+        // SAFETY: the string owns `capacity() + 1` bytes, which can only be
+        // accessed through `self` while it is mutably borrowed.
+        unsafe {
+            let data = self.data_mut_ptr();
+            ptr::copy_nonoverlapping(bytes.as_ptr(), data.add(len), bytes.len());
+            *data.add(new_len) = 0;
+        }
+        if self.is_long() {
+            self.words[1] = new_len;
+        } else {
+            // Only replace the first byte: the others hold characters.
+            self.words[0] = (self.words[0] & !0xff) | (new_len << 1);
+        }
+        Ok(())
+    }
+
+    /// Appends `s` in place, or returns an error and leaves the string
+    /// unchanged if that would exceed its capacity.
+    pub fn try_push_str(&mut self, s: &str) -> Result<(), CapacityError> {
+        self.try_extend_from_slice(s.as_bytes())
+    }
+}
+
+/// Views the characters of `s` as a C++ string_view, without copying them.
+impl<'a> From<&'a StdString> for StringView<'a> {
+    fn from(s: &'a StdString) -> Self {
+        StringView::from(s.as_bytes())
+    }
+}
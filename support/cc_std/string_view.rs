@@ -4,7 +4,9 @@
 
 use crate::std::string_view;
 use core::convert::TryFrom;
+use core::marker::PhantomData;
 use core::ptr;
+use core::str::Utf8Error;
 
 impl From<string_view> for *const [u8] {
     fn from(sv: string_view) -> Self {
@@ -50,25 +52,29 @@ impl TryFrom<string_view> for &'static str {
     }
 }
 
+/// Creates a C++ string_view of `size` bytes starting at `data`.
+fn string_view_from_raw_parts(data: *const u8, size: usize) -> string_view {
+    let ptr = if size == 0 { 0 as *const u8 } else { data };
+
+    // TODO(jeanpierreda): We can't access the constructors at the moment.
+    // This little maneuver's gonna cost us 51 years of annoying build breakages
+    // later, so really we should try to get the constructors callable.
+    unsafe {
+        let mut sv = <core::mem::MaybeUninit<string_view>>::zeroed().assume_init();
+        sv.__data_ = core::mem::transmute(ptr);
+        sv.__size_ = core::mem::transmute(size);
+        sv
+    }
+}
+
 /// Currently only implementing conversion from &'static str, because
 /// string_view isn't yet annotated with lifetimes, and so is unsafe to use
-/// with non-static lifetimes.
+/// with non-static lifetimes. Use `StringView<'a>` for other lifetimes.
 // TODO(b/246425449): This should implement correct lifetimes, once string_view
 // has lifetime annotations.
 impl From<&'static [u8]> for string_view {
     fn from(s: &'static [u8]) -> Self {
-        let size = s.len();
-        let ptr = if size == 0 { 0 as *const _ } else { s.as_ptr() };
-
-        // TODO(jeanpierreda): We can't access the constructors at the moment.
-        // This little maneuver's gonna cost us 51 years of annoying build breakages
-        // later, so really we should try to get the constructors callable.
-        unsafe {
-            let mut sv = <core::mem::MaybeUninit<string_view>>::zeroed().assume_init();
-            sv.__data_ = core::mem::transmute(ptr);
-            sv.__size_ = core::mem::transmute(size);
-            sv
-        }
+        string_view_from_raw_parts(s.as_ptr(), s.len())
     }
 }
 
@@ -79,3 +85,84 @@ impl From<&'static str> for string_view {
         string_view::from(s.as_bytes())
     }
 }
+
+/// A C++ string_view whose characters are borrowed for `'a`.
+///
+/// `StringView<'a>` has the same layout as `string_view`, and converts to and
+/// from `&'a [u8]` and `&'a str` without copying the characters. Unlike the
+/// conversions of `string_view`, which assume that the characters live
+/// forever, these conversions are safe.
+///
+/// A `string_view` returned from C++ can be given a lifetime with
+/// `StringView::from_raw`, and a `StringView` can be passed to C++ with
+/// `StringView::into_raw`.
+#[derive(Clone, Copy)]
+#[repr(transparent)]
+pub struct StringView<'a> {
+    sv: string_view,
+    _phantom: PhantomData<&'a [u8]>,
+}
+
+impl<'a> StringView<'a> {
+    /// Borrows the characters of `sv` for `'a`.
+    ///
+    /// SAFETY: the characters of `sv` must stay valid, and must not be
+    /// mutated, for `'a`.
+    pub unsafe fn from_raw(sv: string_view) -> Self {
+        StringView { sv, _phantom: PhantomData }
+    }
+
+    /// Returns the C++ string_view, which no longer borrows the characters.
+    pub fn into_raw(self) -> string_view {
+        self.sv
+    }
+
+    /// Returns the characters as a byte slice, without copying them.
+    pub fn as_bytes(self) -> &'a [u8] {
+        let raw_slice: *const [u8] = self.sv.into();
+        // SAFETY: the characters are borrowed for `'a`.
+        unsafe { &*raw_slice }
+    }
+
+    /// Returns the characters as a string slice, without copying them, or an
+    /// error if they are not valid UTF-8.
+    pub fn to_str(self) -> Result<&'a str, Utf8Error> {
+        core::str::from_utf8(self.as_bytes())
+    }
+
+    /// Returns the characters as a string slice, without copying or checking
+    /// them.
+    ///
+    /// SAFETY: the characters must be valid UTF-8.
+    pub unsafe fn to_str_unchecked(self) -> &'a str {
+        core::str::from_utf8_unchecked(self.as_bytes())
+    }
+}
+
+impl<'a> From<&'a [u8]> for StringView<'a> {
+    fn from(s: &'a [u8]) -> Self {
+        // SAFETY: `s` is borrowed for `'a`.
+        unsafe { StringView::from_raw(string_view_from_raw_parts(s.as_ptr(), s.len())) }
+    }
+}
+
+impl<'a> From<&'a str> for StringView<'a> {
+    fn from(s: &'a str) -> Self {
+        StringView::from(s.as_bytes())
+    }
+}
+
+impl<'a> From<StringView<'a>> for &'a [u8] {
+    fn from(sv: StringView<'a>) -> Self {
+        sv.as_bytes()
+    }
+}
+
+/// Converts a C++ string_view to a Rust string, failing if the string_view is
+/// not UTF8.
+impl<'a> TryFrom<StringView<'a>> for &'a str {
+    type Error = Utf8Error;
+    fn try_from(sv: StringView<'a>) -> Result<Self, Self::Error> {
+        sv.to_str()
+    }
+}
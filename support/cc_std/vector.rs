@@ -0,0 +1,73 @@
+// Part of the Crubit project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+use core::mem::size_of;
+use core::slice;
+
+/// The elements of a C++ `std::vector<T>` with the default allocator.
+///
+/// This is the Rust type of `std::vector<T>` behind C++ pointers and
+/// references in the bindings, when `T` is trivially copyable. It mirrors the
+/// layout of the libc++ vector, which stores pointers to the first element,
+/// past the last element, and past the end of its allocation, so that the
+/// elements can be accessed as a slice without calling into C++. The bindings
+/// only use it when the members of the C++ type are in this order, and
+/// statically assert that its size and alignment match.
+///
+/// Vectors can't be created, resized or destroyed in Rust.
+#[repr(C)]
+pub struct Vector<T> {
+    begin: *mut T,
+    end: *mut T,
+    end_cap: *mut T,
+}
+
+const _: () = assert!(size_of::<Vector<u8>>() == 3 * size_of::<usize>());
+
+impl<T> Vector<T> {
+    /// Returns the number of elements.
+    pub fn len(&self) -> usize {
+        if self.begin.is_null() {
+            return 0;
+        }
+        // SAFETY: `begin` and `end` point into (or past) the same allocation.
+        unsafe { self.end.offset_from(self.begin) as usize }
+    }
+
+    /// Returns whether the vector has no elements.
+    pub fn is_empty(&self) -> bool {
+        self.begin == self.end
+    }
+
+    /// Returns the number of elements the vector can hold without
+    /// reallocating.
+    pub fn capacity(&self) -> usize {
+        if self.begin.is_null() {
+            return 0;
+        }
+        // SAFETY: `begin` and `end_cap` point into (or past) the same
+        // allocation.
+        unsafe { self.end_cap.offset_from(self.begin) as usize }
+    }
+
+    /// Returns the elements as a slice, without copying them.
+    pub fn as_slice(&self) -> &[T] {
+        if self.begin.is_null() {
+            return &[];
+        }
+        // SAFETY: the vector owns `len()` initialized elements, which can't be
+        // modified while `self` is borrowed.
+        unsafe { slice::from_raw_parts(self.begin, self.len()) }
+    }
+
+    /// Returns the elements as a mutable slice, without copying them.
+    pub fn as_mut_slice(&mut self) -> &mut [T] {
+        if self.begin.is_null() {
+            return &mut [];
+        }
+        // SAFETY: the vector owns `len()` initialized elements, which can only
+        // be accessed through `self` while it is mutably borrowed.
+        unsafe { slice::from_raw_parts_mut(self.begin, self.len()) }
+    }
+}
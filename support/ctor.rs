@@ -86,6 +86,11 @@
 //! type which will run drop. This isn't exposed to users directly if they are
 //! simply storing in a local variable.
 //!
+//! ## PinnedVec
+//!
+//! `PinnedVec` is a growable container of in-place constructed objects, for
+//! constructing many of them without allocating each one separately.
+//!
 //! ## Structs and the `ctor!` macro
 //!
 //! `ctor` adds a `ctor!` macro to make it easy to initialize a struct
@@ -105,6 +110,7 @@
 extern crate alloc;
 
 use alloc::boxed::Box;
+use alloc::vec::Vec;
 use core::marker::{PhantomData, Unpin};
 use core::mem::{ManuallyDrop, MaybeUninit};
 use core::ops::{Deref, DerefMut};
@@ -661,6 +667,155 @@ impl<T> Slot<T> {
     }
 }
 
+// =========
+// PinnedVec
+// =========
+
+/// The capacity of the first chunk of a `PinnedVec` without a reserved
+/// capacity.
+const PINNED_VEC_MIN_CHUNK_CAPACITY: usize = 8;
+
+/// A growable sequence of in-place constructed objects, which never moves them.
+///
+/// Emplacing many `!Unpin` objects with `Box::emplace` costs one allocation per
+/// object. A `PinnedVec` instead constructs them contiguously in chunks of
+/// storage, and destroys them all at once when it is dropped.
+///
+/// Unlike `Vec`, growing a `PinnedVec` doesn't move its elements to a larger
+/// allocation (which would violate the pin guarantee): when the last chunk is
+/// full, a new chunk is allocated, at least as large as all the elements so
+/// far. Reserving capacity up front with `with_capacity()` or `reserve()` puts
+/// the next elements in a single chunk.
+///
+/// Only pinned mutable references to the elements are exposed.
+///
+/// Examples:
+///
+/// ```
+/// let mut vec = PinnedVec::with_capacity(1000);
+/// for i in 0..1000 {
+///     vec.push(CxxClass::ctor_new(i));
+/// }
+/// vec.get_mut(0).unwrap().mutating_method();
+/// ```
+pub struct PinnedVec<T> {
+    /// The storage of the elements. Only the last chunk has spare capacity
+    /// which may be used by later elements, and no chunk is ever reallocated.
+    chunks: Vec<Vec<T>>,
+    len: usize,
+}
+
+impl<T> PinnedVec<T> {
+    /// Creates an empty `PinnedVec`, without allocating.
+    pub const fn new() -> Self {
+        PinnedVec { chunks: Vec::new(), len: 0 }
+    }
+
+    /// Creates an empty `PinnedVec` which can hold `capacity` elements without
+    /// allocating.
+    pub fn with_capacity(capacity: usize) -> Self {
+        let mut vec = Self::new();
+        vec.reserve(capacity);
+        vec
+    }
+
+    /// Returns the number of elements.
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Returns whether there are no elements.
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Returns the number of elements which can be pushed without allocating.
+    pub fn spare_capacity(&self) -> usize {
+        self.chunks.last().map_or(0, |chunk| chunk.capacity() - chunk.len())
+    }
+
+    /// Ensures that `additional` more elements can be pushed without
+    /// allocating.
+    pub fn reserve(&mut self, additional: usize) {
+        if self.spare_capacity() >= additional {
+            return;
+        }
+        // The spare capacity of the current last chunk is abandoned, because
+        // its elements can't be moved to a larger chunk. Growing geometrically
+        // bounds the number of chunks, and the abandoned capacity.
+        let capacity = additional.max(self.len).max(PINNED_VEC_MIN_CHUNK_CAPACITY);
+        self.chunks.push(Vec::with_capacity(capacity));
+    }
+
+    /// Constructs an element in place at the end, and returns it.
+    ///
+    /// If `ctor` panics, the element is not added.
+    pub fn push(&mut self, ctor: impl Ctor<Output = T>) -> Pin<&mut T> {
+        self.reserve(1);
+        let chunk = self.chunks.last_mut().unwrap();
+        let index = chunk.len();
+        unsafe {
+            // Safety: the chunk is never reallocated, and the element is only
+            // moved out of it by dropping the chunk.
+            ctor.ctor(Pin::new_unchecked(&mut chunk.spare_capacity_mut()[0]));
+            chunk.set_len(index + 1);
+            self.len += 1;
+            Pin::new_unchecked(&mut chunk[index])
+        }
+    }
+
+    /// Constructs an element in place at the end for each of `ctors`.
+    pub fn extend<C: Ctor<Output = T>>(&mut self, ctors: impl IntoIterator<Item = C>) {
+        let ctors = ctors.into_iter();
+        self.reserve(ctors.size_hint().0);
+        for ctor in ctors {
+            self.push(ctor);
+        }
+    }
+
+    /// Returns the chunk which holds the element at `index`, and the index of
+    /// the element in that chunk.
+    fn locate(&self, mut index: usize) -> Option<(usize, usize)> {
+        for (chunk_index, chunk) in self.chunks.iter().enumerate() {
+            if index < chunk.len() {
+                return Some((chunk_index, index));
+            }
+            index -= chunk.len();
+        }
+        None
+    }
+
+    /// Returns the element at `index`, if any.
+    pub fn get(&self, index: usize) -> Option<&T> {
+        let (chunk_index, index) = self.locate(index)?;
+        Some(&self.chunks[chunk_index][index])
+    }
+
+    /// Returns the element at `index`, if any.
+    pub fn get_mut(&mut self, index: usize) -> Option<Pin<&mut T>> {
+        let (chunk_index, index) = self.locate(index)?;
+        // Safety: the element is pinned (see `push`).
+        Some(unsafe { Pin::new_unchecked(&mut self.chunks[chunk_index][index]) })
+    }
+
+    /// Returns an iterator over the elements, in the order they were pushed.
+    pub fn iter(&self) -> impl Iterator<Item = &T> {
+        self.chunks.iter().flatten()
+    }
+
+    /// Returns an iterator over the elements, in the order they were pushed.
+    pub fn iter_mut(&mut self) -> impl Iterator<Item = Pin<&mut T>> {
+        // Safety: the elements are pinned (see `push`).
+        self.chunks.iter_mut().flatten().map(|element| unsafe { Pin::new_unchecked(element) })
+    }
+}
+
+impl<T> Default for PinnedVec<T> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
 #[doc(hidden)]
 pub mod macro_internal {
     use super::*;
@@ -1669,6 +1824,65 @@ mod test {
         assert_eq!(*log.borrow(), vec!["move ctor", "drop"]);
     }
 
+    #[test]
+    fn test_pinned_vec_push() {
+        let mut vec = PinnedVec::new();
+        for i in 0..100 {
+            assert_eq!(*vec.push(i), i);
+        }
+        assert_eq!(vec.len(), 100);
+        assert_eq!(vec.get(42), Some(&42));
+        assert_eq!(vec.get(100), None);
+        *vec.get_mut(42).unwrap() += 1;
+        assert_eq!(vec.iter().copied().collect::<Vec<_>>()[41..44], [41, 43, 43]);
+    }
+
+    /// Tests that growing a PinnedVec doesn't move its elements.
+    #[test]
+    fn test_pinned_vec_elements_dont_move() {
+        let mut vec = PinnedVec::new();
+        let first: *const u32 = &*vec.push(0);
+        for i in 1..1000 {
+            vec.push(i);
+        }
+        assert_eq!(first, vec.get(0).unwrap() as *const u32);
+    }
+
+    #[test]
+    fn test_pinned_vec_with_capacity() {
+        let mut vec = PinnedVec::with_capacity(1000);
+        assert!(vec.spare_capacity() >= 1000);
+        vec.extend(0..1000_u64);
+        assert_eq!(vec.len(), 1000);
+        assert_eq!(vec.chunks.len(), 1);
+    }
+
+    #[test]
+    fn test_pinned_vec_drop() {
+        let log = RefCell::new(vec![]);
+        let log = &log;
+        {
+            let mut vec = PinnedVec::new();
+            vec.extend((0..3).map(|_| LoggingCtor { log, ctor_message: "ctor" }));
+        }
+        assert_eq!(*log.borrow(), vec!["ctor", "ctor", "ctor", "drop", "drop", "drop"]);
+    }
+
+    /// Tests that when a panic occurs during `PinnedVec::push`, the
+    /// uninitialized element is not added (and so not dropped).
+    #[test]
+    fn test_pinned_vec_no_drop_on_panic() {
+        let is_dropped = Mutex::new(false);
+        let mut vec = PinnedVec::new();
+        let panic_result = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+            vec.push(PanicCtor(DropNotify(&is_dropped)));
+        }));
+        assert!(panic_result.is_err());
+        assert!(vec.is_empty());
+        drop(vec);
+        assert!(!*is_dropped.lock().unwrap());
+    }
+
     fn takes_rvalue_reference<T>(_: RvalueReference<T>) {}
     /// Non-obvious fact: you can mov() an owned reference type! Moving anything
     /// also performs a rust move, but the resulting rvalue reference is
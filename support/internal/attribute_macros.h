@@ -71,4 +71,47 @@
 #define CRUBIT_INTERNAL_SAME_ABI \
   CRUBIT_INTERNAL_ANNOTATE("crubit_internal_same_abi")
 
+// Imports the types of the private and protected member variables of a
+// struct or class.
+//
+// By default, non-public member variables are represented as opaque blobs of
+// bytes. With this attribute, they keep their type, and stay private in Rust.
+// For example:
+//
+// ```c++
+// class CRUBIT_INTERNAL_IMPORT_PRIVATE_FIELDS Point final {
+//  public:
+//   int x() const { return x_; }
+//  private:
+//   int x_;
+// };
+// ```
+//
+// This may require bindings for the types of the member variables.
+//
+// Inline getters and setters of these member variables still call a C++ thunk,
+// unlike those of public member variables: the generated C++ code can't assert
+// the offsets of non-public member variables, because `offsetof` requires
+// access to them.
+#define CRUBIT_INTERNAL_IMPORT_PRIVATE_FIELDS \
+  CRUBIT_INTERNAL_ANNOTATE("crubit_internal_import_private_fields")
+
+// Generates a batch variant of a function, which calls it once per element of
+// slices of arguments, and writes the results to a slice.
+//
+// The loop runs in C++, so that the cost of the FFI call is paid once per
+// batch instead of once per element. For example:
+//
+// ```c++
+// CRUBIT_INTERNAL_BATCH_THUNK int Scale(int x, int factor);
+// ```
+//
+// also generates `fn Scale_batch(x: &[i32], factor: &[i32], __return: &mut
+// [i32])`, which panics if the slices don't all have the same length.
+//
+// This is only supported on free functions whose parameter and return types
+// are `Copy` and passed by value; on other functions, it is an error.
+#define CRUBIT_INTERNAL_BATCH_THUNK \
+  CRUBIT_INTERNAL_ANNOTATE("crubit_internal_batch_thunk")
+
 #endif  // THIRD_PARTY_CRUBIT_SUPPORT_INTERNAL_ATTRIBUTES_H_
@@ -41,8 +41,9 @@ namespace crubit {
 //   case nothing should operate on the uninitialized `SomeStruct` value
 //   (this is accomplished by ReturnValueSlot having an empty/no-op destructor)
 // - `SomeStruct`'s move constructor will run on line 3 (moving the return value
-//   out of `ReturnValueSlot::value_`, and then destructing the moved-away
-//   `ReturnValueSlot::value_`).
+//   out of `ReturnValueSlot::value_` directly into the object returned by
+//   `foo`, and then destructing the moved-away `ReturnValueSlot::value_`).
+//   This is the only move: there are no intermediate temporaries.
 //
 // Behavior of `ReturnValueSlot<T>` in steps 1 and 2 is somewhat similar to
 // `MaybeUninit<T>` in Rust, but the behavior on line 3 is a bit different:
@@ -77,9 +78,15 @@ union ReturnValueSlot {
   // `AssumeInitAndTakeValue()`. (e.g. by ensuring that the value has been
   // earlier written to the location pointed to by `GetPtr()`).
   T AssumeInitAndTakeValue() && {
-    T return_value(std::move(value_));
-    std::destroy_at(&value_);
-    return return_value;
+    // `value_` is moved directly into the returned object (and, through
+    // guaranteed copy elision, into the caller's object), rather than into a
+    // local which would only avoid a second move if NRVO applies.  So the
+    // moved-away `value_` is destroyed after the `return` statement.
+    struct DestroyAtScopeExit {
+      ~DestroyAtScopeExit() { std::destroy_at(value); }
+      T* value;
+    } destroy_value{&value_};
+    return std::move(value_);
   }
 
   // SAFETY REQUIREMENTS: The return value in `other` must have been
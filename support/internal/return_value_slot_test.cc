@@ -102,5 +102,32 @@ TEST(ReturnValueSlot, Test) {
   EXPECT_EQ(kReturnedValue, return_value.state);
 }
 
+struct MoveCounter {
+  explicit MoveCounter(int* moves) : moves(moves) {}
+  MoveCounter(const MoveCounter&) = delete;
+  MoveCounter& operator=(const MoveCounter&) = delete;
+  MoveCounter(MoveCounter&& other) : moves(other.moves) { ++*moves; }
+  MoveCounter& operator=(MoveCounter&&) = delete;
+
+  int* moves;
+};
+
+MoveCounter ReturnFromSlot(int* moves) {
+  ReturnValueSlot<MoveCounter> slot;
+  // Simulates a Rust thunk that populates the slot.
+  new (slot.Get()) MoveCounter(moves);
+  return std::move(slot).AssumeInitAndTakeValue();
+}
+
+TEST(ReturnValueSlot, TakesValueWithSingleMove) {
+  int moves = 0;
+  MoveCounter value = ReturnFromSlot(&moves);
+  EXPECT_EQ(value.moves, &moves);
+  // The value is moved out of the slot directly into `value`, even though this
+  // test is built with `-fno-elide-constructors` (see `BUILD`): moving the
+  // value into a local first would take a second move without NRVO.
+  EXPECT_EQ(moves, 1);
+}
+
 }  // namespace
 }  // namespace crubit